@@ -27,33 +27,23 @@ int main() {
 		int64_t MaxSystemInv;
 		diagnostics.Get("MaxSystemInv", MaxSystemInv);
 
-		std::vector<DynaPlex::Policy> policies;
-		for (int64_t i = 0; i < MaxSystemInv+1; i++)
-		{
-			VarGroup policy_config{};
-			policy_config.Add("id", "base_stock");
-			policy_config.Add("base_stock_level", i);
-			policies.push_back(mdp->GetPolicy(policy_config));
-		}
 		//Optional, you can also rely on defaults:
 		auto dp_config = VarGroup{
 			{"warmup_periods",128},
-			{"number_of_trajectories",200},
+			{"number_of_trajectories",4096},
+			{"trajectories_per_round",128},
 			{"periods_per_trajectory",1000},
 			{"rng_seed",1122}
 		};
-
-		int64_t benchmark = -1;
-		//To compute all performances relative to the 34th policy. 
-		benchmark = 34;
-
-		auto comparer = dp.GetPolicyComparer(mdp,dp_config);
-		auto results = comparer.Compare(policies,benchmark);
-
-		for (auto res : results)
-		{
-			std::cout << res.Dump() << std::endl;
-		}
+		//Grid of base-stock levels to search. Candidates are evaluated concurrently with common random numbers, and 
+		//candidates that are significantly worse than the best are eliminated after each round. 
+		dp_config.Add("parameters", VarGroup::VarGroupVec{
+			VarGroup{ {"name", "base_stock_level"}, {"min", 0}, {"max", MaxSystemInv} }
+			});
+
+		auto optimizer = dp.GetPolicyOptimizer(mdp, dp_config);
+		auto result = optimizer.Optimize(mdp->GetPolicy("base_stock"));
+		std::cout << result.Dump() << std::endl;
 
 	}
 	catch (const DynaPlex::Error& e)
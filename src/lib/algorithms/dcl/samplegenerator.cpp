@@ -5,6 +5,7 @@
 #include "dynaplex/sample.h"
 #include <algorithm>
 #include <cmath>
+#include <optional>
 namespace DynaPlex::DCL {
 
 
@@ -37,7 +38,7 @@ namespace DynaPlex::DCL {
 
 		if (mdp->IsInfiniteHorizon())
 		{
-			config.GetOrDefault("L", L, 100);
+			config.GetOrDefault("L", L, config.HasKey("initial_state_pool") ? 0 : 100);
 			config.GetOrDefault("reinitiate_counter", reinitiate_counter, 1048576);
 		}
 		else
@@ -45,6 +46,12 @@ namespace DynaPlex::DCL {
 			L = 0;
 			reinitiate_counter = 0;
 		}
+		if (config.HasKey("initial_state_pool"))
+		{
+			std::string pool_path;
+			config.Get("initial_state_pool", pool_path);
+			initial_state_pool = std::make_shared<const DynaPlex::Utilities::StatePool>(mdp, pool_path);
+		}
 		seed_offset = 0;
 	}
 
@@ -57,11 +64,18 @@ namespace DynaPlex::DCL {
 		Trajectory trajectory{};
 		trajectory.RNGProvider.SeedEventStreams(false, rng_seed, offset);
 		DynaPlex::RNG rng(false, rng_seed, offset);
+		//draws from the pool are reproducible through the explicit pool seed:
+		std::optional<DynaPlex::RNG> pool_rng{};
+		if (initial_state_pool)
+			pool_rng.emplace(false, initial_state_pool->Seed(), offset);
 
 		bool final_reached_once = false;
 		while (num_samples_added < somesamples.size())
 		{
-			mdp->InitiateState({ &trajectory,1 });
+			if (initial_state_pool)
+				mdp->InitiateState({ &trajectory,1 }, initial_state_pool->Draw(*pool_rng));
+			else
+				mdp->InitiateState({ &trajectory,1 });
 
 			if (mdp->IsInfiniteHorizon())
 			{//do a warm-up of L steps. 
@@ -169,7 +183,7 @@ namespace DynaPlex::DCL {
 				{"samples", samples}
 			};
 			samples_with_feats.SaveToFile(path);
-			system.remove_file(temp_path);
+			DynaPlex::NN::SampleData::RemoveFiles(temp_path);
 		}
 	}
 
@@ -243,7 +257,7 @@ namespace DynaPlex::DCL {
 			}
 		}
 
-		DynaPlex::Parallel::parallel_compute<DynaPlex::NN::Sample>(sample_vec, work, system.HardwareThreads(), reporter);
+		DynaPlex::Parallel::parallel_compute<DynaPlex::NN::Sample>(sample_vec, work, system, reporter);
 		seed_offset += N;
 
 		//gather all the collected samples over the threads into sample_data.
@@ -275,7 +289,7 @@ namespace DynaPlex::DCL {
 			for (size_t rank = 1; rank < system.WorldSize(); rank++)
 			{
 				sample_data.AddFromFile(mdp, GetPathOfTempSampleFile(rank));
-				system.remove_file(GetPathOfTempSampleFile(rank));
+				DynaPlex::NN::SampleData::RemoveFiles(GetPathOfTempSampleFile(rank));
 			}
 			DynaPlex::RNG rng(false, rng_seed);
 			std::shuffle(sample_data.Samples.begin(), sample_data.Samples.end(), rng.gen());
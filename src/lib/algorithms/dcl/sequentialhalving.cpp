@@ -90,30 +90,37 @@ namespace DynaPlex::DCL {
 				std::span<DynaPlex::Trajectory> span(&trajectories[start], end - start);
 				mdp->InitiateState(span, root_state);
 				mdp->IncorporateAction(span);
-				int64_t count = 0;
-				while (true)
+				if (mdp->ProvidesBatchEvolution(policy->GetConfig()))
+				{//the mdp simulates the roll-out policy on lanes of trajectories in lock-step:
+					mdp->EvolveBatch(span, policy->GetConfig(), H, max_steps_until_completion_expected_sh);
+				}
+				else
 				{
-					if (!mdp->IncorporateUntilAction(span, H))
+					int64_t count = 0;
+					while (true)
 					{
-						//This "sorts" the trajectories, such that the trajectories that are IsAwaitAction are at the front.
-						// Note that mdp->IncorporateAction only accepts set of adjacent trajectories that are all AwaitAction. 
-						std::span<DynaPlex::Trajectory>::iterator new_partition_point = std::partition(span.begin(), span.end(),
-							[](const DynaPlex::Trajectory& traj) {return traj.Category.IsAwaitAction(); }
-						);
-						//new_partition_point is the first element which does not require an action. 
-						//Make the span refer to a set of trajectories each awaiting an action:
-						span = std::span<DynaPlex::Trajectory>(span.begin(), new_partition_point);
-						if (++count > max_steps_until_completion_expected_sh)
-							throw DynaPlex::Error("SequentialHalving::SetAction"
-								"- expected completion of simulation run after max_steps_until_completion_expected: "
-								+ std::to_string(max_steps_until_completion_expected_sh) +
-								" but completion was not reached.");
+						if (!mdp->IncorporateUntilAction(span, H))
+						{
+							//This "sorts" the trajectories, such that the trajectories that are IsAwaitAction are at the front.
+							// Note that mdp->IncorporateAction only accepts set of adjacent trajectories that are all AwaitAction. 
+							std::span<DynaPlex::Trajectory>::iterator new_partition_point = std::partition(span.begin(), span.end(),
+								[](const DynaPlex::Trajectory& traj) {return traj.Category.IsAwaitAction(); }
+							);
+							//new_partition_point is the first element which does not require an action. 
+							//Make the span refer to a set of trajectories each awaiting an action:
+							span = std::span<DynaPlex::Trajectory>(span.begin(), new_partition_point);
+							if (++count > max_steps_until_completion_expected_sh)
+								throw DynaPlex::Error("SequentialHalving::SetAction"
+									"- expected completion of simulation run after max_steps_until_completion_expected: "
+									+ std::to_string(max_steps_until_completion_expected_sh) +
+									" but completion was not reached.");
+						}
+						//This means all trajectories are at period warmup_periods or final. 
+						if (span.size() == 0)
+							break;
+						//other actions use roll-out policy.
+						mdp->IncorporateAction(span, policy);
 					}
-					//This means all trajectories are at period warmup_periods or final. 
-					if (span.size() == 0)
-						break;
-					//other actions use roll-out policy.
-					mdp->IncorporateAction(span, policy);
 				}
 				//reset span to original
 				span = { &trajectories[start], static_cast<size_t>(end - start) };
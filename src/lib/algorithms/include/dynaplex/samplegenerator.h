@@ -5,11 +5,14 @@
 #include "dynaplex/vargroup.h"
 #include "dynaplex/uniformactionselector.h"
 #include "dynaplex/sequentialhalving.h"
+#include "dynaplex/statepool.h"
 
 namespace DynaPlex::DCL {
 	class SampleGenerator
 	{
 	public:
+		/// Config may include initial_state_pool, the path of a file saved with Utilities::StatePool::SaveToFile; trajectories are then initiated 
+		/// from states drawn from the pool, and the warm-up L defaults to 0. 
 		SampleGenerator(const DynaPlex::System&, DynaPlex::MDP, const DynaPlex::VarGroup& config = VarGroup{});
 
 		/// This generates samples and stores the features alognside the collected information.  
@@ -37,6 +40,7 @@ namespace DynaPlex::DCL {
 
 		DynaPlex::MDP mdp;
 		DynaPlex::System system;
+		std::shared_ptr<const DynaPlex::Utilities::StatePool> initial_state_pool;
 		DynaPlex::DCL::UniformActionSelector uniform_action_selector;
 		DynaPlex::DCL::SequentialHalving sequentialhalving_action_selector;
 
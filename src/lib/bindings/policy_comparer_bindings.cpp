@@ -1,4 +1,5 @@
 #include "dynaplex/policycomparer.h"
+#include "dynaplex/policyoptimizer.h"
 #include <pybind11/stl.h>
 #include <pybind11/pybind11.h>
 #include "dynaplex/vargroup.h"
@@ -29,7 +30,23 @@ void define_comparer_bindings(pybind11::module_& m) {
                 return list;
             }
             , py::arg("policies"),py::arg("index")=-1
+            )
+        .def("compare_family",
+            [](DynaPlex::Utilities::PolicyComparer& comparer, DynaPlex::Policy policy, std::string parameter, std::vector<double> values, int64_t index) {
+                auto vector_of_vargroup = comparer.CompareFamily(policy, parameter, values, index);
+                py::list list;
+                for (auto& vargroup : vector_of_vargroup)
+                    list.append(*vargroup.ToPybind11Dict());
+                return list;
+            }
+            , py::arg("policy"), py::arg("parameter"), py::arg("values"), py::arg("index") = -1
             );
+    py::class_<DynaPlex::Utilities::PolicyOptimizer>(m, "PolicyOptimizer")
+        .def("optimize",
+            [](DynaPlex::Utilities::PolicyOptimizer& optimizer, DynaPlex::Policy policy) {
+                return *(optimizer.Optimize(policy).ToPybind11Dict());
+            }, py::arg("policy"), "Optimizes the parameters starting from the config of policy; returns the config of the best policy and statistics."
+        );
 }
 
 
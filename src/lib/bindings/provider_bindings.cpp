@@ -63,6 +63,11 @@ namespace DynaPlex {
 		return system.IOLocation();
 	}
 
+	void SetThreading(std::uint32_t worker_threads, std::uint32_t threads_per_worker, bool pin_workers)
+	{
+		DynaPlex::DynaPlexProvider::Get().SetThreading(worker_threads, threads_per_worker, pin_workers);
+	}
+
 	DynaPlex::Utilities::Demonstrator GetDemonstrator(py::kwargs& kwargs)
 	{
 		return DynaPlex::DynaPlexProvider::Get().GetDemonstrator(kwargs);
@@ -72,6 +77,11 @@ namespace DynaPlex {
 	{
 		return DynaPlex::DynaPlexProvider::Get().GetPolicyComparer(mdp, kwargs);
 	}
+
+	DynaPlex::Utilities::PolicyOptimizer GetPolicyOptimizer(DynaPlex::MDP mdp, py::kwargs& kwargs)
+	{
+		return DynaPlex::DynaPlexProvider::Get().GetPolicyOptimizer(mdp, kwargs);
+	}
 	//define bindings for this. 
 	DynaPlex::Algorithms::DCL GetDCL(DynaPlex::MDP mdp, DynaPlex::Policy policy, py::kwargs& kwargs) {
 		return DynaPlex::DynaPlexProvider::Get().GetDCL(mdp, policy, kwargs);
@@ -89,8 +99,11 @@ void define_provider_bindings(pybind11::module_& m) {
 	m.def("load_policy", &DynaPlex::LoadPolicy, py::arg("mdp"), py::arg("path"), "loads policy for mdp from path");
 	m.def("get_mdp", &DynaPlex::GetMDP, "Gets MDP based on keyword arguments.");
 	m.def("get_comparer", &DynaPlex::GetComparer, py::arg("mdp"), "Gets comparer based on MDP and keyword arguments.");
+	m.def("get_policy_optimizer", &DynaPlex::GetPolicyOptimizer, py::arg("mdp"), "Gets optimizer for numeric policy parameters based on MDP and keyword arguments; must include parameters.");
 	m.def("get_demonstrator", &DynaPlex::GetDemonstrator, "Gets demonstrator based on keyword arguments; may provide max_period_count and rng_seed. ");
 	m.def("io_path", &DynaPlex::IO_Path, "Gets the path of the dynaplex IO directory.");
+	m.def("set_threading", &DynaPlex::SetThreading, py::arg("worker_threads"), py::arg("threads_per_worker"), py::arg("pin_workers") = false,
+		"Sets number of worker threads for parallel rollouts, and number of (torch intra-op) threads per worker. Affects comparers, dcl, etc. obtained afterwards.");
 	m.def("get_gym_emulator", &DynaPlex::GetGymEmulator, py::arg("mdp"), "Gets gym emulator based on MDP; also accepts key word arguments.");
 	m.def("get_dcl", &DynaPlex::GetDCL,
 		py::arg("mdp"),
@@ -0,0 +1,196 @@
+#include "dynaplex/eventlog.h"
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DynaPlex {
+
+	namespace {
+		constexpr char magic[8] = { 'D','P','E','V','T','L','O','G' };
+		constexpr uint64_t version = 1;
+		//magic, version, record size, number of streams:
+		constexpr size_t header_size = 4 * sizeof(uint64_t);
+	}
+
+	class EventLog::Impl {
+	public:
+		explicit Impl(const std::string& file_path) {
+#ifdef _WIN32
+			file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				throw DynaPlex::Error("EventLog: cannot open " + file_path);
+			LARGE_INTEGER file_size;
+			GetFileSizeEx(file, &file_size);
+			size = static_cast<size_t>(file_size.QuadPart);
+			if (size > 0)
+			{
+				mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping)
+					data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				if (!data)
+				{
+					Unmap();
+					throw DynaPlex::Error("EventLog: cannot map " + file_path);
+				}
+			}
+#else
+			int fd = open(file_path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw DynaPlex::Error("EventLog: cannot open " + file_path);
+			struct stat file_stat;
+			if (fstat(fd, &file_stat) != 0)
+			{
+				close(fd);
+				throw DynaPlex::Error("EventLog: cannot determine size of " + file_path);
+			}
+			size = static_cast<size_t>(file_stat.st_size);
+			if (size > 0)
+			{
+				void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+				if (mapped == MAP_FAILED)
+				{
+					close(fd);
+					throw DynaPlex::Error("EventLog: cannot map " + file_path);
+				}
+				data = static_cast<const std::byte*>(mapped);
+				//records are typically replayed sequentially:
+				madvise(mapped, size, MADV_SEQUENTIAL);
+			}
+			close(fd);
+#endif
+			try {
+				Validate(file_path);
+			}
+			catch (...) {
+				Unmap();
+				throw;
+			}
+		}
+
+		~Impl() {
+			Unmap();
+		}
+
+		uint64_t ReadWord(size_t index) const {
+			uint64_t word;
+			std::memcpy(&word, data + index * sizeof(uint64_t), sizeof(uint64_t));
+			return word;
+		}
+
+		void Validate(const std::string& file_path) {
+			if (size < header_size || std::memcmp(data, magic, sizeof(magic)) != 0)
+				throw DynaPlex::Error("EventLog: " + file_path + " is not an event log.");
+			if (ReadWord(1) != version)
+				throw DynaPlex::Error("EventLog: " + file_path + " has unsupported version " + std::to_string(ReadWord(1)) + ".");
+			record_size = static_cast<size_t>(ReadWord(2));
+			num_streams = static_cast<int64_t>(ReadWord(3));
+			if (record_size == 0 || num_streams < 0)
+				throw DynaPlex::Error("EventLog: " + file_path + " has invalid header.");
+			size_t index_size = (static_cast<size_t>(num_streams) + 1) * sizeof(uint64_t);
+			if (size < header_size + index_size)
+				throw DynaPlex::Error("EventLog: " + file_path + " is truncated.");
+			stream_starts.resize(num_streams + 1);
+			for (int64_t stream = 0; stream <= num_streams; stream++)
+				stream_starts[stream] = ReadWord(4 + stream);
+			for (int64_t stream = 0; stream < num_streams; stream++)
+				if (stream_starts[stream + 1] < stream_starts[stream])
+					throw DynaPlex::Error("EventLog: " + file_path + " has invalid stream index.");
+			records = data + header_size + index_size;
+			if (stream_starts.front() != 0 || size != header_size + index_size + stream_starts.back() * record_size)
+				throw DynaPlex::Error("EventLog: " + file_path + " has size inconsistent with its stream index.");
+		}
+
+		void Unmap() {
+#ifdef _WIN32
+			if (data)
+				UnmapViewOfFile(data);
+			if (mapping)
+				CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE)
+				CloseHandle(file);
+			mapping = nullptr;
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (data)
+				munmap(const_cast<std::byte*>(data), size);
+#endif
+			data = nullptr;
+		}
+
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+		const std::byte* data = nullptr;
+		size_t size = 0;
+		size_t record_size = 0;
+		int64_t num_streams = 0;
+		std::vector<uint64_t> stream_starts;
+		const std::byte* records = nullptr;
+	};
+
+	EventLog::EventLog(const std::string& file_path)
+		: pimpl{ std::make_unique<Impl>(file_path) }
+	{
+	}
+	EventLog::~EventLog() = default;
+	EventLog::EventLog(EventLog&&) noexcept = default;
+	EventLog& EventLog::operator=(EventLog&&) noexcept = default;
+
+	size_t EventLog::RecordSize() const {
+		return pimpl->record_size;
+	}
+
+	int64_t EventLog::NumStreams() const {
+		return pimpl->num_streams;
+	}
+
+	int64_t EventLog::StreamLength(int64_t stream) const {
+		if (stream < 0 || stream >= pimpl->num_streams)
+			throw DynaPlex::Error("EventLog: stream " + std::to_string(stream) + " out of range; log has " + std::to_string(pimpl->num_streams) + " streams.");
+		return static_cast<int64_t>(pimpl->stream_starts[stream + 1] - pimpl->stream_starts[stream]);
+	}
+
+	std::span<const std::byte> EventLog::Stream(int64_t stream) const {
+		int64_t length = StreamLength(stream);
+		return { pimpl->records + pimpl->stream_starts[stream] * pimpl->record_size, static_cast<size_t>(length) * pimpl->record_size };
+	}
+
+	void EventLog::Write(const std::string& file_path, size_t record_size, const std::vector<std::span<const std::byte>>& streams) {
+		if (record_size == 0)
+			throw DynaPlex::Error("EventLog::Write - record_size should be positive.");
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			throw DynaPlex::Error("EventLog::Write - failed to open file for writing: " + file_path);
+		auto write_word = [&file](uint64_t word) {
+			file.write(reinterpret_cast<const char*>(&word), sizeof(word));
+		};
+		file.write(magic, sizeof(magic));
+		write_word(version);
+		write_word(record_size);
+		write_word(streams.size());
+		uint64_t start = 0;
+		write_word(start);
+		for (auto& stream : streams)
+		{
+			if (stream.size() % record_size != 0)
+				throw DynaPlex::Error("EventLog::Write - stream size should be a multiple of record_size.");
+			start += stream.size() / record_size;
+			write_word(start);
+		}
+		for (auto& stream : streams)
+			file.write(reinterpret_cast<const char*>(stream.data()), static_cast<std::streamsize>(stream.size()));
+		if (!file)
+			throw DynaPlex::Error("EventLog::Write - failed to write " + file_path);
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "vargroup.h"
+#include "error.h"
+
+namespace DynaPlex {
+
+	class ByteSink;
+	class ByteSource;
+
+	namespace Concepts {
+		/// T is ByteSerializable if it writes itself to a ByteSink and reads itself back from a ByteSource, e.g. Queue and StateCategory.
+		template<typename T>
+		concept ByteSerializable = requires(const T & t, T & u, ByteSink & sink, ByteSource & source) {
+			t.Serialize(sink);
+			u.Deserialize(source);
+		};
+	}
+
+	namespace Detail {
+		template<typename T>
+		struct IsStdVector : std::false_type {};
+		template<typename T, typename A>
+		struct IsStdVector<std::vector<T, A>> : std::true_type {};
+	}
+
+	/**
+	 * Appends values to a byte buffer in a compact binary format, e.g. to serialize states (see MDPInterface::SerializeStates).
+	 * Supported are arithmetic types, enums, std::string, std::vector and ByteSerializable types (written natively), and
+	 * VarGroup and VarGroupConvertible types (written as length-prefixed UBJSON). Numbers are stored in native byte order.
+	 */
+	class ByteSink {
+	public:
+		explicit ByteSink(std::vector<uint8_t>& bytes) : bytes{ bytes } {}
+
+		void WriteBytes(const void* data, size_t size) {
+			auto first = static_cast<const uint8_t*>(data);
+			bytes.insert(bytes.end(), first, first + size);
+		}
+
+		/// writes values in order; read them back with ByteSource::Read in the same order.
+		template<typename... Ts>
+		void Write(const Ts&... values) {
+			(WriteValue(values), ...);
+		}
+
+		/// number of bytes in the underlying buffer.
+		size_t Size() const {
+			return bytes.size();
+		}
+
+	private:
+		template<typename T>
+		void WriteValue(const T& value) {
+			if constexpr (Concepts::ByteSerializable<T>)
+				value.Serialize(*this);
+			else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+				WriteBytes(&value, sizeof(T));
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				WriteValue(static_cast<uint64_t>(value.size()));
+				WriteBytes(value.data(), value.size());
+			}
+			else if constexpr (Detail::IsStdVector<T>::value)
+			{
+				WriteValue(static_cast<uint64_t>(value.size()));
+				using Element = typename T::value_type;
+				if constexpr ((std::is_arithmetic_v<Element> || std::is_enum_v<Element>) && !std::is_same_v<Element, bool>)
+					WriteBytes(value.data(), value.size() * sizeof(Element));
+				else
+					for (const auto& element : value)
+						WriteValue(static_cast<const Element&>(element));
+			}
+			else if constexpr (std::is_same_v<T, VarGroup>)
+			{
+				auto encoded = value.ToBytes(VarGroup::Encoding::UBJSON);
+				WriteValue(static_cast<uint64_t>(encoded.size()));
+				WriteBytes(encoded.data(), encoded.size());
+			}
+			else if constexpr (Concepts::ConvertibleToVarGroup<T>)
+				WriteValue(value.ToVarGroup());
+			else
+				static_assert(!sizeof(T), "ByteSink::Write - unsupported type; define Serialize(ByteSink&) const and Deserialize(ByteSource&), or ToVarGroup.");
+		}
+
+		std::vector<uint8_t>& bytes;
+	};
+
+	/**
+	 * Reads values written by ByteSink, in the same order. Throws if the data ends prematurely.
+	 */
+	class ByteSource {
+	public:
+		explicit ByteSource(std::span<const uint8_t> bytes) : bytes{ bytes } {}
+
+		void ReadBytes(void* data, size_t size) {
+			if (size > bytes.size() - position)
+				throw DynaPlex::Error("ByteSource: unexpected end of data at byte " + std::to_string(position) + ".");
+			if (size > 0)
+				std::memcpy(data, bytes.data() + position, size);
+			position += size;
+		}
+
+		template<typename... Ts>
+		void Read(Ts&... values) {
+			(ReadValue(values), ...);
+		}
+
+		template<typename T>
+		T Read() {
+			T value{};
+			ReadValue(value);
+			return value;
+		}
+
+		size_t Position() const {
+			return position;
+		}
+
+		bool AtEnd() const {
+			return position == bytes.size();
+		}
+
+	private:
+		template<typename T>
+		void ReadValue(T& value) {
+			if constexpr (Concepts::ByteSerializable<T>)
+				value.Deserialize(*this);
+			else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+				ReadBytes(&value, sizeof(T));
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				size_t size = ReadSize(1);
+				value.resize(size);
+				ReadBytes(value.data(), size);
+			}
+			else if constexpr (Detail::IsStdVector<T>::value)
+			{
+				using Element = typename T::value_type;
+				if constexpr ((std::is_arithmetic_v<Element> || std::is_enum_v<Element>) && !std::is_same_v<Element, bool>)
+				{
+					value.resize(ReadSize(sizeof(Element)));
+					ReadBytes(value.data(), value.size() * sizeof(Element));
+				}
+				else
+				{
+					size_t size = ReadSize(1);
+					value.clear();
+					value.reserve(size);
+					for (size_t i = 0; i < size; i++)
+						value.push_back(Read<Element>());
+				}
+			}
+			else if constexpr (std::is_same_v<T, VarGroup>)
+			{
+				size_t size = ReadSize(1);
+				std::vector<uint8_t> encoded(size);
+				ReadBytes(encoded.data(), size);
+				value = VarGroup::FromBytes(encoded, VarGroup::Encoding::UBJSON);
+			}
+			else if constexpr (Concepts::VarGroupConvertible<T>)
+				value = T(Read<VarGroup>());
+			else
+				static_assert(!sizeof(T), "ByteSource::Read - unsupported type; define Serialize(ByteSink&) const and Deserialize(ByteSource&), or ToVarGroup and a constructor from VarGroup.");
+		}
+
+		/// reads a length, and checks that the remaining data can hold that many elements of at least element_size bytes.
+		size_t ReadSize(size_t element_size) {
+			auto size = Read<uint64_t>();
+			if (size > (bytes.size() - position) / element_size)
+				throw DynaPlex::Error("ByteSource: invalid length " + std::to_string(size) + " at byte " + std::to_string(position) + ".");
+			return static_cast<size_t>(size);
+		}
+
+		std::span<const uint8_t> bytes;
+		size_t position{ 0 };
+	};
+}
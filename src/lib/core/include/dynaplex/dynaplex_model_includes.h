@@ -1,5 +1,6 @@
 #pragma once
 #include "dynaplex/rng.h"
 #include "dynaplex/statecategory.h"
+#include "dynaplex/bytestream.h"
 #include "dynaplex/features.h"
 #include "dynaplex/erasure/policyregistry.h"
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "error.h"
+
+namespace DynaPlex {
+	/**
+	 * Read-only, memory-mapped log of recorded events, e.g. historical demands, for trace-driven evaluation. A log consists of one
+	 * or more streams of fixed-size records; each record holds the bytes of one MDP::Event (which must then be trivially copyable).
+	 * The file consists of a header (magic "DPEVTLOG", version, record size, number of streams), the cumulative record count at
+	 * the start of each stream (number of streams + 1 values), and the records. Integers are 64-bit, in native byte order.
+	 */
+	class EventLog {
+	public:
+		/// maps the log in file_path; throws if the file is not a valid event log.
+		explicit EventLog(const std::string& file_path);
+		~EventLog();
+		EventLog(EventLog&&) noexcept;
+		EventLog& operator=(EventLog&&) noexcept;
+		EventLog(const EventLog&) = delete;
+		EventLog& operator=(const EventLog&) = delete;
+
+		/// size in bytes of a single record, i.e. sizeof(MDP::Event).
+		size_t RecordSize() const;
+		int64_t NumStreams() const;
+		/// number of records in stream.
+		int64_t StreamLength(int64_t stream) const;
+		/// the records of stream, as raw bytes. Valid for the lifetime of the log.
+		std::span<const std::byte> Stream(int64_t stream) const;
+
+		/// writes streams of records of record_size bytes each (the size of each stream must be a multiple of record_size).
+		static void Write(const std::string& file_path, size_t record_size, const std::vector<std::span<const std::byte>>& streams);
+
+		/// writes streams of events, e.g. Write<int64_t>(path, demands) for MDPs with Event = int64_t.
+		template<typename t_Event>
+		static void Write(const std::string& file_path, const std::vector<std::vector<t_Event>>& streams) {
+			static_assert(std::is_trivially_copyable_v<t_Event>, "EventLog::Write - events must be trivially copyable.");
+			std::vector<std::span<const std::byte>> raw;
+			raw.reserve(streams.size());
+			for (auto& stream : streams)
+				raw.push_back(std::as_bytes(std::span<const t_Event>(stream)));
+			Write(file_path, sizeof(t_Event), raw);
+		}
+
+	private:
+		class Impl;
+		std::unique_ptr<Impl> pimpl;
+	};
+
+	/**
+	 * Cursor over a window of recorded events, see Trajectory::Replay. Inactive (default) if record_size is 0.
+	 */
+	struct EventReplay {
+		std::span<const std::byte> Events{};
+		size_t RecordSize{ 0 };
+		/// index of the next record to replay; rewound by Trajectory::Reset.
+		int64_t Position{ 0 };
+
+		bool IsActive() const {
+			return RecordSize != 0;
+		}
+		/// the next record; throws if the window is exhausted.
+		const std::byte* Next() {
+			if (static_cast<size_t>(Position + 1) * RecordSize > Events.size())
+				throw DynaPlex::Error("EventReplay: recorded events exhausted after " + std::to_string(Position) + " events.");
+			return Events.data() + static_cast<size_t>(Position++) * RecordSize;
+		}
+	};
+}
@@ -109,6 +109,19 @@ namespace DynaPlex
 		/// Returns bool indicating whether the underlying mdp supports converting a VarGroup to a state. 
 		virtual bool SupportsGetStateFromVarGroup() const = 0;
 
+		/**
+		 * Returns whether the underlying mdp defines a binary codec for states, i.e. Serialize(const MDP::State&, DynaPlex::ByteSink&) const
+		 * and Deserialize(DynaPlex::ByteSource&) const returning MDP::State. Otherwise, SerializeStates falls back on ToVarGroup (in 
+		 * binary encoding), and DeserializeStates requires SupportsGetStateFromVarGroup. 
+		 */
+		virtual bool ProvidesStateSerialization() const = 0;
+
+		/// Serializes states arising from this mdp into a single compact buffer, which can be read back using DeserializeStates.
+		virtual std::vector<uint8_t> SerializeStates(std::span<const DynaPlex::dp_State> states) const = 0;
+
+		/// Reads back states written by SerializeStates on an mdp of the same type. 
+		virtual std::vector<DynaPlex::dp_State> DeserializeStates(std::span<const uint8_t> bytes) const = 0;
+
 		/// Returns bool indicating whether the underlying mdp supports equality tests for states. 
 		virtual bool SupportsEqualityTest() const = 0;
 
@@ -228,6 +241,52 @@ namespace DynaPlex
 		 */
 		virtual bool ProvidesEventProbs() const = 0;
 
+		/**
+		 * Returns whether the underlying MDP provides a control variate for events, i.e. ControlVariate(const MDP::Event&) const
+		 * returning a quantity with known expectation zero (e.g. realized minus expected demand). If so, the discounted sum of
+		 * control variates is kept in Trajectory::CumulativeControlVariate.
+		 */
+		virtual bool ProvidesControlVariate() const = 0;
+
+		/**
+		 * Returns the size of MDP::Event if events can be replayed from an EventLog (see Trajectory::Replay), i.e. if MDP::Event
+		 * is trivially copyable and MDP defines ModifyStateWithEvent(MDP::State&, const MDP::Event&). Otherwise, returns 0. 
+		 */
+		virtual size_t EventRecordSize() const = 0;
+
+		/**
+		 * Returns whether the underlying MDP can simulate a family of policies that differ only in numeric parameter of the
+		 * policy with given config in lock-step, i.e. defines ProvidesPolicyFamily(const VarGroup&, const std::string&) const
+		 * and EvolvePolicyFamily, and returns true for this policy and parameter. 
+		 */
+		virtual bool ProvidesPolicyFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const = 0;
+
+		/**
+		 * For each trajectory (awaiting an action in period 0), simulates the policies obtained by setting parameter to each of 
+		 * the values for warmup_periods + periods periods, where all policies see the same events (drawn from event stream 0). 
+		 * returns should have size trajectories.size() * values.size(); returns[i * values.size() + k] is set to the (discounted) 
+		 * return of trajectory i under values[k], accumulated after the warmup_periods. Trajectories are not modified, except 
+		 * for the state of their event streams. Throws if !ProvidesPolicyFamily(policy_config, parameter). 
+		 */
+		virtual void EvolvePolicyFamily(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::VarGroup& policy_config, const std::string& parameter,
+			std::span<const double> values, int64_t warmup_periods, int64_t periods, std::span<double> returns) const = 0;
+
+		/**
+		 * Returns whether the underlying MDP can evolve trajectories under the policy with given config using structure-of-arrays
+		 * kernels, i.e. defines BatchState, BatchPolicy, ModifyStatesWithActions, ModifyStatesWithEvents and related functions,
+		 * and ProvidesBatchPolicy(policy_config) returns true.
+		 */
+		virtual bool ProvidesBatchEvolution(const DynaPlex::VarGroup& policy_config) const = 0;
+
+		/**
+		 * Evolves the trajectories under the policy with given config until they are final, or await an event with PeriodCount
+		 * equal to MaxPeriodCount. Results are identical to alternating IncorporateUntilNonTrivialAction and IncorporateAction with
+		 * that policy. Lanes of trajectories that are in the same period and category are simulated in lock-step using the
+		 * kernels of the MDP; other trajectories are evolved one by one. May reorder trajectories. Throws if !ProvidesBatchEvolution(policy_config).
+		 * As guard against simulations that do not complete, also throws if more than MaxSteps rounds of actions are needed.
+		 */
+		virtual void EvolveBatch(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::VarGroup& policy_config, int64_t MaxPeriodCount, int64_t MaxSteps) const = 0;
+
 		/**
 		 * Returns the state category for this is state.
 		 */
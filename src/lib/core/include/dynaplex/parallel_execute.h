@@ -4,10 +4,30 @@
 #include <thread>
 #include <vector>
 #include "dynaplex/error.h"
+#include "dynaplex/system.h"
 namespace DynaPlex {
     namespace Parallel {
 
         using ProgressReporter = std::function<void(const std::atomic<bool>&)>;
+        /// called on each worker thread with its thread id, before the work is started. 
+        using WorkerSetup = std::function<void(int64_t)>;
+
+        /// number of threads that compute kernels (e.g. torch intra-op threads) may use on the calling thread. 
+        /// 0 if not set, i.e. if the calling thread is not a worker started by parallel_compute with a System. 
+        int64_t worker_threads_per_worker();
+        void set_worker_threads_per_worker(int64_t threads);
+
+        /// cpus on which the calling thread is allowed to run, e.g. as restricted by taskset or a container; in increasing order. 
+        /// On platforms without affinity support, all cpus 0, ..., hardware_concurrency-1. 
+        std::vector<int64_t> allowed_cpus();
+
+        /// pins the calling thread to the mentioned cpus. Returns false if not supported on this platform or if pinning failed. 
+        bool pin_current_thread(std::span<const int64_t> cpus);
+        /// pins the calling thread to the mentioned cpu, see above. 
+        bool pin_current_thread(int64_t cpu);
+
+        /// worker setup according to the threading policy of the system, see System::SetThreading. 
+        WorkerSetup worker_setup(const DynaPlex::System& system);
 
         std::vector<std::tuple<int64_t, int64_t>> get_splits(size_t total, size_t num_splits);
 
@@ -18,7 +38,8 @@ namespace DynaPlex {
         void parallel_compute(std::vector<T>& output_data,
             const std::function<void(std::span<T>, int64_t)>& work, 
             int64_t num_threads_to_use,
-            const ProgressReporter& reporter = nullptr) {
+            const ProgressReporter& reporter = nullptr,
+            const WorkerSetup& setup = nullptr) {
 
             if (num_threads_to_use > output_data.size())
                 num_threads_to_use = output_data.size();
@@ -36,8 +57,10 @@ namespace DynaPlex {
                 futures.push_back(promises[ThreadId].get_future());
 
                 threads.emplace_back(
-                    [&output_data, &promises, &work, &error_occurred, ThreadId, start, end]() {
+                    [&output_data, &promises, &work, &setup, &error_occurred, ThreadId, start, end]() {
                         try {
+                            if (setup)
+                                setup(ThreadId);
                             auto span = std::span<T>( &output_data[start], end - start );
                             work(span, start);
                             promises[ThreadId].set_value();
@@ -61,6 +84,15 @@ namespace DynaPlex {
             threads.clear();
         }
 
+        /// as above, but uses the number of workers and the worker setup from the threading policy of the system.
+        template <typename T>
+        void parallel_compute(std::vector<T>& output_data,
+            const std::function<void(std::span<T>, int64_t)>& work,
+            const DynaPlex::System& system,
+            const ProgressReporter& reporter = nullptr) {
+            parallel_compute<T>(output_data, work, system.WorkerThreads(), reporter, worker_setup(system));
+        }
+
 
     } // namespace Parallel
 } // namespace DynaPlex
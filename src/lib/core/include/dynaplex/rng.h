@@ -44,11 +44,38 @@ namespace DynaPlex {
 		}
 
 		double genUniform() {
-			return XoshiroCpp::DoubleFromBits(generator_());
+			//antithetic: complementing the bits mirrors the uniform, i.e. u' = (1 - 2^-53) - u, which remains in [0,1).
+			return XoshiroCpp::DoubleFromBits(antithetic_ ? ~generator_() : generator_());
+		}
+
+		/**
+		 * If set, genUniform returns mirrored values, such that runs with and without the flag are negatively correlated.
+		 * Only affects genUniform; draws that use gen() or genInt() directly are not mirrored. 
+		 */
+		void SetAntithetic(bool antithetic) {
+			antithetic_ = antithetic;
+		}
+
+		bool IsAntithetic() const {
+			return antithetic_;
+		}
+
+		/**
+		 * If set, samplers map each genUniform draw monotonically to a sample (e.g. DiscreteDist samples by inverse cdf instead
+		 * of by its alias table), such that mirrored draws give negatively correlated samples. Set on both streams of an antithetic pair. 
+		 */
+		void SetMonotone(bool monotone) {
+			monotone_ = monotone;
+		}
+
+		bool IsMonotone() const {
+			return monotone_;
 		}
 
 	private:
 		type generator_;
+		bool antithetic_{ false };
+		bool monotone_{ false };
 		RNG(uint64_t seed);
 	};
 
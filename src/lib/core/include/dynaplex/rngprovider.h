@@ -43,6 +43,17 @@
 			
 			void SeedEventStreams(bool evaluation, int64_t rng_seed=13021985, int64_t sample = (1ll << 30)-1, int64_t trajectory = (1ll << 22 ) -1 );
 			
+			/**
+			 * Makes the event streams (not the policy and initiation streams) antithetic, see RNG::SetAntithetic. 
+			 * Reset to false by SeedEventStreams. 
+			 */
+			void SetAntitheticEventStreams(bool antithetic);
+
+			/**
+			 * Makes the event streams request monotone sampling, see RNG::SetMonotone. Reset to false by SeedEventStreams. 
+			 */
+			void SetMonotoneEventStreams(bool monotone);
+			
 
 		private:
 			inline void Expand(int64_t size)
@@ -51,11 +62,19 @@
 				{
 					rng_vec.reserve(size);
 					rng_vec.push_back(DynaPlex::RNG(eval, global_seed, sample, trajectory, rng_vec.size()));
+					//streams 0 and 1 are for policy and initiation:
+					if (rng_vec.size() > 2)
+					{
+						rng_vec.back().SetAntithetic(antithetic);
+						rng_vec.back().SetMonotone(monotone);
+					}
 				}
 			}
 			std::vector<DynaPlex::RNG> rng_vec;
 
 			bool eval;
+			bool antithetic{ false };
+			bool monotone{ false };
 			int64_t global_seed, sample, trajectory;
 
 		};
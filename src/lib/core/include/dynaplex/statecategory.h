@@ -3,6 +3,7 @@
 #include <cstddef>
 #include "vargroup.h"
 #include "error.h"
+#include "bytestream.h"
 
 
 namespace DynaPlex {
@@ -106,6 +107,17 @@ namespace DynaPlex {
 			}
 		}
 
+		/// compact binary form, see ByteSink. 
+		void Serialize(ByteSink& sink) const {
+			sink.Write(state);
+		}
+		void Deserialize(ByteSource& source) {
+			uint64_t value = source.Read<uint64_t>();
+			uint64_t type = value & (0xFULL << 60);
+			if (type != AWAIT_ACTION && type != AWAIT_EVENT && type != FINAL)
+				throw DynaPlex::Error("StateCategory: Invalid category in binary data");
+			state = value;
+		}
 		bool IsAwaitAction() const {
 			return (state & (0xFULL << 60)) == AWAIT_ACTION;
 		}
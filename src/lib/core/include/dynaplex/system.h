@@ -4,6 +4,7 @@
 #include <iostream>  // For std::cout
 #include <string>
 #include <functional>
+#include <vector>
 
 
 namespace DynaPlex {
@@ -13,7 +14,10 @@ namespace DynaPlex {
 
     public: 
         System();
-        System(bool TorchAvailable, std::uint32_t worldRank, std::uint32_t worldSize, std::function<void()> barrier_cb);
+        /// gathers the values of all ranks, concatenated in order of rank. 
+        using AllGatherCallback = std::function<std::vector<double>(const std::vector<double>&)>;
+
+        System(bool TorchAvailable, std::uint32_t worldRank, std::uint32_t worldSize, std::function<void()> barrier_cb, AllGatherCallback allgather_cb = nullptr);
         ~System();
 
         System(const System&);  // Copy constructor
@@ -23,6 +27,17 @@ namespace DynaPlex {
         bool HasIODirectory() const;
         /// hardwarethreads available for the process or algorithm that receives this system.
         std::uint32_t HardwareThreads() const;
+        /// number of worker threads used for parallel rollouts (default: HardwareThreads()). 
+        std::uint32_t WorkerThreads() const;
+        /// number of threads each worker may use for compute kernels, e.g. torch intra-op threads (default: 1). 
+        std::uint32_t ThreadsPerWorker() const;
+        /// whether worker threads are pinned to cores (default: false; only supported on linux). 
+        bool PinWorkers() const;
+        /**
+         * Sets the threading policy for parallel rollouts, e.g. 4 workers with 8 threads each for large neural networks. 
+         * Affects only algorithms created after the call, as those store a copy of the system. 
+         */
+        void SetThreading(std::uint32_t worker_threads, std::uint32_t threads_per_worker, bool pin_workers = false);
         std::uint32_t WorldRank() const;
         std::uint32_t WorldSize() const;
 
@@ -96,6 +111,12 @@ namespace DynaPlex {
         ///adds a MPI barrier, if applicable 
         void AddBarrier() const;
 
+        /**
+         * Returns the values of all ranks, concatenated in order of rank (MPI allgather, if applicable). Must be called by all ranks. 
+         * Without MPI (or with a single rank), returns values. 
+         */
+        std::vector<double> AllGather(const std::vector<double>& values) const;
+
         /// if this process has world_rank 0, displays message on console. Otherwise, does nothing. 
         friend const System& operator<<(const System& sys, const std::string& msg);
 
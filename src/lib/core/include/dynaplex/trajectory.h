@@ -6,6 +6,7 @@
 #include "rngprovider.h"
 #include "state.h"
 #include "system.h"
+#include "eventlog.h"
 
 
 
@@ -38,6 +39,13 @@ namespace DynaPlex {
 	      * Do not manually change this.
 	      */
 		double CumulativeReturn;
+
+		/**
+		  * Cumulative (discounted) control variate since initiation/last reset, for MDPs that provide ControlVariate(const Event&).
+		  * Automatically kept up-to-date with calls to MDP->func(Trajectories, ...).
+		  * Do not manually change this.
+		  */
+		double CumulativeControlVariate;
 		
 		// Move constructor
 		Trajectory(Trajectory&& other) noexcept = default;
@@ -83,13 +91,18 @@ namespace DynaPlex {
 			state.reset(); 			
 		}
 
-		/// moves the state into the trajectory, and re-initiates CumulativeReturn, EffectiveDiscountFactor, and PeriodCount. 
+		/// moves the state into the trajectory, and re-initiates CumulativeReturn, CumulativeControlVariate, EffectiveDiscountFactor, and PeriodCount, and rewinds Replay. 
 		void Reset(DynaPlex::dp_State&&);
 		
-		/// re-initiates PeriodCount, EffectiveDiscountFactor, CumulativeReturn.  
+		/// re-initiates PeriodCount, EffectiveDiscountFactor, CumulativeReturn, CumulativeControlVariate, and rewinds Replay.  
 		void Reset();
 		/// provider of random sequences for use in MDP. 
 		DynaPlex::RNGProvider RNGProvider;
+		/**
+		 * Recorded events to replay (default: inactive). If active, events for event stream 0 (i.e. period events) are taken from 
+		 * Replay instead of being drawn using RNGProvider; requires that MDP::Event is trivially copyable. Rewound by Reset. 
+		 */
+		DynaPlex::EventReplay Replay;
 		/**
 		 * Convenience member that may be used to store the (index of) an object in a container that contains more information
 		 * on this trajectory, like initial information or functions to call when the trajectory completes.
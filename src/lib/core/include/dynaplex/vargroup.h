@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <variant>
@@ -103,6 +104,9 @@ namespace DynaPlex {
 		using VarGroupVec = std::vector<VarGroup>;
 		using DataType = std::variant<bool, int64_t, double, std::string, DynaPlex::VarGroup, Int64Vec, DoubleVec, StringVec, VarGroupVec>;
 		using TupleList = std::initializer_list< std::tuple<std::string, DataType>>;
+		/// encodings for storing a VarGroup. The binary encodings are smaller and faster to read and write than JSON; UBJSON
+		/// and BJData moreover store numeric lists (Int64Vec, DoubleVec) as packed typed arrays. 
+		enum class Encoding { JSON, CBOR, MessagePack, UBJSON, BJData };
 
 		VarGroup(TupleList list);
 		VarGroup(const std::string& rawJson);
@@ -307,8 +311,20 @@ namespace DynaPlex {
 			}
 		}
 
+		/// saves in the encoding that corresponds to the extension of filePath (see EncodingFromPath); indent only applies to JSON.
 		void SaveToFile(const std::string& filePath, const int indent = -1) const;
+		void SaveToFile(const std::string& filePath, Encoding encoding, const int indent = -1) const;
+		/// loads in the encoding that corresponds to the extension of filePath (see EncodingFromPath).
 		static VarGroup LoadFromFile(const std::string& filePath);
+		static VarGroup LoadFromFile(const std::string& filePath, Encoding encoding);
+
+		/// .cbor: CBOR; .msgpack or .mpk: MessagePack; .ubj or .ubjson: UBJSON; .bjd or .bjdata: BJData; otherwise: JSON.
+		static Encoding EncodingFromPath(const std::string& filePath);
+
+		/// the VarGroup in a binary encoding (not JSON). For UBJSON and BJData, lists of integers and lists of floats are written
+		/// as packed typed arrays; integers with the smallest element type that fits all values of the list. 
+		std::vector<uint8_t> ToBytes(Encoding encoding) const;
+		static VarGroup FromBytes(const std::vector<uint8_t>& bytes, Encoding encoding);
 
 		std::string Hash() const;
 		int64_t Int64Hash() const;
@@ -1,4 +1,11 @@
 #include "dynaplex/parallel_execute.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace DynaPlex {
     namespace Parallel {
@@ -33,5 +40,79 @@ namespace DynaPlex {
             size_t base_num_chunks = (total + max_chunk_size - 1) / max_chunk_size;
             return get_splits(total, base_num_chunks);
         }
+    
+        namespace {
+            thread_local int64_t threads_per_worker = 0;
+        }
+
+        int64_t worker_threads_per_worker() {
+            return threads_per_worker;
+        }
+
+        void set_worker_threads_per_worker(int64_t threads) {
+            threads_per_worker = threads;
+        }
+
+        std::vector<int64_t> allowed_cpus() {
+            std::vector<int64_t> cpus;
+#if defined(__linux__)
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0)
+            {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                    if (CPU_ISSET(cpu, &cpuset))
+                        cpus.push_back(cpu);
+            }
+#endif
+            if (cpus.empty())
+            {
+                int64_t hardware_threads = std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+                for (int64_t cpu = 0; cpu < hardware_threads; cpu++)
+                    cpus.push_back(cpu);
+            }
+            return cpus;
+        }
+
+        bool pin_current_thread(std::span<const int64_t> cpus) {
+#if defined(__linux__)
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            for (int64_t cpu : cpus)
+            {
+                if (cpu < 0 || cpu >= CPU_SETSIZE)
+                    return false;
+                CPU_SET(static_cast<int>(cpu), &cpuset);
+            }
+            return CPU_COUNT(&cpuset) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+            return false;
+#endif
+        }
+
+        bool pin_current_thread(int64_t cpu) {
+            return pin_current_thread(std::span<const int64_t>(&cpu, 1));
+        }
+
+        WorkerSetup worker_setup(const DynaPlex::System& system) {
+            int64_t per_worker = system.ThreadsPerWorker();
+            bool pin = system.PinWorkers();
+            //workers are pinned within the cpus that the calling thread may use:
+            std::vector<int64_t> allowed = pin ? allowed_cpus() : std::vector<int64_t>{};
+            //pinning failures are reported once; the affected workers then run unpinned. 
+            auto reported = std::make_shared<std::atomic<bool>>(false);
+            return [system, per_worker, allowed, pin, reported](int64_t thread_id) {
+                set_worker_threads_per_worker(per_worker);
+                if (pin)
+                {
+                    //the threads of compute kernels inherit the mask, so each worker gets per_worker cpus:
+                    std::vector<int64_t> cpus;
+                    for (int64_t i = 0; i < per_worker; i++)
+                        cpus.push_back(allowed[(thread_id * per_worker + i) % allowed.size()]);
+                    if (!pin_current_thread(cpus) && !reported->exchange(true))
+                        system << "Parallel: pinning worker threads to cpus failed; workers run unpinned." << std::endl;
+                }
+            };
+        }
     }
 }
\ No newline at end of file
@@ -6,10 +6,26 @@ namespace DynaPlex {
 		this->sample = sample;
 		this->trajectory = trajectory;
 		this->eval = evaluation;
+		this->antithetic = false;
+		this->monotone = false;
 
 		rng_vec.clear();
 		//start with 3 event streams.
 		Expand(3);
 
 	}
+
+	void RNGProvider::SetAntitheticEventStreams(bool antithetic)
+	{
+		this->antithetic = antithetic;
+		for (size_t i = 2; i < rng_vec.size(); i++)
+			rng_vec[i].SetAntithetic(antithetic);
+	}
+
+	void RNGProvider::SetMonotoneEventStreams(bool monotone)
+	{
+		this->monotone = monotone;
+		for (size_t i = 2; i < rng_vec.size(); i++)
+			rng_vec[i].SetMonotone(monotone);
+	}
 }
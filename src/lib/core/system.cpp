@@ -11,11 +11,13 @@ namespace DynaPlex {
 
     class System::Impl {
     public:
-        Impl(bool torchavailable, int32_t world_rank, int32_t world_size, std::function<void()> barrier_cb) : start_time_(std::chrono::steady_clock::now()),
+        Impl(bool torchavailable, int32_t world_rank, int32_t world_size, std::function<void()> barrier_cb, AllGatherCallback allgather_cb) : start_time_(std::chrono::steady_clock::now()),
             hardware_threads_(std::thread::hardware_concurrency()),
+            worker_threads_(hardware_threads_),
             world_rank_(world_rank),
             world_size_(world_size),
-            barrier_callback_(barrier_cb) {
+            barrier_callback_(barrier_cb),
+            allgather_callback_(allgather_cb) {
 
         }
         // Default copy constructor
@@ -58,11 +60,15 @@ namespace DynaPlex {
         Impl& operator=(const Impl& other) = default;
         std::chrono::steady_clock::time_point start_time_;
         std::uint32_t hardware_threads_;
+        std::uint32_t worker_threads_;
+        std::uint32_t threads_per_worker_ = 1;
+        bool pin_workers_ = false;
         std::uint32_t world_rank_;
         std::uint32_t world_size_;
         bool torchavailable;
         fs::path io_location_;
         std::function<void()> barrier_callback_;
+        AllGatherCallback allgather_callback_;
     };
 
 
@@ -79,9 +85,18 @@ namespace DynaPlex {
             pimpl->barrier_callback_();
         }
     }
+    std::vector<double> System::AllGather(const std::vector<double>& values) const {
+        if (pimpl->world_size_ > 1)
+        {
+            if (!pimpl->allgather_callback_)
+                throw DynaPlex::Error("System::AllGather - no allgather defined for world size " + std::to_string(pimpl->world_size_));
+            return pimpl->allgather_callback_(values);
+        }
+        return values;
+    }
     System::System() = default;
-    System::System(bool torchavailable, std::uint32_t worldRank, std::uint32_t worldSize, std::function<void()> barrier_cb)
-        : pimpl(std::make_unique<Impl>(torchavailable, worldRank, worldSize,barrier_cb)) {
+    System::System(bool torchavailable, std::uint32_t worldRank, std::uint32_t worldSize, std::function<void()> barrier_cb, AllGatherCallback allgather_cb)
+        : pimpl(std::make_unique<Impl>(torchavailable, worldRank, worldSize,barrier_cb,allgather_cb)) {
     }
     System::~System() = default;
 
@@ -100,6 +115,26 @@ namespace DynaPlex {
         return pimpl->hardware_threads_;
     }
 
+    std::uint32_t System::WorkerThreads() const {
+        return pimpl->worker_threads_;
+    }
+
+    std::uint32_t System::ThreadsPerWorker() const {
+        return pimpl->threads_per_worker_;
+    }
+
+    bool System::PinWorkers() const {
+        return pimpl->pin_workers_;
+    }
+
+    void System::SetThreading(std::uint32_t worker_threads, std::uint32_t threads_per_worker, bool pin_workers) {
+        if (worker_threads == 0 || threads_per_worker == 0)
+            throw DynaPlex::Error("System::SetThreading - worker_threads and threads_per_worker must be positive.");
+        pimpl->worker_threads_ = worker_threads;
+        pimpl->threads_per_worker_ = threads_per_worker;
+        pimpl->pin_workers_ = pin_workers;
+    }
+
     std::uint32_t System::WorldRank() const {
         return pimpl->world_rank_;
     }
@@ -7,16 +7,20 @@ namespace DynaPlex {
 		PeriodCount{ 0 },
 		EffectiveDiscountFactor{ 1.0 },
 		CumulativeReturn{ 0.0 },
+		CumulativeControlVariate{ 0.0 },
 		state{},
 		RNGProvider(),
+		Replay{},
 		ExternalIndex{ externalIndex }
 	{}
 
 	void Trajectory::Reset()
 	{
 		CumulativeReturn = 0.0;
+		CumulativeControlVariate = 0.0;
 		EffectiveDiscountFactor = 1.0;
 		PeriodCount = 0;
+		Replay.Position = 0;
 	}
 
 	void Trajectory::Reset(DynaPlex::dp_State&& State)
@@ -5,6 +5,10 @@
 #include "vargroup/nlohmann/json.h"
 #include "vargroup/vargroup_private_support_funcs.h"//hash_json and check_validity and levenshteinDist
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <limits>
 #if DP_PYBIND_SUPPORT
 #include "pybind11/pybind11.h"
 #include "vargroup/pybind11_json.h"
@@ -474,16 +478,280 @@ namespace DynaPlex {
 	}
 
 
+	VarGroup::Encoding VarGroup::EncodingFromPath(const std::string& file_path) {
+		auto dot = file_path.find_last_of('.');
+		auto separator = file_path.find_last_of("/\\");
+		if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+			return Encoding::JSON;
+		std::string extension = file_path.substr(dot + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension == "cbor")
+			return Encoding::CBOR;
+		if (extension == "msgpack" || extension == "mpk")
+			return Encoding::MessagePack;
+		if (extension == "ubj" || extension == "ubjson")
+			return Encoding::UBJSON;
+		if (extension == "bjd" || extension == "bjdata")
+			return Encoding::BJData;
+		return Encoding::JSON;
+	}
+
+	namespace {
+		/// writes UBJSON, or BJData (which is little-endian), like nlohmann::json does with size and type markers, except that
+		/// arrays of integers are always packed typed arrays, with the smallest element type that fits all values. nlohmann only 
+		/// packs arrays whose elements all fit the same smallest type, so e.g. {5, 100000} would get a marker per element. 
+		class UBJSONWriter {
+		public:
+			UBJSONWriter(std::vector<uint8_t>& out, bool little_endian) : out(out), little_endian(little_endian) {}
+
+			void Write(const ordered_json& j) {
+				switch (j.type())
+				{
+				case ordered_json::value_t::null:
+					out.push_back('Z');
+					break;
+				case ordered_json::value_t::boolean:
+					out.push_back(j.get<bool>() ? 'T' : 'F');
+					break;
+				case ordered_json::value_t::number_integer:
+				case ordered_json::value_t::number_unsigned:
+					if (FitsInt64(j))
+						WriteInteger(j.get<int64_t>());
+					else if (little_endian)
+					{//BJData has an uint64 type:
+						out.push_back('M');
+						WriteValue(j.get<uint64_t>());
+					}
+					else
+					{//UBJSON stores larger numbers as high-precision decimal strings:
+						out.push_back('H');
+						WriteString(std::to_string(j.get<uint64_t>()));
+					}
+					break;
+				case ordered_json::value_t::number_float:
+					out.push_back('D');
+					WriteValue(j.get<double>());
+					break;
+				case ordered_json::value_t::string:
+					out.push_back('S');
+					WriteString(j.get_ref<const std::string&>());
+					break;
+				case ordered_json::value_t::array:
+					WriteArray(j);
+					break;
+				case ordered_json::value_t::object:
+					out.push_back('{');
+					out.push_back('#');
+					WriteInteger(static_cast<int64_t>(j.size()));
+					for (const auto& item : j.items())
+					{
+						WriteString(item.key());
+						Write(item.value());
+					}
+					break;
+				default:
+					throw DynaPlex::Error("VarGroup::ToBytes - cannot encode binary or discarded values.");
+				}
+			}
+
+		private:
+			std::vector<uint8_t>& out;
+			bool little_endian;
+
+			static bool FitsInt64(const ordered_json& j) {
+				return j.is_number_integer() && (!j.is_number_unsigned() || j.get<uint64_t>() <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+			}
+
+			/// smallest integer type that fits all values in [min, max].
+			static char IntegerMarker(int64_t min, int64_t max) {
+				if (min >= std::numeric_limits<int8_t>::min() && max <= std::numeric_limits<int8_t>::max())
+					return 'i';
+				if (min >= 0 && max <= std::numeric_limits<uint8_t>::max())
+					return 'U';
+				if (min >= std::numeric_limits<int16_t>::min() && max <= std::numeric_limits<int16_t>::max())
+					return 'I';
+				if (min >= std::numeric_limits<int32_t>::min() && max <= std::numeric_limits<int32_t>::max())
+					return 'l';
+				return 'L';
+			}
+
+			template<typename T>
+			void WriteValue(T value) {
+				uint8_t bytes[sizeof(T)];
+				std::memcpy(bytes, &value, sizeof(T));
+				if ((std::endian::native == std::endian::little) != little_endian)
+					std::reverse(std::begin(bytes), std::end(bytes));
+				out.insert(out.end(), std::begin(bytes), std::end(bytes));
+			}
+
+			void WriteAs(char marker, int64_t value) {
+				switch (marker)
+				{
+				case 'i':
+					WriteValue(static_cast<int8_t>(value));
+					break;
+				case 'U':
+					WriteValue(static_cast<uint8_t>(value));
+					break;
+				case 'I':
+					WriteValue(static_cast<int16_t>(value));
+					break;
+				case 'l':
+					WriteValue(static_cast<int32_t>(value));
+					break;
+				default:
+					WriteValue(value);
+				}
+			}
+
+			void WriteInteger(int64_t value) {
+				char marker = IntegerMarker(value, value);
+				out.push_back(static_cast<uint8_t>(marker));
+				WriteAs(marker, value);
+			}
+
+			/// length followed by the characters, as for strings and object keys.
+			void WriteString(const std::string& string) {
+				WriteInteger(static_cast<int64_t>(string.size()));
+				out.insert(out.end(), string.begin(), string.end());
+			}
+
+			void WriteArray(const ordered_json& j) {
+				out.push_back('[');
+				bool integers = !j.empty() && std::all_of(j.begin(), j.end(), FitsInt64);
+				bool floats = !j.empty() && std::all_of(j.begin(), j.end(), [](const ordered_json& element) { return element.is_number_float(); });
+				if (integers)
+				{
+					int64_t min = std::numeric_limits<int64_t>::max(), max = std::numeric_limits<int64_t>::min();
+					for (const auto& element : j)
+					{
+						min = std::min(min, element.get<int64_t>());
+						max = std::max(max, element.get<int64_t>());
+					}
+					char marker = IntegerMarker(min, max);
+					out.push_back('$');
+					out.push_back(static_cast<uint8_t>(marker));
+					out.push_back('#');
+					WriteInteger(static_cast<int64_t>(j.size()));
+					for (const auto& element : j)
+						WriteAs(marker, element.get<int64_t>());
+				}
+				else if (floats)
+				{
+					out.push_back('$');
+					out.push_back('D');
+					out.push_back('#');
+					WriteInteger(static_cast<int64_t>(j.size()));
+					for (const auto& element : j)
+						WriteValue(element.get<double>());
+				}
+				else
+				{
+					out.push_back('#');
+					WriteInteger(static_cast<int64_t>(j.size()));
+					for (const auto& element : j)
+						Write(element);
+				}
+			}
+		};
+	}
+
+	std::vector<uint8_t> VarGroup::ToBytes(Encoding encoding) const {
+		//for UBJSON and BJData, containers are written with size, and lists of integers or of floats become packed typed arrays:
+		std::vector<uint8_t> bytes;
+		switch (encoding)
+		{
+		case Encoding::CBOR:
+			return ordered_json::to_cbor(pImpl->data);
+		case Encoding::MessagePack:
+			return ordered_json::to_msgpack(pImpl->data);
+		case Encoding::UBJSON:
+			UBJSONWriter(bytes, false).Write(pImpl->data);
+			return bytes;
+		case Encoding::BJData:
+			UBJSONWriter(bytes, true).Write(pImpl->data);
+			return bytes;
+		default:
+			throw DynaPlex::Error("VarGroup::ToBytes - JSON is not a binary encoding; use Dump instead.");
+		}
+	}
+
+	VarGroup VarGroup::FromBytes(const std::vector<uint8_t>& bytes, Encoding encoding) {
+		ordered_json j;
+		try {
+			switch (encoding)
+			{
+			case Encoding::CBOR:
+				j = ordered_json::from_cbor(bytes);
+				break;
+			case Encoding::MessagePack:
+				j = ordered_json::from_msgpack(bytes);
+				break;
+			case Encoding::UBJSON:
+				j = ordered_json::from_ubjson(bytes);
+				break;
+			case Encoding::BJData:
+				j = ordered_json::from_bjdata(bytes);
+				break;
+			default:
+				throw DynaPlex::Error("VarGroup::FromBytes - JSON is not a binary encoding; use VarGroup(const std::string&) instead.");
+			}
+		}
+		catch (const nlohmann::json::exception& e) {
+			throw DynaPlex::Error(std::string("VarGroup::FromBytes - failed to decode binary data: ") + e.what());
+		}
+		DynaPlex::VarGroupHelpers::check_validity(j);
+		VarGroup vars;
+		vars.pImpl->data = std::move(j);
+		return vars;
+	}
+
 	void VarGroup::SaveToFile(const std::string& file_path,const int indent) const {
-		std::ofstream file(file_path);
+		SaveToFile(file_path, EncodingFromPath(file_path), indent);
+	}
+
+	void VarGroup::SaveToFile(const std::string& file_path, Encoding encoding, const int indent) const {
+		if (encoding == Encoding::JSON)
+		{
+			std::ofstream file(file_path);
+			if (!file.is_open()) {
+				throw DynaPlex::Error("Failed to open file for writing: " + file_path);
+			}
+			file << pImpl->data.dump(indent);
+			file.close();
+			return;
+		}
+		auto bytes = ToBytes(encoding);
+		std::ofstream file(file_path, std::ios::binary);
 		if (!file.is_open()) {
 			throw DynaPlex::Error("Failed to open file for writing: " + file_path);
 		}
-		file << pImpl->data.dump(indent);
-		file.close();
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		if (!file) {
+			throw DynaPlex::Error("Failed to write file: " + file_path);
+		}
 	}
 
 	VarGroup VarGroup::LoadFromFile(const std::string& file_path) {
+		return LoadFromFile(file_path, EncodingFromPath(file_path));
+	}
+
+	VarGroup VarGroup::LoadFromFile(const std::string& file_path, Encoding encoding) {
+		if (encoding != Encoding::JSON)
+		{
+			std::ifstream file(file_path, std::ios::binary);
+			if (!file.is_open()) {
+				throw DynaPlex::Error("Unable to open file for reading: " + file_path);
+			}
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			try {
+				return FromBytes(bytes, encoding);
+			}
+			catch (const DynaPlex::Error& e)
+			{
+				throw DynaPlex::Error(std::string("Error in loaded data from ") + file_path + ":\n  " + e.what());
+			}
+		}
 		std::ifstream file(file_path);
 		if (file.is_open()) {
 			ordered_json j;
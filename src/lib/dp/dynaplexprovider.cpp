@@ -1,4 +1,5 @@
 #include <iostream>
+#include <filesystem>
 #ifdef DP_MPI_AVAILABLE
 #include <mpi.h>
 #endif
@@ -37,6 +38,10 @@ namespace DynaPlex {
         m_systemInfo.SetIOLocation(path, "IO_DynaPlex");
     }
 
+    void DynaPlexProvider::SetThreading(std::uint32_t worker_threads, std::uint32_t threads_per_worker, bool pin_workers) {
+        m_systemInfo.SetThreading(worker_threads, threads_per_worker, pin_workers);
+    }
+
     void DynaPlexProvider::AddBarrier()
     {
 #ifdef DP_MPI_AVAILABLE
@@ -44,6 +49,24 @@ namespace DynaPlex {
 #endif
     }
 
+    std::vector<double> DynaPlexProvider::AllGather(const std::vector<double>& values)
+    {
+#ifdef DP_MPI_AVAILABLE
+        int world_size;
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        int count = static_cast<int>(values.size());
+        std::vector<int> counts(world_size), displacements(world_size, 0);
+        MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        for (int rank = 1; rank < world_size; rank++)
+            displacements[rank] = displacements[rank - 1] + counts[rank - 1];
+        std::vector<double> all(displacements.back() + counts.back());
+        MPI_Allgatherv(values.data(), count, MPI_DOUBLE, all.data(), counts.data(), displacements.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+        return all;
+#else
+        return values;
+#endif
+    }
+
     DynaPlexProvider::DynaPlexProvider() {
         // If MPI is available, initialize it and fetch world details
 #ifdef DP_MPI_AVAILABLE
@@ -64,7 +87,8 @@ namespace DynaPlex {
         bool torchavailable = DynaPlex::TorchAvailability::TorchAvailable();
       
         m_systemInfo = DynaPlex::System(torchavailable,world_rank, world_size,
-           /*callback function: */ []() {DynaPlexProvider::Get().AddBarrier(); }
+           /*callback function: */ []() {DynaPlexProvider::Get().AddBarrier(); },
+           /*callback function: */ [](const std::vector<double>& values) {return DynaPlexProvider::Get().AllGather(values); }
             );
         std::string defined_root_dir = "";
 #ifdef DYNAPLEX_IO_ROOT_DIR
@@ -150,4 +174,44 @@ namespace DynaPlex {
         return DynaPlex::Utilities::PolicyComparer(m_systemInfo,mdp, config);
     }
 
+    DynaPlex::Utilities::PolicyOptimizer DynaPlexProvider::GetPolicyOptimizer(DynaPlex::MDP mdp, const VarGroup& config)
+    {
+        return DynaPlex::Utilities::PolicyOptimizer(m_systemInfo, mdp, config);
+    }
+
+    std::string DynaPlexProvider::GetStatePoolPath(DynaPlex::MDP mdp, DynaPlex::Policy policy, const VarGroup& config)
+    {
+        if (!mdp || !policy)
+            throw DynaPlex::Error("DynaPlexProvider::GetStatePoolPath - mdp and policy should not be null");
+        return m_systemInfo.filepath(mdp->Identifier(), "state_pools", StatePoolFileName(policy, config));
+    }
+
+    std::string DynaPlexProvider::StatePoolFileName(DynaPlex::Policy policy, const VarGroup& config)
+    {
+        return "pool_" + policy->GetConfig().UniqueIdentifier() + "_" + config.Hash() + ".bin";
+    }
+
+    std::shared_ptr<const DynaPlex::Utilities::StatePool> DynaPlexProvider::GetStatePool(DynaPlex::MDP mdp, DynaPlex::Policy policy, const VarGroup& config)
+    {
+        auto path = GetStatePoolPath(mdp, policy, config);
+        //rank 0 decides whether the pool is loaded or generated, such that all ranks make the same collective calls:
+        bool exists = m_systemInfo.WorldRank() == 0 && m_systemInfo.file_exists(mdp->Identifier(), "state_pools", StatePoolFileName(policy, config));
+        exists = AllGather({ exists ? 1.0 : 0.0 }).front() != 0.0;
+        if (exists)
+            return std::make_shared<const DynaPlex::Utilities::StatePool>(mdp, path);
+        //generation is deterministic, so all ranks obtain the same pool:
+        auto pool = std::make_shared<const DynaPlex::Utilities::StatePool>(m_systemInfo, mdp, policy, config);
+        if (mdp->ProvidesStateSerialization() || mdp->SupportsGetStateFromVarGroup())
+        {
+            if (m_systemInfo.WorldRank() == 0)
+            {//written under a temporary name, such that the pool file is never seen half-written:
+                auto temp_path = path + ".tmp";
+                pool->SaveToFile(temp_path);
+                std::filesystem::rename(temp_path, path);
+            }
+            AddBarrier();
+        }
+        return pool;
+    }
+
 }  // namespace DynaPlex
@@ -5,6 +5,8 @@
 #include "dynaplex/system.h"
 #include "dynaplex/demonstrator.h"
 #include "dynaplex/policycomparer.h"
+#include "dynaplex/policyoptimizer.h"
+#include "dynaplex/statepool.h"
 #include "dynaplex/dcl.h"
 namespace DynaPlex {
     class DynaPlexProvider {
@@ -28,6 +30,13 @@ namespace DynaPlex {
 
         const DynaPlex::System& System();
 
+        /**
+         * Sets the threading policy for parallel rollouts, see System::SetThreading. E.g. for large neural networks,
+         * 4 worker_threads with 8 threads_per_worker may outperform one single-threaded worker per hardware thread. 
+         * Must be called before obtaining algorithms (PolicyComparer, DCL, etc.) for it to affect them. 
+         */
+        void SetThreading(std::uint32_t worker_threads, std::uint32_t threads_per_worker, bool pin_workers = false);
+
 
         std::string FilePath(const std::vector<std::string>& subdirs, const std::string& filename);
 
@@ -52,12 +61,34 @@ namespace DynaPlex {
          * If mdp is infinite horizon, discounted: config may include periods_per_trajectory (default: 1024).
          * If mdp is finite horizon: config may include max_periods_until_error (default: 16384), this is the maximum number of steps in a trajectory until mdp is expected to terminate by reaching final state.
          * Config may also include rng_seed (default 0).
+         * Config may include target_half_width or target_relative_error for sequential stopping, antithetic and control_variate for variance reduction, and quantiles, see PolicyComparer.
          */
         DynaPlex::Utilities::PolicyComparer GetPolicyComparer(DynaPlex::MDP mdp, const VarGroup& config = VarGroup{});
 
+        /**
+         * Gets an optimizer for numeric parameters of policies for a specific mdp. Config must include parameters, a list with for 
+         * each parameter its name, min, max, and optionally step (default: 1) and integer (default: true). 
+         * Config may include number_of_trajectories (default: 4096), trajectories_per_round (default: 256) and elimination_z (default: 2.0), 
+         * as well as settings for PolicyComparer. See PolicyOptimizer.
+         */
+        DynaPlex::Utilities::PolicyOptimizer GetPolicyOptimizer(DynaPlex::MDP mdp, const VarGroup& config);
+
+
+        /**
+         * Gets a pool of steady-state states for mdp under policy, see Utilities::StatePool for the config. Pools are cached on file in
+         * the state_pools subdirectory of the mdp, keyed on the mdp identifier, policy config and config (including pool_seed), such that 
+         * later calls, also in later runs, reuse the pool. The file may be passed as initial_state_pool to PolicyComparer or DCL.
+         */
+        std::shared_ptr<const DynaPlex::Utilities::StatePool> GetStatePool(DynaPlex::MDP mdp, DynaPlex::Policy policy, const VarGroup& config = VarGroup{});
+
+        /// path of the file in which GetStatePool caches the pool. 
+        std::string GetStatePoolPath(DynaPlex::MDP mdp, DynaPlex::Policy policy, const VarGroup& config = VarGroup{});
+
 
     private:
         void AddBarrier();
+        std::vector<double> AllGather(const std::vector<double>& values);
+        std::string StatePoolFileName(DynaPlex::Policy policy, const VarGroup& config);
         DynaPlexProvider(); 
         ~DynaPlexProvider();
         // Delete the copy and assignment constructors to ensure singleton behavior
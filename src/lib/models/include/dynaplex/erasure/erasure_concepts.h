@@ -3,8 +3,11 @@
 #include "dynaplex/vargroup.h"
 #include "dynaplex/features.h"
 #include "dynaplex/statecategory.h"
+#include "dynaplex/bytestream.h"
 #include <vector>
 #include <tuple>
+#include <span>
+#include <string>
 namespace DynaPlex::Erasure
 {
 	template <typename t_MDP,typename t_State>
@@ -42,6 +45,47 @@ namespace DynaPlex::Erasure
 		{ mdp.GetEvent(rng) } -> std::same_as<t_Event>;
 	};
 
+	/// optional batched version of GetEvent: fills events[i] with an event drawn using *rngs[i]. 
+	template <typename t_MDP, typename t_Event, typename t_RNG>
+	concept HasGetEvents = std::is_default_constructible_v<t_Event> && requires(const t_MDP & mdp, std::span<t_RNG*> rngs, std::span<t_Event> events) {
+		mdp.GetEvents(rngs, events);
+	};
+
+	template <typename t_MDP, typename t_Event>
+	concept HasControlVariate = requires(const t_MDP & mdp, const t_Event & event) {
+		{ mdp.ControlVariate(event) } -> std::same_as<double>;
+	};
+
+	template <typename t_MDP, typename t_State, typename t_RNG>
+	concept HasPolicyFamily = requires(const t_MDP & mdp, const t_State & state, t_RNG & rng, const VarGroup & policy_config, const std::string & parameter,
+		std::span<const double> values, int64_t periods, std::span<double> returns) {
+		{ mdp.ProvidesPolicyFamily(policy_config, parameter) } -> std::same_as<bool>;
+		mdp.EvolvePolicyFamily(state, rng, policy_config, parameter, values, periods, periods, returns);
+	};
+
+	/// optional structure-of-arrays kernels: a BatchState holds several states (lanes) in lock-step, see MDPInterface::EvolveBatch.
+	/// GetBatchState fills an existing BatchState, such that its storage can be reused.
+	template <typename t_MDP, typename t_State, typename t_Event>
+	concept HasBatchKernels = std::is_default_constructible_v<typename t_MDP::BatchState> && std::is_default_constructible_v<t_Event> && requires(const t_MDP & mdp, std::span<const t_State* const> states, std::span<t_State* const> targets,
+		typename t_MDP::BatchState & batch, const typename t_MDP::BatchState & const_batch, const VarGroup & policy_config,
+		const typename t_MDP::BatchPolicy & batch_policy, std::span<const int64_t> actions, std::span<const t_Event> events,
+		std::span<int64_t> actions_out, std::span<double> costs) {
+		mdp.GetBatchState(states, batch);
+		mdp.UpdateStates(const_batch, targets);
+		{ mdp.GetStateCategory(const_batch) } -> std::same_as<StateCategory>;
+		{ mdp.ProvidesBatchPolicy(policy_config) } -> std::same_as<bool>;
+		{ mdp.GetBatchPolicy(policy_config) } -> std::same_as<typename t_MDP::BatchPolicy>;
+		mdp.GetBatchActions(const_batch, batch_policy, actions_out);
+		mdp.ModifyStatesWithActions(batch, actions, costs);
+		mdp.ModifyStatesWithEvents(batch, events, costs);
+	};
+
+	template <typename t_MDP, typename t_State>
+	concept HasStateSerialization =requires(const t_MDP & mdp, const t_State & state, DynaPlex::ByteSink & sink, DynaPlex::ByteSource & source) {
+		mdp.Serialize(state, sink);
+		{ mdp.Deserialize(source) } -> std::same_as<t_State>;
+	};
+
 	template <typename t_MDP, typename t_State, typename t_RNG>
 	concept HasResetHiddenStateVariables = requires(const t_MDP & mdp, t_State & state, t_RNG & rng) {
 		mdp.ResetHiddenStateVariables(state, rng);
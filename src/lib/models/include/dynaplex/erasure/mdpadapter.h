@@ -12,6 +12,10 @@
 #include "policyregistry.h"
 #include "stateadapter.h"
 #include <cassert>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
 
 namespace DynaPlex::Erasure
 {
@@ -45,6 +49,306 @@ namespace DynaPlex::Erasure
 			return HasGetFlatFeatures<t_MDP, t_State>;
 		}
 
+		bool ProvidesControlVariate() const override {
+			return HasControlVariate<t_MDP, t_Event>;
+		}
+
+		bool ProvidesPolicyFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const override {
+			if constexpr (HasPolicyFamily<t_MDP, t_State, DynaPlex::RNG>)
+				return mdp->ProvidesPolicyFamily(policy_config, parameter);
+			else
+				return false;
+		}
+
+		void EvolvePolicyFamily(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::VarGroup& policy_config, const std::string& parameter,
+			std::span<const double> values, int64_t warmup_periods, int64_t periods, std::span<double> returns) const override {
+			if constexpr (HasPolicyFamily<t_MDP, t_State, DynaPlex::RNG>)
+			{
+				if (!mdp->ProvidesPolicyFamily(policy_config, parameter))
+					throw DynaPlex::Error("MDP->EvolvePolicyFamily: " + mdp_type_id + "\nMDP does not provide a policy family for parameter " + parameter + " of policy " + policy_config.Dump());
+				size_t num_values = values.size();
+				if (returns.size() != trajectories.size() * num_values)
+					throw DynaPlex::Error("MDP->EvolvePolicyFamily: returns should have size trajectories.size() * values.size().");
+				for (size_t i = 0; i < trajectories.size(); i++)
+				{
+					auto& traj = trajectories[i];
+					if (!traj.Category.IsAwaitAction() || traj.PeriodCount != 0)
+						throw DynaPlex::Error("MDP->EvolvePolicyFamily: " + mdp_type_id + "\nTrajectories should be in period 0 and await an action.");
+					if (traj.Replay.IsActive())
+						throw DynaPlex::Error("MDP->EvolvePolicyFamily: " + mdp_type_id + "\nCannot replay recorded events in lock-step simulation.");
+					mdp->EvolvePolicyFamily(ToState(traj.GetState()), traj.RNGProvider.GetEventRNG(0), policy_config, parameter, values,
+						warmup_periods, periods, returns.subspan(i * num_values, num_values));
+				}
+			}
+			else
+				throw DynaPlex::Error("MDP->EvolvePolicyFamily: " + mdp_type_id + "\nMDP does not publicly define ProvidesPolicyFamily and EvolvePolicyFamily.");
+		}
+
+		static constexpr bool batch_kernels = HasBatchKernels<t_MDP, t_State, t_Event> && HasGetEvent<t_MDP, t_Event, DynaPlex::RNG>;
+		//number of trajectories that is simulated in lock-step by the kernels of the mdp:
+		static constexpr size_t batch_lanes = 16;
+
+		bool ProvidesBatchEvolution(const DynaPlex::VarGroup& policy_config) const override {
+			if constexpr (batch_kernels)
+				return mdp->ProvidesBatchPolicy(policy_config);
+			else
+				return false;
+		}
+
+		void EvolveBatch(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::VarGroup& policy_config, int64_t MaxPeriodCount, int64_t MaxSteps) const override {
+			if constexpr (batch_kernels)
+			{
+				if (!mdp->ProvidesBatchPolicy(policy_config))
+					throw DynaPlex::Error("MDP->EvolveBatch: " + mdp_type_id + "\nMDP does not provide batch evolution for policy " + policy_config.Dump());
+				auto batch_policy = mdp->GetBatchPolicy(policy_config);
+				//only needed for trajectories that cannot be simulated in lock-step:
+				DynaPlex::Policy policy{};
+				for (size_t start = 0; start < trajectories.size(); start += batch_lanes)
+				{
+					auto lanes = trajectories.subspan(start, std::min(batch_lanes, trajectories.size() - start));
+					if (InLockStep(lanes))
+						EvolveLanes(lanes, batch_policy, MaxPeriodCount, MaxSteps);
+					else
+					{
+						if (!policy)
+							policy = GetPolicy(policy_config);
+						EvolveSeparately(lanes, policy, MaxPeriodCount, MaxSteps);
+					}
+				}
+			}
+			else
+				throw DynaPlex::Error("MDP->EvolveBatch: " + mdp_type_id + "\nMDP does not publicly define BatchState and the associated kernels.");
+		}
+
+		/// whether the trajectories can be evolved in lock-step: same period and category, and no replay of recorded events.
+		static bool InLockStep(std::span<const DynaPlex::Trajectory> lanes) {
+			auto& first = lanes.front();
+			return std::all_of(lanes.begin(), lanes.end(), [&first](const DynaPlex::Trajectory& traj) {
+				return traj.PeriodCount == first.PeriodCount && traj.Category == first.Category && !traj.Replay.IsActive();
+				});
+		}
+
+		void ThrowIfTooManySteps(int64_t& steps, int64_t MaxSteps) const {
+			if (++steps > MaxSteps)
+				throw DynaPlex::Error("MDP->EvolveBatch: " + mdp_type_id + "\nExpected completion of simulation run after MaxSteps: " + std::to_string(MaxSteps) + " rounds of actions, but completion was not reached.");
+		}
+
+		void EvolveSeparately(std::span<DynaPlex::Trajectory> span, const DynaPlex::Policy& policy, int64_t MaxPeriodCount, int64_t MaxSteps) const {
+			int64_t steps = 0;
+			while (true)
+			{
+				if (!IncorporateUntilNonTrivialAction(span, MaxPeriodCount))
+					span = std::span<DynaPlex::Trajectory>(span.begin(), std::partition(span.begin(), span.end(),
+						[](const DynaPlex::Trajectory& traj) {return traj.Category.IsAwaitAction(); }));
+				if (span.size() == 0)
+					break;
+				ThrowIfTooManySteps(steps, MaxSteps);
+				IncorporateAction(span, policy);
+			}
+		}
+
+		template <typename t_BatchPolicy>
+		void EvolveLanes(std::span<DynaPlex::Trajectory> lanes, const t_BatchPolicy& batch_policy, int64_t MaxPeriodCount, int64_t MaxSteps) const {
+			//at most batch_lanes lanes, so fixed-size storage suffices; the batch state is reused across calls:
+			size_t num_lanes = lanes.size();
+			std::array<t_State*, batch_lanes> state_store;
+			std::array<int64_t, batch_lanes> action_store;
+			std::array<double, batch_lanes> cost_store;
+			std::array<t_Event, batch_lanes> event_store{};
+			std::array<DynaPlex::RNG*, batch_lanes> rng_store;
+			std::span<t_State*> states(state_store.data(), num_lanes);
+			std::span<int64_t> actions(action_store.data(), num_lanes);
+			std::span<double> costs(cost_store.data(), num_lanes);
+			std::span<t_Event> events(event_store.data(), num_lanes);
+			std::span<DynaPlex::RNG*> rngs(rng_store.data(), num_lanes);
+			for (size_t k = 0; k < num_lanes; k++)
+				states[k] = &ToState(lanes[k].GetState());
+			thread_local typename t_MDP::BatchState batch{};
+			mdp->GetBatchState(std::span<const t_State* const>(states.data(), num_lanes), batch);
+			//all lanes share the period, so the first lane is representative:
+			auto& first = lanes.front();
+			int64_t steps = 0;
+			while (true)
+			{
+				auto category = mdp->GetStateCategory(batch);
+				if (category.IsAwaitAction())
+				{
+					ThrowIfTooManySteps(steps, MaxSteps);
+					mdp->GetBatchActions(batch, batch_policy, actions);
+					mdp->ModifyStatesWithActions(batch, std::span<const int64_t>(actions), costs);
+					for (size_t k = 0; k < num_lanes; k++)
+					{
+						lanes[k].NextAction = actions[k];
+						lanes[k].CumulativeReturn += costs[k] * lanes[k].EffectiveDiscountFactor;
+					}
+				}
+				else if (category.IsAwaitEvent() && first.PeriodCount < MaxPeriodCount)
+				{
+					auto event_stream = category.Index();
+					for (size_t k = 0; k < num_lanes; k++)
+					{
+						if (event_stream == 0)
+						{
+							lanes[k].PeriodCount++;
+							lanes[k].EffectiveDiscountFactor *= discount_factor;
+						}
+						rngs[k] = &lanes[k].RNGProvider.GetEventRNG(event_stream);
+					}
+					if constexpr (HasGetEvents<t_MDP, t_Event, DynaPlex::RNG>)
+						mdp->GetEvents(rngs, events);
+					else
+						for (size_t k = 0; k < num_lanes; k++)
+							events[k] = mdp->GetEvent(*rngs[k]);
+					if constexpr (HasControlVariate<t_MDP, t_Event>)
+						for (size_t k = 0; k < num_lanes; k++)
+							lanes[k].CumulativeControlVariate += mdp->ControlVariate(events[k]) * lanes[k].EffectiveDiscountFactor;
+					mdp->ModifyStatesWithEvents(batch, std::span<const t_Event>(events), costs);
+					for (size_t k = 0; k < num_lanes; k++)
+						lanes[k].CumulativeReturn += costs[k] * lanes[k].EffectiveDiscountFactor;
+				}
+				else
+					break;
+			}
+			mdp->UpdateStates(batch, std::span<t_State* const>(states.data(), num_lanes));
+			for (size_t k = 0; k < num_lanes; k++)
+				lanes[k].Category = mdp->GetStateCategory(*states[k]);
+		}
+
+		size_t EventRecordSize() const override {
+			if constexpr (std::is_trivially_copyable_v<t_Event> && HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
+				return sizeof(t_Event);
+			else
+				return 0;
+		}
+
+		static bool ReplaysEvent(const DynaPlex::Trajectory& traj, int64_t event_stream) {
+			return event_stream == 0 && traj.Replay.IsActive();
+		}
+
+		t_Event ReplayEvent(DynaPlex::Trajectory& traj) const {
+			if constexpr (std::is_trivially_copyable_v<t_Event>)
+			{
+				if (traj.Replay.RecordSize != sizeof(t_Event))
+					throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nRecord size of replayed events (" + std::to_string(traj.Replay.RecordSize) + ") differs from size of MDP::Event (" + std::to_string(sizeof(t_Event)) + ").");
+				t_Event event;
+				std::memcpy(&event, traj.Replay.Next(), sizeof(t_Event));
+				return event;
+			}
+			else
+				throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nCannot replay recorded events, since MDP::Event is not trivially copyable.");
+		}
+
+		/// incorporates the next event into a trajectory that awaits an event, and updates its category. 
+		void IncorporateNextEvent(DynaPlex::Trajectory& traj, t_State& t_state) const
+		{
+			auto event_stream = traj.Category.Index();
+			if (event_stream == 0)
+			{
+				traj.PeriodCount++;
+				traj.EffectiveDiscountFactor *= discount_factor;
+			}
+			if constexpr (HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
+			{
+				if constexpr (HasGetEvent<t_MDP, t_Event, DynaPlex::RNG>)
+				{
+					t_Event Event = ReplaysEvent(traj, event_stream) ? ReplayEvent(traj) : mdp->GetEvent(traj.RNGProvider.GetEventRNG(event_stream));
+					IncorporateGivenEvent(traj, t_state, Event);
+				}
+				else if constexpr (HasGetStateDependentEvent<t_MDP, t_State, t_Event, DynaPlex::RNG>)
+				{
+					t_Event Event = ReplaysEvent(traj, event_stream) ? ReplayEvent(traj) : mdp->GetEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream));
+					IncorporateGivenEvent(traj, t_state, Event);
+				}
+				else
+					throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define function GetEvent(DynaPlex::RNG&) returning MDP::Event. ");
+			}
+			else
+				if constexpr (HasModifyStateWithRNG<t_MDP, t_State, DynaPlex::RNG>)
+				{
+					if (ReplaysEvent(traj, event_stream))
+						throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nCannot replay recorded events, since MDP does not publicly define ModifyStateWithEvent(MDP::State&, const MDP::Event&).");
+					traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream)) * traj.EffectiveDiscountFactor;
+					traj.Category = mdp->GetStateCategory(t_state);
+				}
+				else
+					throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define ModifyStateWithEvent(MDP::State&, const MDP::Event&) returning double.");
+		}
+
+		void IncorporateGivenEvent(DynaPlex::Trajectory& traj, t_State& t_state, const t_Event& Event) const
+		{
+			if constexpr (HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
+			{
+				if constexpr (HasControlVariate<t_MDP, t_Event>)
+					traj.CumulativeControlVariate += mdp->ControlVariate(Event) * traj.EffectiveDiscountFactor;
+				traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, Event) * traj.EffectiveDiscountFactor;
+				traj.Category = mdp->GetStateCategory(t_state);
+			}
+		}
+
+		/**
+		 * Incorporates the next event into each of the trajectories, which all await an event. If the MDP provides GetEvents, all
+		 * trajectories await the same event stream, and none replays recorded events, the events are drawn in a single call to 
+		 * GetEvents; otherwise, they are drawn one by one. Each trajectory has its own rng, so results do not depend on batching 
+		 * if GetEvents draws from each rng like GetEvent does. 
+		 */
+		void IncorporateNextEvents(std::span<DynaPlex::Trajectory* const> trajectories) const
+		{
+			if constexpr (HasGetEvents<t_MDP, t_Event, DynaPlex::RNG> && HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
+			{
+				auto event_stream = trajectories.front()->Category.Index();
+				bool batch = std::all_of(trajectories.begin(), trajectories.end(), [event_stream](const DynaPlex::Trajectory* traj) {
+					return traj->Category.Index() == event_stream && !ReplaysEvent(*traj, event_stream);
+					});
+				if (batch)
+				{
+					//scratch buffers, reused across calls such that they allocate only when growing:
+					thread_local std::vector<DynaPlex::RNG*> rngs;
+					thread_local std::vector<t_Event> events;
+					rngs.clear();
+					for (DynaPlex::Trajectory* traj : trajectories)
+					{
+						if (event_stream == 0)
+						{
+							traj->PeriodCount++;
+							traj->EffectiveDiscountFactor *= discount_factor;
+						}
+						rngs.push_back(&traj->RNGProvider.GetEventRNG(event_stream));
+					}
+					events.resize(trajectories.size());
+					mdp->GetEvents(std::span<DynaPlex::RNG*>(rngs), std::span<t_Event>(events));
+					for (size_t i = 0; i < trajectories.size(); i++)
+						IncorporateGivenEvent(*trajectories[i], ToState(trajectories[i]->GetState()), events[i]);
+					return;
+				}
+			}
+			for (DynaPlex::Trajectory* traj : trajectories)
+				IncorporateNextEvent(*traj, ToState(traj->GetState()));
+		}
+
+		/// incorporates actions as long as the trajectory awaits an action, and only a single action is allowed.
+		void IncorporateTrivialActions(DynaPlex::Trajectory& traj, t_State& t_state) const
+		{
+			while (traj.Category.IsAwaitAction())
+			{
+				auto actions = provider(t_state);
+				if (actions.Count() == 1)
+				{//trivial action:	
+					traj.NextAction = *(actions.begin());
+					if constexpr (HasModifyStateWithAction<t_MDP>)
+					{
+						traj.CumulativeReturn += mdp->ModifyStateWithAction(t_state, traj.NextAction) * traj.EffectiveDiscountFactor;
+						traj.Category = mdp->GetStateCategory(t_state);
+					}
+					else
+						throw DynaPlex::Error("MDP->IncorporateUntilNonTrivialAction: " + mdp_type_id + "\nMDP does not publicly define ModifyStateWithAction(MDP::State,int64_t) const returning double");
+				}
+				else
+				{//nontrivial action:
+					break;
+				}
+			}
+		}
+
 		bool ProvidesEventProbs() const override {
 			return HasEventProbabilities<t_MDP, t_Event> || HasStateDependendentEventProbabilities<t_MDP, t_State, t_Event>;
 		}
@@ -368,6 +672,58 @@ namespace DynaPlex::Erasure
 
 		}
 
+		bool ProvidesStateSerialization() const override
+		{
+			return HasStateSerialization<t_MDP, t_State>;
+		}
+
+		std::vector<uint8_t> SerializeStates(std::span<const DynaPlex::dp_State> states) const override
+		{
+			std::vector<uint8_t> bytes;
+			DynaPlex::ByteSink sink{ bytes };
+			//the codec is recorded, such that data from a different codec is recognized on reading:
+			sink.Write(StateCodec(), static_cast<uint64_t>(states.size()));
+			for (auto& state : states)
+			{
+				if (!CheckConformant(state))
+					throw DynaPlex::Error("MDP->SerializeStates: " + mdp_type_id + "\nState does not arise from this MDP.");
+				if constexpr (HasStateSerialization<t_MDP, t_State>)
+					mdp->Serialize(ToState(state), sink);
+				else
+					sink.Write(state->ToVarGroup());
+			}
+			return bytes;
+		}
+
+		std::vector<DynaPlex::dp_State> DeserializeStates(std::span<const uint8_t> bytes) const override
+		{
+			DynaPlex::ByteSource source{ bytes };
+			auto codec = source.Read<uint8_t>();
+			if (codec != StateCodec())
+				throw DynaPlex::Error("MDP->DeserializeStates: " + mdp_type_id + "\nStates were serialized with a different codec.");
+			auto count = source.Read<uint64_t>();
+			std::vector<DynaPlex::dp_State> states;
+			states.reserve(static_cast<size_t>(std::min<uint64_t>(count, bytes.size())));
+			for (uint64_t i = 0; i < count; i++)
+			{
+				if constexpr (HasStateSerialization<t_MDP, t_State>)
+					states.push_back(std::make_unique<StateAdapter<t_State>>(mdp_int_hash, mdp->Deserialize(source)));
+				else if constexpr (HasGetStateFromVars<t_MDP, t_State>)
+					states.push_back(GetState(source.Read<DynaPlex::VarGroup>()));
+				else
+					throw DynaPlex::Error("MDP->DeserializeStates: " + mdp_type_id + "\nMDP must publicly define MDP::Deserialize(DynaPlex::ByteSource&) const or MDP::GetState(const VarGroup&) const returning MDP::State.");
+			}
+			if (!source.AtEnd())
+				throw DynaPlex::Error("MDP->DeserializeStates: " + mdp_type_id + "\nUnexpected data after last state.");
+			return states;
+		}
+
+		/// 1: binary codec of the MDP; 2: VarGroup. 
+		static constexpr uint8_t StateCodec()
+		{
+			return HasStateSerialization<t_MDP, t_State> ? 1 : 2;
+		}
+
 		bool CheckConformant(const DynaPlex::dp_State& state) const override
 		{
 			return state->mdp_int_hash == mdp_int_hash;
@@ -463,74 +819,45 @@ namespace DynaPlex::Erasure
 		template <bool SkipTrivial>
 		bool IncorporateUntilSomeAction(std::span<DynaPlex::Trajectory> trajectories, int64_t MaxPeriodCount) const
 		{
-			bool AllAwaitAction = true;
-
-			for (DynaPlex::Trajectory& traj : trajectories)
-			{
-				auto& t_state = ToState(traj.GetState());
-
-				while (traj.PeriodCount < MaxPeriodCount && traj.Category.IsAwaitEvent())
+			if constexpr (HasGetEvents<t_MDP, t_Event, DynaPlex::RNG>)
+			{//advance all trajectories in lockstep, such that events can be drawn in batches:
+				thread_local std::vector<DynaPlex::Trajectory*> awaiting_event;
+				while (true)
 				{
-					auto event_stream = traj.Category.Index();
-					if (event_stream == 0)
-					{
-						traj.PeriodCount++;
-						traj.EffectiveDiscountFactor *= discount_factor;
-					}
-					if constexpr (HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
-					{
-						if constexpr (HasGetEvent<t_MDP, t_Event, DynaPlex::RNG>)
-						{
-							t_Event Event = mdp->GetEvent(traj.RNGProvider.GetEventRNG(event_stream));
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, Event) * traj.EffectiveDiscountFactor;
-						}
-						else if constexpr (HasGetStateDependentEvent<t_MDP, t_State, t_Event, DynaPlex::RNG>)
-						{
-							t_Event Event = mdp->GetEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream));
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, Event) * traj.EffectiveDiscountFactor;
-						}
-						else
-							throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define function GetEvent(DynaPlex::RNG&) returning MDP::Event. ");
-					}
-					else
-						if constexpr (HasModifyStateWithRNG<t_MDP, t_State, DynaPlex::RNG>)
-						{
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream)) * traj.EffectiveDiscountFactor;
-						}
-						else							
-							throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define ModifyStateWithEvent(MDP::State&, const MDP::Event&) returning double.");
-					traj.Category = mdp->GetStateCategory(t_state);
-
-					int64_t action_count;
+					awaiting_event.clear();
+					for (DynaPlex::Trajectory& traj : trajectories)
+						if (traj.PeriodCount < MaxPeriodCount && traj.Category.IsAwaitEvent())
+							awaiting_event.push_back(&traj);
+					if (awaiting_event.empty())
+						break;
+					IncorporateNextEvents(awaiting_event);
 					if constexpr (SkipTrivial)
+						for (DynaPlex::Trajectory* traj : awaiting_event)
+							IncorporateTrivialActions(*traj, ToState(traj->GetState()));
+				}
+			}
+			else
+			{
+				for (DynaPlex::Trajectory& traj : trajectories)
+				{
+					auto& t_state = ToState(traj.GetState());
+					while (traj.PeriodCount < MaxPeriodCount && traj.Category.IsAwaitEvent())
 					{
-						while (traj.Category.IsAwaitAction())
-						{
-							auto actions = provider(t_state);
-							if (actions.Count() == 1)
-							{//trivial action:	
-								traj.NextAction = *(actions.begin());
-								if constexpr (HasModifyStateWithAction<t_MDP>)
-								{
-									traj.CumulativeReturn += mdp->ModifyStateWithAction(t_state, traj.NextAction) * traj.EffectiveDiscountFactor;
-									traj.Category = mdp->GetStateCategory(t_state);
-								}
-								else
-									throw DynaPlex::Error("MDP->IncorporateUntilNonTrivialAction: " + mdp_type_id + "\nMDP does not publicly define ModifyStateWithAction(MDP::State,int64_t) const returning double");
-							}
-							else
-							{//nontrivial action:
-								break;//the inner while loop. 
-							}
-						}
+						IncorporateNextEvent(traj, t_state);
+						if constexpr (SkipTrivial)
+							IncorporateTrivialActions(traj, t_state);
 					}
 				}
+			}
+
+			bool AllAwaitAction = true;
+			for (DynaPlex::Trajectory& traj : trajectories)
+			{
 				if (!traj.Category.IsAwaitAction())
 				{
 					AllAwaitAction = false;
 				}
 				assert(traj.Category.IsAwaitAction() || traj.Category.IsFinal() || traj.PeriodCount == MaxPeriodCount);
-
 			}
 			return AllAwaitAction;
 		}
@@ -549,48 +876,21 @@ namespace DynaPlex::Erasure
 
 		bool IncorporateEvent(std::span<DynaPlex::Trajectory> trajectories) const override
 		{
+			thread_local std::vector<DynaPlex::Trajectory*> awaiting_event;
+			awaiting_event.clear();
+			for (DynaPlex::Trajectory& traj : trajectories)
+				if (traj.Category.IsAwaitEvent())
+					awaiting_event.push_back(&traj);
+			if (awaiting_event.empty())
+				return false;
+			IncorporateNextEvents(awaiting_event);
 
 			bool EventsRemaining = false;
-			for (DynaPlex::Trajectory& traj : trajectories)
+			for (DynaPlex::Trajectory* traj : awaiting_event)
 			{
-				if (traj.Category.IsAwaitEvent())
+				if (traj->Category.IsAwaitEvent())
 				{
-					auto& t_state = ToState(traj.GetState());
-					auto event_stream = traj.Category.Index();
-					if (event_stream == 0)
-					{
-						traj.PeriodCount++;
-						traj.EffectiveDiscountFactor *= discount_factor;
-					}
-					if constexpr (HasModifyStateWithEvent<t_MDP, t_State, t_Event>)
-					{
-						if constexpr (HasGetEvent<t_MDP, t_Event, DynaPlex::RNG>)
-						{
-							t_Event Event = mdp->GetEvent(traj.RNGProvider.GetEventRNG(event_stream));
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, Event) * traj.EffectiveDiscountFactor;
-						}
-						else if constexpr (HasGetStateDependentEvent<t_MDP, t_State, t_Event, DynaPlex::RNG>)
-						{
-							t_Event Event = mdp->GetEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream));
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, Event) * traj.EffectiveDiscountFactor;
-						}
-						else
-							throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define function GetEvent(DynaPlex::RNG&) returning MDP::Event. ");
-
-					}
-					else //if constexpr 
-						if constexpr (HasModifyStateWithRNG<t_MDP, t_State, DynaPlex::RNG>)
-						{
-							traj.CumulativeReturn += mdp->ModifyStateWithEvent(t_state, traj.RNGProvider.GetEventRNG(event_stream)) * traj.EffectiveDiscountFactor;
-						}
-						else
-							throw DynaPlex::Error("MDP->IncorporateEvent: " + mdp_type_id + "\nMDP does not publicly define ModifyStateWithEvent(MDP::State&, const MDP::Event&) returning double.");
-
-					traj.Category = mdp->GetStateCategory(t_state);
-					if (traj.Category.IsAwaitEvent())
-					{
-						EventsRemaining = true;
-					}
+					EventsRemaining = true;
 				}
 			}
 			return EventsRemaining;
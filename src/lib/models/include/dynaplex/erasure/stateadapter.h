@@ -12,6 +12,11 @@ namespace DynaPlex::Erasure {
             state(s) 
         {
         }      
+        StateAdapter(int64_t hash_value, t_State&& s)
+            : StateBase(hash_value),
+            state(std::move(s))
+        {
+        }
         
         VarGroup ToVarGroup() const override
         {
@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "dynaplex/error.h"
+#include "dynaplex/modelling/eventheap.h"
+
+namespace DynaPlex {
+
+    namespace Concepts {
+
+        template <typename T>
+        concept HasIntegerTime = requires(const T & t) {
+            requires std::integral<std::remove_cvref_t<decltype(t.time)>>;
+        };
+    }
+
+    /**
+     * @brief Calendar queue: priority queue for events with integer timestamps (member time), alternative to EventHeap.
+     *
+     * Events are kept in a circular array of buckets, each covering a number of time units (modulo the number of buckets). The number
+     * of buckets grows with the number of pending events, and the bucket width is set to about three times the average spacing of the
+     * earliest events, such that push and pop take O(1) amortized expected time. first() is the event with
+     * the smallest time; events with equal time are ordered by '<'. Events cannot be changed while in the queue.
+     * @tparam T The type of elements in the queue.
+     */
+    template <typename T>
+    class CalendarQueue {
+    public:
+        using value_type = T;
+
+        CalendarQueue() : buckets(initial_bucket_count) {
+            static_assert(DynaPlex::Concepts::Comparable<T>, "DynaPlex::CalendarQueue<T> : Type T must be comparable using the '<' operator");
+            static_assert(DynaPlex::Concepts::HasIntegerTime<T>, "DynaPlex::CalendarQueue<T> : Type T must have an integral member time");
+        }
+
+        /**
+         * @brief Iterator over all events, in no particular order.
+         */
+        class const_iterator {
+        private:
+            const CalendarQueue* queue_ptr;
+            size_t bucket;
+            size_t index;
+
+            void SkipEmpty() {
+                while (bucket < queue_ptr->buckets.size() && index == queue_ptr->buckets[bucket].size()) {
+                    ++bucket;
+                    index = 0;
+                }
+            }
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            const_iterator(const CalendarQueue* queue_ptr, size_t bucket)
+                : queue_ptr(queue_ptr), bucket(bucket), index(0) {
+                SkipEmpty();
+            }
+
+            bool operator==(const const_iterator& rhs) const { return bucket == rhs.bucket && index == rhs.index && queue_ptr == rhs.queue_ptr; }
+            bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+            const T& operator*() const {
+                return queue_ptr->buckets[bucket][index];
+            }
+            const T* operator->() const {
+                return &queue_ptr->buckets[bucket][index];
+            }
+            const_iterator& operator++() {
+                ++index;
+                SkipEmpty();
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+        };
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, buckets.size()); }
+
+        size_t size() const { return num_items; }
+
+        bool empty() const { return num_items == 0; }
+
+        /**
+         * @brief Add an element to the queue. Provided for consistency with API, see push.
+         */
+        void push_back(const T& value) {
+            push(value);
+        }
+
+        /**
+         * @brief Add an element to the queue. Expected O(1).
+         */
+        void push(const T& value) {
+            int64_t time = static_cast<int64_t>(value.time);
+            if (num_items == 0 || time < current_time)
+                current_time = time;
+            buckets[BucketOf(time)].push_back(value);
+            ++num_items;
+            located = false;
+            if (num_items > 2 * buckets.size())
+                Rebucket(2 * buckets.size());
+        }
+
+        /**
+         * @brief Access the first element of the queue, i.e. the one with the smallest time.
+         */
+        const T& first() const {
+            if (num_items == 0)
+                throw DynaPlex::Error("CalendarQueue::first - queue is empty.");
+            Locate();
+            return buckets[first_bucket][first_index];
+        }
+
+        /**
+         * @brief Remove the first element from the queue. Expected O(1).
+         */
+        void pop() {
+            if (num_items == 0)
+                throw DynaPlex::Error("CalendarQueue::pop - queue is empty.");
+            Locate();
+            auto& bucket = buckets[first_bucket];
+            if (first_index != bucket.size() - 1)
+                bucket[first_index] = std::move(bucket.back());
+            bucket.pop_back();
+            --num_items;
+            located = false;
+            ++pops_since_rebucket;
+            //adapt the bucket width if finding the first event was expensive; at most once per num_items pops, such that the cost is amortized:
+            if ((scanned_all || crowded) && num_items > 1 && pops_since_rebucket >= num_items)
+                Rebucket(buckets.size());
+        }
+
+        /**
+         * @brief Clear all elements from the queue.
+         */
+        void clear() {
+            buckets.assign(initial_bucket_count, {});
+            num_items = 0;
+            width = 1;
+            current_time = 0;
+            located = false;
+            scanned_all = crowded = false;
+            pops_since_rebucket = 0;
+        }
+
+    private:
+        static constexpr size_t initial_bucket_count = 16;
+        //number of earliest events used to estimate the spacing between events:
+        static constexpr size_t spacing_sample_size = 25;
+
+        //the number of buckets is a power of two:
+        std::vector<std::vector<T>> buckets;
+        size_t num_items{ 0 };
+        //number of time units covered by each bucket:
+        int64_t width{ 1 };
+        //lower bound on the time of all events in the queue:
+        mutable int64_t current_time{ 0 };
+        //cached position of the first element:
+        mutable bool located{ false };
+        mutable size_t first_bucket{ 0 };
+        mutable size_t first_index{ 0 };
+        //whether the last search for the first event scanned all events (buckets too narrow), or a crowded bucket (buckets too wide):
+        mutable bool scanned_all{ false };
+        mutable bool crowded{ false };
+        size_t pops_since_rebucket{ 0 };
+
+        static int64_t FloorDiv(int64_t time, int64_t divisor) {
+            return time >= 0 ? time / divisor : -((-time + divisor - 1) / divisor);
+        }
+
+        size_t BucketOf(int64_t time) const {
+            return static_cast<size_t>(static_cast<uint64_t>(FloorDiv(time, width)) & (buckets.size() - 1));
+        }
+
+        /// finds the smallest event with time in [window_start, window_start + width) in its bucket; returns false if there is none.
+        bool LocateIn(int64_t window_start) const {
+            size_t bucket = BucketOf(window_start);
+            const auto& items = buckets[bucket];
+            bool found = false;
+            for (size_t i = 0; i < items.size(); ++i) {
+                int64_t time = static_cast<int64_t>(items[i].time);
+                if (time < window_start || time - window_start >= width)
+                    continue;
+                if (!found || time < static_cast<int64_t>(items[first_index].time) 
+                    || (time == static_cast<int64_t>(items[first_index].time) && items[i] < items[first_index])) {
+                    first_index = i;
+                    found = true;
+                }
+            }
+            if (found) {
+                crowded = items.size() > 4 + 4 * num_items / buckets.size();
+                first_bucket = bucket;
+                current_time = static_cast<int64_t>(items[first_index].time);
+                located = true;
+            }
+            return found;
+        }
+
+        void Locate() const {
+            if (located)
+                return;
+            scanned_all = false;
+            //scan one year of buckets, starting at the bucket of the current time:
+            int64_t window_start = FloorDiv(current_time, width) * width;
+            for (size_t k = 0; k < buckets.size(); ++k) {
+                if (LocateIn(window_start + static_cast<int64_t>(k) * width))
+                    return;
+            }
+            //all events are more than a year ahead; jump to the earliest:
+            scanned_all = true;
+            bool any = false;
+            int64_t earliest = 0;
+            for (const auto& item : *this) {
+                int64_t time = static_cast<int64_t>(item.time);
+                if (!any || time < earliest)
+                    earliest = time;
+                any = true;
+            }
+            LocateIn(FloorDiv(earliest, width) * width);
+        }
+
+        /// bucket width of about three times the average spacing of the earliest events (Brown, 1988).
+        int64_t EstimateWidth() const {
+            std::vector<int64_t> times;
+            times.reserve(num_items);
+            for (const auto& item : *this)
+                times.push_back(static_cast<int64_t>(item.time));
+            if (times.size() < 2)
+                return width;
+            size_t sample = std::min(times.size(), spacing_sample_size);
+            std::partial_sort(times.begin(), times.begin() + sample, times.end());
+            int64_t span = times[sample - 1] - times.front();
+            return std::max<int64_t>(1, 3 * span / static_cast<int64_t>(sample - 1));
+        }
+
+        void Rebucket(size_t bucket_count) {
+            width = EstimateWidth();
+            std::vector<std::vector<T>> old_buckets(bucket_count);
+            std::swap(old_buckets, buckets);
+            for (auto& bucket : old_buckets)
+                for (auto& item : bucket)
+                    buckets[BucketOf(static_cast<int64_t>(item.time))].push_back(std::move(item));
+            located = false;
+            scanned_all = crowded = false;
+            pops_since_rebucket = 0;
+        }
+    };
+
+    /**
+     * Two calendar queues are considered equal if, after sorting, the matching elements match.
+     */
+    template<typename T>
+    bool operator==(const DynaPlex::CalendarQueue<T>& lhs, const DynaPlex::CalendarQueue<T>& rhs) {
+        auto lhs_data = std::vector<T>(lhs.begin(), lhs.end());
+        auto rhs_data = std::vector<T>(rhs.begin(), rhs.end());
+        std::sort(lhs_data.begin(), lhs_data.end());
+        std::sort(rhs_data.begin(), rhs_data.end());
+        return lhs_data == rhs_data;
+    }
+}
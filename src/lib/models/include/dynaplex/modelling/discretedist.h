@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <span>
 #include <dynaplex/vargroup.h>
 #include <dynaplex/rng.h>
 
@@ -47,6 +48,9 @@ namespace DynaPlex
 		std::vector<double> cumulativePMF{};
 		bool optimizedForSampling{ false };
 		int64_t min{ 0 };
+		//Walker/Vose alias table, built on construction: index i is kept with probability aliasProb[i], and otherwise replaced by alias[i].
+		std::vector<double> aliasProb{};
+		std::vector<int64_t> alias{};
 
 
 
@@ -55,6 +59,12 @@ namespace DynaPlex
 
 
 		static void Trim(std::vector<double>& toBeTrimmed, int64_t& min);
+		void BuildAliasTable();
+		/// inverse cdf, i.e. monotone in u; used for rngs that request monotone sampling. 
+		int64_t InverseCDF(double u) const;
+		/// convolution of two PMFs; direct for small supports, and FFT-based otherwise. 
+		static std::vector<double> Convolve(const std::vector<double>& first, const std::vector<double>& second);
+		DiscreteDist AddNUncached(int64_t k) const;
 
 
 		// Always ensure the PMF is validated using IsProbMassFunction 
@@ -119,8 +129,16 @@ namespace DynaPlex
 
 
 		/// returns distribution that corresponds to the sum of this and another distribution (assuming the two distributions are independent)
+		/// For large supports, the convolution is computed using FFT. 
 		DiscreteDist Add(const DiscreteDist& other) const;
 
+		/**
+		 * Returns the distribution of the sum of k independent copies of this distribution (the zero distribution for k=0), e.g. the 
+		 * demand over a lead time. Uses repeated squaring, i.e. O(log k) convolutions. Results are cached process-wide, keyed by 
+		 * this distribution and k, such that MDPs constructed repeatedly with the same parameters do not recompute them. 
+		 */
+		DiscreteDist AddN(int64_t k) const;
+
 		/// Returns a discrete distribution that represents the maximum of the current distribution and the given value.
 		DiscreteDist TakeMaximumWith(int64_t value) const;
 
@@ -156,12 +174,20 @@ namespace DynaPlex
 
 		DiscreteDist(const DynaPlex::VarGroup& vars);
 		
-		/// creates an internal data structure that enables samples to be drawn much faster, especially when there are many potential values that this might take on.
+		/// creates an internal data structure that enables conditional samples (see GetConditionalSample) to be drawn much faster, especially when there are many potential values that this might take on.
+		/// GetSample does not need this, as it uses an alias table, or the cumulative pmf built on construction. 
 		void OptimizeForSampling();
 
-		/// Returns a sample of the rv, using the rng as random number generator. 
+		/// Returns a sample of the rv, using the rng as random number generator. Takes constant time, and a single rng.genUniform() draw. 
+		/// If rng.IsMonotone(), samples by inverse cdf (logarithmic time) instead, such that antithetic draws give negatively correlated samples. 
 		int64_t GetSample(DynaPlex::RNG& rng) const;
 
+		/// Fills samples with independent samples of the rv; equivalent to calling GetSample for each element in turn. 
+		void GetSamples(DynaPlex::RNG& rng, std::span<int64_t> samples) const;
+
+		/// Fills samples[i] with a sample drawn using *rngs[i], e.g. to implement MDP::GetEvents. Equivalent to calling GetSample for each rng in turn. 
+		void GetSamples(std::span<DynaPlex::RNG*> rngs, std::span<int64_t> samples) const;
+
 		/// Returns a sample x of the rv|x>=minimum_value. Uses the rng as random number generator. 
 		int64_t GetConditionalSample(DynaPlex::RNG& rng,int64_t minimum_value) const;
 
@@ -1,6 +1,8 @@
 #pragma once
-#include <algorithm> //push_heap, pop_heap. 
-#include <functional> //std::greater
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
 #include "dynaplex/error.h"
 namespace DynaPlex {
 
@@ -14,7 +16,12 @@ namespace DynaPlex {
     }
 
     /**
-     * @brief Custom heap implementation with iterator access.
+     * @brief Indexed 4-ary min-heap with iterator access. 
+     * 
+     * Elements are ordered by '<', such that first() is the smallest element (e.g. the earliest event). 
+     * push returns a handle that remains valid until the element is removed (by pop, erase or clear); through the handle, an
+     * element can be changed (update) or removed (erase) in O(log n), instead of rebuilding the heap with resort(). Handles of 
+     * removed elements are reused. 
      * @tparam T The type of elements in the heap.
       */
     template <typename T>
@@ -22,6 +29,7 @@ namespace DynaPlex {
       
     public:
         using value_type = T;
+        using Handle = size_t;
         
         EventHeap() {
             static_assert(DynaPlex::Concepts::Comparable<T>, "DynaPlex::EventHeap<T> : Type T must be comparable using the '>' operator");
@@ -32,7 +40,7 @@ namespace DynaPlex {
         using const_iterator = typename std::vector<T>::const_iterator;
       
         /**
-         * @brief Get an iterator to the beginning of the container.
+         * @brief Get an iterator to the beginning of the container. Elements are visited in heap order, not in sorted order.
          * @return Iterator to the start of the container.
          */
         iterator begin() { return data.begin(); }
@@ -55,32 +63,49 @@ namespace DynaPlex {
          */
         const_iterator end() const { return data.end(); }
 
+        size_t size() const { return data.size(); }
+
+        bool empty() const { return data.empty(); }
+
 
         /**
         * @brief Add an element to the heap. Note: Provided for consistency with API - heap does not have a back
         * so it will just be pushed onto the heap. 
         * @param value The value to add to the heap.
         */
-        void push_back(const T& value) {
-            push(value);
+        Handle push_back(const T& value) {
+            return push(value);
         }
 
         /**
          * @brief Add an element to the heap.
          * @param value The value to add to the heap.
+         * @return Handle to the element, valid until the element is removed. 
          */
-        void push(const T& value) {
+        Handle push(const T& value) {
+            Handle handle;
+            if (free_handles.empty()) {
+                handle = positions.size();
+                positions.push_back(data.size());
+            }
+            else {
+                handle = free_handles.back();
+                free_handles.pop_back();
+                positions[handle] = data.size();
+            }
             data.push_back(value);
-            std::push_heap(data.begin(), data.end(), std::greater<T>());
-
+            handles.push_back(handle);
+            SiftUp(data.size() - 1);
+            return handle;
         }
 
         /**
          * @brief Remove the top item from the heap.
          */
         void pop() {
-            std::pop_heap(data.begin(), data.end(), std::greater<T>());
-            data.pop_back();
+            if (data.size() == 0)
+                throw DynaPlex::Error("EventHeap::pop - heap is empty.");
+            RemoveAt(0);
         }
 
         /**
@@ -94,8 +119,8 @@ namespace DynaPlex {
         }
 
         /**
-         * @brief Access the first element of the heap.
-         * @return A constant reference to the top element.
+         * @brief Access the first element of the heap. After changing it, call update(first_handle()) or resort().
+         * @return A reference to the top element.
          */
         T& first(){
             if (data.size() == 0)
@@ -103,25 +128,156 @@ namespace DynaPlex {
             return data.front();
         }
 
+        /**
+         * @brief Handle of the first element of the heap.
+         */
+        Handle first_handle() const {
+            if (data.size() == 0)
+                throw DynaPlex::Error("EventHeap::first_handle - heap is empty.");
+            return handles.front();
+        }
+
+        /**
+         * @brief Whether handle refers to an element in the heap.
+         */
+        bool contains(Handle handle) const {
+            return handle < positions.size() && positions[handle] != npos;
+        }
+
+        /**
+         * @brief Access the element with this handle. After changing it, call update(handle). 
+         */
+        T& operator[](Handle handle) {
+            return data[Position(handle)];
+        }
+
+        const T& operator[](Handle handle) const {
+            return data[Position(handle)];
+        }
+
+        /**
+         * @brief Restores the heap order after the element with this handle was changed in place. O(log n).
+         */
+        void update(Handle handle) {
+            size_t pos = Position(handle);
+            if (!SiftUp(pos))
+                SiftDown(pos);
+        }
+
+        /**
+         * @brief Replaces the element with this handle, e.g. to reschedule an event. O(log n).
+         */
+        void update(Handle handle, const T& value) {
+            data[Position(handle)] = value;
+            update(handle);
+        }
+
+        /**
+         * @brief Removes the element with this handle, e.g. to cancel an event. O(log n).
+         */
+        void erase(Handle handle) {
+            RemoveAt(Position(handle));
+        }
+
         /**
          * @brief Clear all elements from the heap.
          */
         void clear() {
             data.clear();
+            handles.clear();
+            positions.clear();
+            free_handles.clear();
+        }
+
+        void reserve(size_t capacity) {
+            data.reserve(capacity);
+            handles.reserve(capacity);
+            positions.reserve(capacity);
         }
  
         /**
-         * When elements are changed while inside the heap, this must be used to restore the order. 
+         * When elements are changed while inside the heap (e.g. through iterators), this must be used to restore the order. 
+         * O(n); prefer update when a single element changed. 
          */
         void resort() {
-            std::make_heap(data.begin(), data.end(), std::greater<T>());
+            if (data.size() < 2)
+                return;
+            for (size_t pos = Parent(data.size() - 1) + 1; pos-- > 0;)
+                SiftDown(pos);
         }
 
     private:
-        /** @brief The underlying container storing the heap elements. */
+        static constexpr size_t arity = 4;
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        /** @brief The underlying container storing the heap elements, in heap order. */
         std::vector<T> data;
+        /** @brief handles[i] is the handle of data[i]. */
+        std::vector<Handle> handles;
+        /** @brief positions[handle] is the index in data of the element with handle, or npos if handle is not in use. */
+        std::vector<size_t> positions;
+        std::vector<Handle> free_handles;
+
+        static size_t Parent(size_t pos) {
+            return (pos - 1) / arity;
+        }
+
+        size_t Position(Handle handle) const {
+            if (!contains(handle))
+                throw DynaPlex::Error("EventHeap - handle " + std::to_string(handle) + " does not refer to an element in the heap.");
+            return positions[handle];
+        }
+
+        void Swap(size_t a, size_t b) {
+            std::swap(data[a], data[b]);
+            std::swap(handles[a], handles[b]);
+            positions[handles[a]] = a;
+            positions[handles[b]] = b;
+        }
+
+        /// moves the element at pos up while it is smaller than its parent; returns whether it moved.
+        bool SiftUp(size_t pos) {
+            size_t start = pos;
+            while (pos > 0) {
+                size_t parent = Parent(pos);
+                if (!(data[pos] < data[parent]))
+                    break;
+                Swap(pos, parent);
+                pos = parent;
+            }
+            return pos != start;
+        }
 
+        void SiftDown(size_t pos) {
+            size_t size = data.size();
+            while (true) {
+                size_t first_child = arity * pos + 1;
+                if (first_child >= size)
+                    break;
+                size_t smallest = first_child;
+                size_t last_child = std::min(first_child + arity, size);
+                for (size_t child = first_child + 1; child < last_child; ++child)
+                    if (data[child] < data[smallest])
+                        smallest = child;
+                if (!(data[smallest] < data[pos]))
+                    break;
+                Swap(pos, smallest);
+                pos = smallest;
+            }
+        }
 
+        void RemoveAt(size_t pos) {
+            size_t last = data.size() - 1;
+            Handle removed = handles[pos];
+            if (pos != last)
+                Swap(pos, last);
+            data.pop_back();
+            handles.pop_back();
+            positions[removed] = npos;
+            free_handles.push_back(removed);
+            if (pos != last && !SiftUp(pos))
+                SiftDown(pos);
+        }
 
     };
 
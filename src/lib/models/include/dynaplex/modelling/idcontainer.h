@@ -1,23 +1,86 @@
 #pragma once
 #include <vector>
-#include <optional>
+#include <limits>
 #include "dynaplex/error.h"
 #include "dynaplex/vargroup.h"
+#include "dynaplex/bytestream.h"
 #include <string>
 #include <algorithm>
 
 namespace DynaPlex {
 
+    /**
+     * Container that assigns a unique id (>0) to each item, e.g. for orders that are created and deleted during a simulation. 
+     * Implemented as slot map: items are stored in a dense array (such that iteration does not skip holes), and the id 
+     * refers to a slot that holds the position of the item in the dense array. Freed slots are reused in O(1) via a free list. 
+     * An id combines the slot (lower 32 bits) with the generation of the slot (upper bits), which is incremented whenever an 
+     * item is deleted; ids of deleted items thus remain invalid after their slot is reused. Generations wrap around after 2^31
+     * deletes from the same slot, such that ids remain positive. 
+     * ToVarGroup stores items keyed by their id, and iteration order is unspecified. 
+     */
     template<Concepts::VarGroupConvertible T>
     class IdContainer {
     private:    
-       std::vector<std::optional<std::pair<int64_t, T>>> backstore;
-        size_t first_empty_id = 1;
-        size_t num_items = 0;
+        static constexpr int slot_bits = 32;
+        static constexpr int64_t slot_mask = (int64_t{ 1 } << slot_bits) - 1;
+        //generations take the remaining 31 bits below the sign bit:
+        static constexpr int64_t generation_mask = (int64_t{ 1 } << (63 - slot_bits)) - 1;
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        //items, with their ids:
+        std::vector<std::pair<int64_t, T>> dense;
+        //for each slot, the generation and the position of its item in dense (npos if the slot is free). Slot 0 is never used.
+        std::vector<int64_t> generations{ 0 };
+        std::vector<size_t> dense_index{ npos };
+        //free slots; the next slot to be used is at the back.
+        std::vector<size_t> free_slots;
+
+        static size_t SlotOf(int64_t id) {
+            return static_cast<size_t>(id & slot_mask);
+        }
+
+        /// position in dense of the item with this id, or npos if there is no such item.
+        size_t Find(int64_t id) const {
+            if (id <= 0)
+                return npos;
+            size_t slot = SlotOf(id);
+            if (slot >= dense_index.size() || generations[slot] != (id >> slot_bits))
+                return npos;
+            return dense_index[slot];
+        }
+
+        /// reinitializes as empty container with slots 1, ..., slot_count-1 that are all free.
+        void Reset(size_t slot_count) {
+            dense.clear();
+            generations.assign(slot_count, 0);
+            dense_index.assign(slot_count, npos);
+            free_slots.clear();
+        }
+
+        /// adds an item with a given id (e.g. when loading), where the slot must be free. 
+        void Insert(int64_t id, T&& item) {
+            if (id <= 0)
+                throw DynaPlex::Error("IdContainer:: item key/index should be >0.");
+            size_t slot = SlotOf(id);
+            if (slot == 0)
+                throw DynaPlex::Error("IdContainer:: invalid item key/index " + std::to_string(id) + ".");
+            if (slot >= dense_index.size()) {
+                generations.resize(slot + 1, 0);
+                dense_index.resize(slot + 1, npos);
+            }
+            if (dense_index[slot] != npos)
+                throw DynaPlex::Error("IdContainer:: duplicate id " + std::to_string(id) + ".");
+            generations[slot] = id >> slot_bits;
+            dense_index[slot] = dense.size();
+            dense.emplace_back(id, std::move(item));
+        }
 
-        void updateFirstEmptyIndex() {
-            while (first_empty_id < backstore.size() && backstore[first_empty_id].has_value()) {
-                first_empty_id++;
+        /// after loading, collects the free slots, such that the smallest is reused first. 
+        void RebuildFreeList() {
+            free_slots.clear();
+            for (size_t slot = dense_index.size(); slot-- > 1;) {
+                if (dense_index[slot] == npos)
+                    free_slots.push_back(slot);
             }
         }
 
@@ -27,69 +90,72 @@ namespace DynaPlex {
 
         IdContainer(const VarGroup& varGroup) {
             auto keys = varGroup.Keys();
+            dense.reserve(keys.size());
             for (const auto& key : keys) {
                 if (!isNumeric(key)) {
                     throw Error("IdContainer: Key string is not numeric: " + key);
                 }
 
                 int64_t id = std::stoll(key);
-                if (id >= backstore.size()) {
-                    backstore.resize(id + 1);
-                }
-                if (id <= 0)
-                    throw DynaPlex::Error("IdContainer:: item key/index should be >0.");
-
                 DynaPlex::VarGroup vg;
                 varGroup.Get(key, vg);
-                backstore[id] = std::make_pair(id,T(vg));
-                num_items++;
+                Insert(id, T(vg));
             }
-            updateFirstEmptyIndex();
+            RebuildFreeList();
         }
 
         std::pair<int64_t, T>& AddNew() {
-            if (first_empty_id >= backstore.size()) {
-                backstore.resize(first_empty_id + 1);
+            size_t slot;
+            if (free_slots.empty()) {
+                slot = dense_index.size();
+                if (slot > static_cast<size_t>(slot_mask))
+                    throw DynaPlex::Error("IdContainer::AddNew : too many items.");
+                generations.push_back(0);
+                dense_index.push_back(npos);
             }
-            auto& element = backstore[first_empty_id];
-            // Placement new to construct the object in-place, to avoid a memory allocation here:
-       
-            backstore[first_empty_id].emplace(first_empty_id, T{});
-            num_items++;
-            auto id = first_empty_id;
-            updateFirstEmptyIndex();
-            return backstore[id].value();
+            else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+            dense_index[slot] = dense.size();
+            return dense.emplace_back(static_cast<int64_t>(slot) | (generations[slot] << slot_bits), T{});
         }
 
         bool HasId(int64_t id) const {
-            return id >= 0 && id < static_cast<int64_t>(backstore.size()) && backstore[id].has_value();
+            return Find(id) != npos;
         }
 
         const T& operator[](int64_t id) const {
-            if (id < 0 || id >= static_cast<int64_t>(backstore.size()) || !backstore[id]) {
+            size_t pos = Find(id);
+            if (pos == npos) {
                 throw Error("IdContainer::GetItem: Invalid ID or item does not exist");
             }
-            return *(backstore[id].second);
+            return dense[pos].second;
         }
 
         T& operator[](int64_t id) {
-            if (id < 0 || id >= static_cast<int64_t>(backstore.size()) || !backstore[id]) {
+            size_t pos = Find(id);
+            if (pos == npos) {
                 throw Error("IdContainer::GetItem: Invalid ID or item does not exist");
             }
-            return backstore[id].value().second;
+            return dense[pos].second;
         }
 
+        /// removes the item in O(1); the last item in iteration order takes its place. 
         void Delete(int64_t id) {
-            if (id >0 && id < backstore.size() && backstore[id]) {
-                backstore[id] = std::nullopt;
-                num_items--;
-                if (id < first_empty_id) {
-                    first_empty_id = id;
-                }
-            }
-            else {
+            size_t pos = Find(id);
+            if (pos == npos) {
                 throw Error("IdContainer::DeleteItem : id not available");
             }
+            if (pos != dense.size() - 1) {
+                dense[pos] = std::move(dense.back());
+                dense_index[SlotOf(dense[pos].first)] = pos;
+            }
+            dense.pop_back();
+            size_t slot = SlotOf(id);
+            dense_index[slot] = npos;
+            generations[slot] = (generations[slot] + 1) & generation_mask;
+            free_slots.push_back(slot);
         }
 
         VarGroup ToVarGroup() const {
@@ -100,107 +166,45 @@ namespace DynaPlex {
             return varGroup;
         }
 
-        size_t size() const {
-            return num_items;
-        }
-
-        class iterator {
-        public:
-            using iterator_category = std::forward_iterator_tag;
-            using value_type = std::pair<int64_t, T>; 
-            using difference_type = std::ptrdiff_t;
-            using pointer = value_type*;
-            using reference = value_type&;  
-
-            iterator(std::vector<std::optional<std::pair<int64_t, T>>>& bs, size_t pos) : backstore(bs), position(pos) {
-                advanceToNextValid();
-            }
-
-            reference operator*() {
-                return backstore[position].value();
-            }
-
-            iterator& operator++() {
-                ++position;
-                advanceToNextValid();
-                return *this;
-            }
-
-            bool operator==(const iterator& other) const {
-                return position == other.position;
+        /// compact binary form (number of items, followed by id and item for each item), see ByteSink. 
+        void Serialize(ByteSink& sink) const {
+            sink.Write(static_cast<uint64_t>(dense.size()));
+            for (auto& [id, item] : *this) {
+                sink.Write(id, item);
             }
+        }
 
-            bool operator!=(const iterator& other) const {
-                return !(*this == other);
+        void Deserialize(ByteSource& source) {
+            Reset(1);
+            auto count = source.Read<uint64_t>();
+            for (uint64_t i = 0; i < count; i++) {
+                auto id = source.Read<int64_t>();
+                Insert(id, source.Read<T>());
             }
+            RebuildFreeList();
+        }
 
-        private:
-            std::vector<std::optional<std::pair<int64_t, T>>>& backstore;
-            size_t position;
+        size_t size() const {
+            return dense.size();
+        }
 
-            void advanceToNextValid() {
-                while (position < backstore.size() && !backstore[position]) {
-                    ++position;
-                }
-            }
-        };
+        using iterator = typename std::vector<std::pair<int64_t, T>>::iterator;
+        using const_iterator = typename std::vector<std::pair<int64_t, T>>::const_iterator;
 
         iterator begin() {
-            return iterator(backstore, 0);
+            return dense.begin();
         }
 
         iterator end() {
-            return iterator(backstore, backstore.size());
+            return dense.end();
         }
 
-        class const_iterator {
-        public:
-            using iterator_category = std::forward_iterator_tag;
-            using value_type = const std::pair<int64_t, T>;
-            using difference_type = std::ptrdiff_t;
-            using pointer = const value_type*;
-            using reference = const value_type&;
-
-            const_iterator(const std::vector<std::optional<std::pair<int64_t, T>>>& bs, size_t pos)
-                : backstore(bs), position(pos) {
-                advanceToNextValid();
-            }
-
-            reference operator*() {
-                return backstore[position].value();
-            }
-
-            const_iterator& operator++() {
-                ++position;
-                advanceToNextValid();
-                return *this;
-            }
-
-            bool operator==(const const_iterator& other) const {
-                return position == other.position;
-            }
-
-            bool operator!=(const const_iterator& other) const {
-                return !(*this == other);
-            }
-
-        private:
-            const std::vector<std::optional<std::pair<int64_t, T>>>& backstore;
-            size_t position;
-
-            void advanceToNextValid() {
-                while (position < backstore.size() && !backstore[position]) {
-                    ++position;
-                }
-            }
-        };
-
         const_iterator begin() const {
-            return const_iterator(backstore, 0);
+            return dense.begin();
         }
 
         const_iterator end() const {
-            return const_iterator(backstore, backstore.size());
+            return dense.end();
         }
 
 
@@ -1,11 +1,25 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <tuple>
 #include <vector>
 #include <dynaplex/vargroup.h>
 #include <dynaplex/rng.h>
+#include <dynaplex/error.h>
 #include "dynaplex/modelling/discretedist.h"
 
 namespace DynaPlex
 {
+	/**
+	 * Joint distribution of independent discrete random variables, stored in product form, i.e. as its component distributions. 
+	 * Samples are drawn component-wise (each component uses its own alias table), and probabilities of joint quantities are products 
+	 * of component probabilities. The joint support, i.e. all combinations with positive probability in lexicographic order 
+	 * (first component outermost), is only enumerated when index-based functionality (iteration, ProbabilityAt, GetSample, 
+	 * GetQtysForJointDist, ...) is first used, and is then shared between copies. 
+	 */
 	class JointDiscreteDist
 	{
 	public:
@@ -41,41 +55,40 @@ namespace DynaPlex
 		Iterator begin() const;
 		Iterator end() const;
 
-		bool operator==(const JointDiscreteDist& other) const = default;
+		/// distributions are equal if their components are; the lazily enumerated support is not compared. 
+		bool operator==(const JointDiscreteDist& other) const;
 	
 	private:
-		std::vector<double> translatedPMF{};
-		std::vector<std::vector<int64_t>> JointQtys;
+		/// enumerated joint support: quantities of position i are at [i*NumComponents(), (i+1)*NumComponents()).
+		struct Support {
+			std::vector<int64_t> qtys;
+			//distribution over positions in the support:
+			DiscreteDist positions;
+		};
+		struct LazySupport {
+			std::once_flag flag;
+			Support support;
+		};
 
+		std::vector<DiscreteDist> components;
+		std::shared_ptr<LazySupport> lazy;
 
 		inline static double epsilon{ 1e-16 };
 
-
-		// Always ensure the PMF is validated using IsProbMassFunction 
-		// before constructing a JointDiscreteDist object.
-		JointDiscreteDist(std::vector<double>&& TranslatedProbMF, std::vector<std::vector<int64_t>>&& JointQyt);
-		JointDiscreteDist(const std::vector<double>& translatedPMF, const std::vector<std::vector<int64_t>>& JointQyt);
-
-		static bool IsProbMassFunction(const std::vector<double>& PMF);
-
-		static void GetJointDistribution(const std::vector<DynaPlex::DiscreteDist>& distributions,
-			size_t currentDistIndex,
-			std::vector<std::vector<int64_t>>& Qtys,
-			std::vector<double>& probVec,
-			std::vector<int64_t> currentQtys,
-			double currentProb);
+		const Support& GetSupport() const;
+		static Support EnumerateSupport(const std::vector<DiscreteDist>& components);
 		
 	public:
 
 		/**
-		 * Returns the probability that the rv takes on this specific value. 
+		 * Returns the probability that the rv takes on this specific value (i.e. position in the joint support). 
 		 */
 		double ProbabilityAt(int64_t value) const;
 
-		///returns the values for which probabilities are stored in this r.v.. Note some of these probabilities may be zero.
+		///returns the number of positions in the joint support. 
 		int64_t DistinctValueCount() const;
 
-		//Gets a vector that contains pairs of quantities and probabilities, together representing this probability distribution. 
+		//Gets a vector that contains pairs of positions and probabilities, together representing this probability distribution. 
 		std::vector<QtyProb> QuantityProbabilities() const;
 
 		JointDiscreteDist();
@@ -86,26 +99,66 @@ namespace DynaPlex
 
 		int64_t Max() const
 		{
-			return static_cast<int64_t>(translatedPMF.size()) - 1ll;
+			return DistinctValueCount() - 1ll;
+		}
+
+		/// number of component distributions.
+		size_t NumComponents() const
+		{
+			return components.size();
+		}
+
+		const DiscreteDist& Component(size_t index) const
+		{
+			return components.at(index);
 		}
 
-		/// Returns a sample of the rv, using the rng as random number generator. 
+		/// Returns a sample of the position in the joint support, using the rng as random number generator. Enumerates the support. 
 		int64_t GetSample(DynaPlex::RNG& rng) const;
 
+		/// Returns a sample of the joint quantities, sampling each component in turn. Does not enumerate the support. 
 		std::vector<int64_t> GetSampleQtys(DynaPlex::RNG& rng) const;
 
-		std::vector<int64_t> GetQtysForJointDist(int64_t pos) const;
-
-		int64_t FindPositionInJointQtys(const std::vector<int64_t> qty) const;
+		/// Fills qtys (of size NumComponents()) with a sample of the joint quantities, sampling each component in turn. 
+		void GetSampleQtys(DynaPlex::RNG& rng, std::span<int64_t> qtys) const;
 
-		double ProbabilityAtFromQtys(const std::vector<int64_t> qty) const;
+		/// Returns a sample of the joint quantities as fixed-size array, e.g. for use as MDP::Event. N should equal NumComponents(). 
+		template<size_t N>
+		std::array<int64_t, N> GetSampleTuple(DynaPlex::RNG& rng) const
+		{
+			std::array<int64_t, N> qtys;
+			GetSampleQtys(rng, qtys);
+			return qtys;
+		}
 
-		// it might be faster to get JointQtys beforehand have it as part of MDP instead of querrying the quantities after each event
-		const std::vector<std::vector<int64_t>>& GetJointQtys() const
+		/// Returns all joint quantities with positive probability as fixed-size arrays, e.g. for implementing MDP::EventProbabilities. 
+		template<size_t N>
+		std::vector<std::tuple<std::array<int64_t, N>, double>> TupleProbabilities() const
 		{
-			return JointQtys;
+			if (N != NumComponents())
+				throw DynaPlex::Error("JointDiscreteDist::TupleProbabilities - N differs from number of components.");
+			const auto& support = GetSupport();
+			std::vector<std::tuple<std::array<int64_t, N>, double>> result;
+			result.reserve(static_cast<size_t>(DistinctValueCount()));
+			for (const auto& [pos, prob] : support.positions)
+			{
+				std::array<int64_t, N> qtys;
+				std::copy_n(support.qtys.begin() + pos * N, N, qtys.begin());
+				result.emplace_back(qtys, prob);
+			}
+			return result;
 		}
 
+		std::vector<int64_t> GetQtysForJointDist(int64_t pos) const;
+
+		int64_t FindPositionInJointQtys(const std::vector<int64_t>& qty) const;
+
+		/// Returns the probability of the joint quantities, as product of the component probabilities. Does not enumerate the support. 
+		double ProbabilityAtFromQtys(const std::vector<int64_t>& qty) const;
+
+		/// Returns the enumerated joint support. Prefer the product-form functions, which avoid materializing the support. 
+		std::vector<std::vector<int64_t>> GetJointQtys() const;
+
 	};
 
-} // namespace DynaPlex::Modelling
\ No newline at end of file
+} // namespace DynaPlex::Modelling
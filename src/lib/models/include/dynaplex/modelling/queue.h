@@ -1,12 +1,21 @@
 #pragma once
 #include<vector>
+#include <array>
 #include <limits>
+#include <algorithm>
 #include <iterator>
 #include "dynaplex/error.h"
 #include "dynaplex/vargroup.h"
+#include "dynaplex/bytestream.h"
 
 namespace DynaPlex {
-	template<typename T>
+	/**
+	 * FIFO queue, implemented as ring buffer. Items are stored inline (i.e. inside the Queue object itself) as long as the queue 
+	 * holds at most InlineCapacity items, and on the heap otherwise. Copying a Queue that fits its inline capacity thus does not 
+	 * allocate, which makes e.g. Queue<int64_t, 16> suitable for pipelines in states that are cloned frequently. 
+	 * With InlineCapacity = 0 (default), items are always stored on the heap. 
+	 */
+	template<typename T, size_t InlineCapacity = 0>
 	class Queue
 	{
 		static_assert(DynaPlex::Concepts::DP_ElementType<T>, " DynaPlex::Queue<T> - T must be of DP_ElementType, i.e. double, int64_t, string, or DynaPlex::VarGroupConvertible.");
@@ -22,18 +31,54 @@ namespace DynaPlex {
 	private:
 		size_t first_item;
 		size_t num_items;
-		std::vector<T> items;
+		//size of the ring buffer; items are in inline_items if capacity <= InlineCapacity, and in heap_items otherwise.
+		size_t capacity;
+		std::array<T, InlineCapacity> inline_items{};
+		std::vector<T> heap_items;
+
+		bool IsInline() const {
+			return capacity <= InlineCapacity;
+		}
+		T* Items() {
+			return IsInline() ? inline_items.data() : heap_items.data();
+		}
+		const T* Items() const {
+			return IsInline() ? inline_items.data() : heap_items.data();
+		}
 
 		size_t GetVectorIndex(const size_t& unlooped_index) const {
-			if (unlooped_index >= items.size()) {
-				return unlooped_index - items.size();
+			if (unlooped_index >= capacity) {
+				return unlooped_index - capacity;
 			}
 			return unlooped_index;
 		}
 
+		/// empties the queue, and sets the capacity to at least n; the first n items are default-constructed.  
+		void Allocate(size_t n) {
+			first_item = 0;
+			num_items = 0;
+			heap_items.clear();
+			if (n <= InlineCapacity) {
+				capacity = InlineCapacity;
+				std::fill(inline_items.begin(), inline_items.end(), T{});
+			}
+			else {
+				capacity = n;
+				heap_items.resize(n);
+			}
+		}
+
+		/// leaves other empty, with its inline storage.
+		void Release(Queue& other) noexcept {
+			other.first_item = 0;
+			other.num_items = 0;
+			other.capacity = InlineCapacity;
+			other.heap_items.clear();
+		}
+
 	public:
 		size_t Capacity() const {
-			return items.size();
+			return capacity;
 		}
 
 
@@ -56,7 +101,7 @@ namespace DynaPlex {
 			bool operator!=(const const_iterator& rhs) const { return current != rhs.current; }
 			bool operator==(const const_iterator& rhs) const { return current == rhs.current && queue_ptr == rhs.queue_ptr; }
 			const T& operator*() {
-				return queue_ptr->items[queue_ptr->GetVectorIndex(current)];
+				return queue_ptr->Items()[queue_ptr->GetVectorIndex(current)];
 			}
 			const_iterator& operator++() {
 				++current;
@@ -79,24 +124,30 @@ namespace DynaPlex {
 
 
 		Queue(size_t n)
-			: first_item{ 0 }, num_items{ n }, items(n, 0) {
-
+			: first_item{ 0 }, num_items{ 0 }, capacity{ 0 } {
+			Allocate(n);
+			num_items = n;
 		}
 
 
 		Queue()
-			: first_item{ 0 }, num_items{ 0 }, items(0) {}
+			: first_item{ 0 }, num_items{ 0 }, capacity{ InlineCapacity } {}
 		Queue(size_t n, const T value)
-			: first_item{ 0 }, num_items{ n }, items(n, value) {}
+			: Queue(n) {
+			std::fill_n(Items(), n, value);
+		}
 
 		Queue(const Queue& other) = default;
 
 		Queue(std::initializer_list<T> init)
-			: first_item{ 0 }, num_items{ init.size() }, items(init) {}
+			: Queue(init.size()) {
+			std::copy(init.begin(), init.end(), Items());
+		}
 
 		Queue(Queue&& other) noexcept
-			: first_item{ other.first_item }, num_items{ other.num_items }, items(std::move(other.items)) {
-			other.num_items = 0;
+			: first_item{ other.first_item }, num_items{ other.num_items }, capacity{ other.capacity }, 
+			inline_items(std::move(other.inline_items)), heap_items(std::move(other.heap_items)) {
+			Release(other);
 		}
 
 		Queue& operator=(const Queue& other) = default;
@@ -105,50 +156,57 @@ namespace DynaPlex {
 			if (this != &other) {
 				first_item = other.first_item;
 				num_items = other.num_items;
-				items = std::move(other.items);
-				other.num_items = 0;
+				capacity = other.capacity;
+				inline_items = std::move(other.inline_items);
+				heap_items = std::move(other.heap_items);
+				Release(other);
 			}
 			return *this;
 		}
 
-		void reserve(size_t capacity)
+		void reserve(size_t new_capacity)
 		{
-			if (capacity > items.size())
+			if (new_capacity > capacity)
 			{
-				std::vector<T> new_items(capacity);
-				int i = 0;
+				//new_capacity > InlineCapacity, so items move to the heap.
+				std::vector<T> new_items(new_capacity);
+				size_t i = 0;
 				auto stop = end();
 				for (auto it = begin(); it != stop; ++it) {
 					new_items[i++] = *it;
 				}
+				if (IsInline()) {
+					std::fill(inline_items.begin(), inline_items.end(), T{});
+				}
 				first_item = 0;
-				items = std::move(new_items);
+				capacity = new_capacity;
+				heap_items = std::move(new_items);
 			}
 		}
 
 		void push_back(T item) {
 
-			if (num_items == items.size()) {
-				//Expand the vector
-				size_t new_capacity = (items.size() == 0) ? 4 : items.size() * 2;
+			if (num_items == capacity) {
+				//Expand the ring buffer
+				size_t new_capacity = (capacity == 0) ? 4 : capacity * 2;
 				reserve(new_capacity);
 
 			}
-			items[GetVectorIndex(first_item + num_items++)] = item;
+			Items()[GetVectorIndex(first_item + num_items++)] = item;
 		}
 
 		T& back() {
 			if (IsEmpty()) {
 				throw DynaPlex::Error("Queue: queue is empty");
 			}
-			return items[GetVectorIndex(first_item + num_items - 1)];
+			return Items()[GetVectorIndex(first_item + num_items - 1)];
 		}
 
 		const T& back() const {
 			if (IsEmpty()) {
 				throw DynaPlex::Error("Queue: queue is empty");
 			}
-			return items[GetVectorIndex(first_item + num_items - 1)];
+			return Items()[GetVectorIndex(first_item + num_items - 1)];
 		}
 
 		bool IsEmpty() const {
@@ -159,10 +217,10 @@ namespace DynaPlex {
 			if (IsEmpty()) {
 				throw DynaPlex::Error("Queue: queue is empty");
 			}
-			T front = items[first_item];
-			items[first_item++] = T{};
+			T front = std::move(Items()[first_item]);
+			Items()[first_item++] = T{};
 			num_items--;
-			if (first_item == items.size()) {
+			if (first_item == capacity) {
 				first_item = 0;
 			}
 			return front;
@@ -172,14 +230,14 @@ namespace DynaPlex {
 			if (IsEmpty()) {
 				throw DynaPlex::Error("Queue: queue is empty");
 			}
-			return items[first_item];
+			return Items()[first_item];
 		}
 
 		const T& front() const {
 			if (IsEmpty()) {
 				throw DynaPlex::Error("Queue: queue is empty");
 			}
-			return items[first_item];
+			return Items()[first_item];
 		}
 
 		T& at(size_t loc)
@@ -190,7 +248,7 @@ namespace DynaPlex {
 			if (loc >= num_items) {
 				throw DynaPlex::Error("Queue: length error");
 			}
-			return items[GetVectorIndex(first_item + loc)];
+			return Items()[GetVectorIndex(first_item + loc)];
 		}
 
 		const T& at(size_t loc) const
@@ -201,10 +259,10 @@ namespace DynaPlex {
 			if (loc >= num_items) {
 				throw DynaPlex::Error("Queue: length error");
 			}
-			return items[GetVectorIndex(first_item + loc)];
+			return Items()[GetVectorIndex(first_item + loc)];
 		}
 
-		T sum()
+		T sum() const
 		{
 			static_assert(std::is_same_v<T, double> || std::is_same_v<T, int64_t>, "dynaplex::queue::sum can only be called when T is double or int64_t");
 
@@ -217,19 +275,37 @@ namespace DynaPlex {
 		}
 		void clear()
 		{
-			items.clear();
-			first_item = 0;
-			num_items = 0;
+			Allocate(0);
+		}
+
+		/// compact binary form (number of items, followed by the items from front to back), see ByteSink. 
+		void Serialize(DynaPlex::ByteSink& sink) const
+		{
+			sink.Write(static_cast<uint64_t>(num_items));
+			auto stop = end();
+			for (auto it = begin(); it != stop; ++it) {
+				sink.Write(*it);
+			}
+		}
+
+		void Deserialize(DynaPlex::ByteSource& source)
+		{
+			clear();
+			auto size = source.Read<uint64_t>();
+			reserve(static_cast<size_t>(std::min<uint64_t>(size, 1024)));
+			for (uint64_t i = 0; i < size; i++) {
+				push_back(source.Read<T>());
+			}
 		}
 
-		friend bool operator==(const Queue<T>& lhs, const Queue<T>& rhs) {
+		friend bool operator==(const Queue& lhs, const Queue& rhs) {
 			if (lhs.num_items != rhs.num_items) {
 				return false;
 			}
 			return std::equal(lhs.begin(), lhs.end(), rhs.begin());
 		}
 
-		friend bool operator!=(const Queue<T>& lhs, const Queue<T>& rhs) {
+		friend bool operator!=(const Queue& lhs, const Queue& rhs) {
 			return !(lhs == rhs);
 		}
 
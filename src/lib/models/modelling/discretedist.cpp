@@ -1,6 +1,7 @@
 ﻿#include "dynaplex/modelling/discretedist.h"
 #include "dynaplex/error.h"
 #include <algorithm>  //sort
+#include <numeric>  //partial_sum
 #include <cmath>  //atan
 #include <unordered_map>
 #include <boost/math/distributions/binomial.hpp>
@@ -8,6 +9,8 @@
 #include <boost/math/distributions/geometric.hpp>
 #include <boost/math/distributions/poisson.hpp>
 #include <random>
+#include <complex>
+#include <mutex>
 
 
 namespace DynaPlex
@@ -146,6 +149,7 @@ namespace DynaPlex
 
 	DiscreteDist::DiscreteDist() : min(0), translatedPMF({ 1.0 })
 	{
+		BuildAliasTable();
 	}
 
 	static double PI = ::std::atan(1.0) * 4;
@@ -416,21 +420,141 @@ namespace DynaPlex
 		return std::abs(TotalProb - 1.0) < 1e-8;
 	}
 
-	DiscreteDist DiscreteDist::Add(const DiscreteDist& other) const
-	{
-		int64_t minResult = this->min + other.min;
-		int64_t maxResult = this->Max() + other.Max();
-		std::vector<double> PMFResult(static_cast<size_t>(maxResult - minResult + 1ll), 0.0);
-		for (size_t i = 0; i < translatedPMF.size(); i++)
+	namespace {
+		//in-place iterative radix-2 FFT; size of values must be a power of two. 
+		void FFT(std::vector<std::complex<double>>& values, bool inverse)
 		{
-			for (size_t j = 0; j < other.translatedPMF.size(); j++)
+			size_t n = values.size();
+			for (size_t i = 1, j = 0; i < n; i++)
+			{
+				size_t bit = n >> 1;
+				for (; j & bit; bit >>= 1)
+					j ^= bit;
+				j ^= bit;
+				if (i < j)
+					std::swap(values[i], values[j]);
+			}
+			for (size_t length = 2; length <= n; length <<= 1)
 			{
-				PMFResult[i + j] += this->translatedPMF[i] * other.translatedPMF[j];
+				double angle = 2 * PI / static_cast<double>(length) * (inverse ? 1 : -1);
+				for (size_t start = 0; start < n; start += length)
+				{
+					for (size_t k = 0; k < length / 2; k++)
+					{//twiddle factors are computed directly, which is more accurate than repeated multiplication:
+						std::complex<double> w = std::polar(1.0, angle * static_cast<double>(k));
+						auto u = values[start + k];
+						auto v = values[start + k + length / 2] * w;
+						values[start + k] = u + v;
+						values[start + k + length / 2] = u - v;
+					}
+				}
 			}
+			if (inverse)
+				for (auto& value : values)
+					value /= static_cast<double>(n);
 		}
+
+		struct AddNKey {
+			std::vector<double> pmf;
+			int64_t min;
+			int64_t k;
+			bool operator==(const AddNKey&) const = default;
+		};
+		struct AddNKeyHash {
+			size_t operator()(const AddNKey& key) const
+			{
+				size_t hash = std::hash<int64_t>{}(key.min) ^ (std::hash<int64_t>{}(key.k) << 1);
+				for (double p : key.pmf)
+					hash = hash * 1099511628211ull ^ std::hash<double>{}(p);
+				return hash;
+			}
+		};
+		//process-wide, as MDPs with the same parameters are often constructed many times (e.g. in parameter sweeps):
+		std::mutex add_n_cache_mutex;
+		std::unordered_map<AddNKey, DiscreteDist, AddNKeyHash> add_n_cache;
+		constexpr size_t max_add_n_cache_size = 4096;
+	}
+
+	std::vector<double> DiscreteDist::Convolve(const std::vector<double>& first, const std::vector<double>& second)
+	{
+		size_t result_size = first.size() + second.size() - 1;
+		std::vector<double> result(result_size, 0.0);
+		//direct convolution is exact and faster for small supports:
+		if (std::min(first.size(), second.size()) < 64)
+		{
+			for (size_t i = 0; i < first.size(); i++)
+				for (size_t j = 0; j < second.size(); j++)
+					result[i + j] += first[i] * second[j];
+			return result;
+		}
+		size_t n = 1;
+		while (n < result_size)
+			n <<= 1;
+		std::vector<std::complex<double>> a(first.begin(), first.end()), b(second.begin(), second.end());
+		a.resize(n);
+		b.resize(n);
+		FFT(a, false);
+		FFT(b, false);
+		for (size_t i = 0; i < n; i++)
+			a[i] *= b[i];
+		FFT(a, true);
+		//values at the level of rounding errors are set to zero, such that they can be trimmed:
+		double peak = 0.0;
+		for (size_t i = 0; i < result_size; i++)
+			peak = std::max(peak, a[i].real());
+		double noise = peak * 1e-15;
+		for (size_t i = 0; i < result_size; i++)
+			result[i] = a[i].real() > noise ? a[i].real() : 0.0;
+		return result;
+	}
+
+	DiscreteDist DiscreteDist::Add(const DiscreteDist& other) const
+	{
+		int64_t minResult = this->min + other.min;
+		std::vector<double> PMFResult = Convolve(translatedPMF, other.translatedPMF);
 		Trim(PMFResult, minResult);
 		return DiscreteDist(PMFResult, minResult);
 	}
+
+	DiscreteDist DiscreteDist::AddN(int64_t k) const
+	{
+		if (k < 0)
+			throw DynaPlex::Error("DiscreteDist::AddN - k should be non-negative.");
+		if (k <= 1)
+			return k == 0 ? GetZeroDist() : *this;
+		AddNKey key{ translatedPMF, min, k };
+		{
+			std::lock_guard<std::mutex> lock(add_n_cache_mutex);
+			auto it = add_n_cache.find(key);
+			if (it != add_n_cache.end())
+				return it->second;
+		}
+		auto result = AddNUncached(k);
+		std::lock_guard<std::mutex> lock(add_n_cache_mutex);
+		if (add_n_cache.size() >= max_add_n_cache_size)
+			add_n_cache.clear();
+		add_n_cache.emplace(std::move(key), result);
+		return result;
+	}
+
+	DiscreteDist DiscreteDist::AddNUncached(int64_t k) const
+	{//repeated squaring:
+		DiscreteDist result = GetZeroDist();
+		DiscreteDist power = *this;
+		bool first = true;
+		while (k > 0)
+		{
+			if (k & 1)
+			{
+				result = first ? power : result.Add(power);
+				first = false;
+			}
+			k >>= 1;
+			if (k > 0)
+				power = power.Add(power);
+		}
+		return result;
+	}
 	DiscreteDist DiscreteDist::TakeMaximumWith(int64_t value) const
 	{
 		int64_t max = Max();
@@ -497,11 +621,54 @@ namespace DynaPlex
 	DiscreteDist::DiscreteDist(std::vector<double>&& TranslatedProbMF, int64_t offSet)
 		: translatedPMF(std::move(TranslatedProbMF)), min(offSet)
 	{
+		BuildAliasTable();
 	}
 
 	DiscreteDist::DiscreteDist(const std::vector<double>& TranslatedProbMF, int64_t offSet)
 		: translatedPMF(TranslatedProbMF), min(offSet)
 	{
+		BuildAliasTable();
+	}
+
+	void DiscreteDist::BuildAliasTable()
+	{//Vose's method: columns with less than average mass are topped up with mass of a single column with more than average mass. 
+		size_t n = translatedPMF.size();
+		double total = 0.0;
+		for (double p : translatedPMF)
+			total += p;
+		aliasProb.assign(n, 1.0);
+		alias.resize(n);
+		std::vector<size_t> small, large;
+		small.reserve(n);
+		large.reserve(n);
+		//the cumulative pmf serves inverse cdf sampling and GetConditionalSample:
+		cumulativePMF.resize(n);
+		std::partial_sum(translatedPMF.begin(), translatedPMF.end(), cumulativePMF.begin());
+		std::vector<double> scaled(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			alias[i] = static_cast<int64_t>(i);
+			scaled[i] = translatedPMF[i] * static_cast<double>(n) / total;
+			if (scaled[i] < 1.0)
+				small.push_back(i);
+			else
+				large.push_back(i);
+		}
+		while (!small.empty() && !large.empty())
+		{
+			size_t less = small.back();
+			small.pop_back();
+			size_t more = large.back();
+			aliasProb[less] = scaled[less];
+			alias[less] = static_cast<int64_t>(more);
+			scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+			if (scaled[more] < 1.0)
+			{
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+		//remaining columns are full up to rounding errors, and keep aliasProb 1.0.
 	}
 
 	DiscreteDist DiscreteDist::GetConstantDist(int64_t constant)
@@ -764,41 +931,64 @@ namespace DynaPlex
 	}
 
 	void DiscreteDist::OptimizeForSampling() {
-		//if (translatedPMF.size() > 9)
-		{
-			cumulativePMF.reserve(translatedPMF.size());
-			double sum = 0.0;
-			for (const auto& p : translatedPMF) {
-				sum += p;
-				cumulativePMF.push_back(sum);
-			}
-			optimizedForSampling = true;
-		}
+		//the cumulative pmf is built on construction, see BuildAliasTable.
+		optimizedForSampling = true;
 	}
 
-	int64_t DiscreteDist::GetSample(DynaPlex::RNG& rng) const {
-		// Generate a uniform random number between 0 and 1
-		double randomValue = rng.genUniform();
+	int64_t DiscreteDist::InverseCDF(double u) const {
+		auto it = std::upper_bound(cumulativePMF.begin(), cumulativePMF.end(), u * cumulativePMF.back());
+		size_t index = std::min(static_cast<size_t>(std::distance(cumulativePMF.begin(), it)), cumulativePMF.size() - 1);
+		return min + static_cast<int64_t>(index);
+	}
 
-		if (optimizedForSampling) {
-			// Use binary search on the cumulativePMF
-			auto it = std::lower_bound(cumulativePMF.begin(), cumulativePMF.end(), randomValue);
-			size_t index = std::distance(cumulativePMF.begin(), it);
+	int64_t DiscreteDist::GetSample(DynaPlex::RNG& rng) const {
+		if (rng.IsMonotone())
+			return InverseCDF(rng.genUniform());
+		//a single uniform selects the column (integer part) and decides between the column and its alias (fractional part):
+		double scaled = rng.genUniform() * static_cast<double>(aliasProb.size());
+		size_t index = std::min(static_cast<size_t>(scaled), aliasProb.size() - 1);
+		double fraction = scaled - static_cast<double>(index);
+		if (fraction < aliasProb[index])
 			return min + static_cast<int64_t>(index);
+		return min + alias[index];
+	}
+
+	void DiscreteDist::GetSamples(DynaPlex::RNG& rng, std::span<int64_t> samples) const {
+		if (rng.IsMonotone())
+		{
+			for (auto& sample : samples)
+				sample = InverseCDF(rng.genUniform());
+			return;
 		}
-		else {
-			double cumulativeProbability = 0.0;
-			for (size_t i = 0; i < translatedPMF.size(); i++) {
-				cumulativeProbability += translatedPMF[i];
-				if (randomValue < cumulativeProbability) {
-					return min + static_cast<int64_t>(i);
-				}
-			}
-			// This should technically never be reached if probabilities sum to 1, 
-			// but it handles potential numerical inaccuracies.
-			return Max();
+		double n = static_cast<double>(aliasProb.size());
+		size_t last = aliasProb.size() - 1;
+		for (auto& sample : samples)
+		{
+			double scaled = rng.genUniform() * n;
+			size_t index = std::min(static_cast<size_t>(scaled), last);
+			sample = min + (scaled - static_cast<double>(index) < aliasProb[index] ? static_cast<int64_t>(index) : alias[index]);
 		}
 	}
 
-
-}
\ No newline at end of file
+	void DiscreteDist::GetSamples(std::span<DynaPlex::RNG*> rngs, std::span<int64_t> samples) const {
+		if (rngs.size() != samples.size())
+		{
+			throw DynaPlex::Error("DiscreteDist::GetSamples - number of rngs differs from number of samples.");
+		}
+		//a single pass, drawing each uniform and looking it up directly, such that no scratch memory is needed:
+		double n = static_cast<double>(aliasProb.size());
+		size_t last = aliasProb.size() - 1;
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			DynaPlex::RNG& rng = *rngs[i];
+			if (rng.IsMonotone())
+			{
+				samples[i] = InverseCDF(rng.genUniform());
+				continue;
+			}
+			double scaled = rng.genUniform() * n;
+			size_t index = std::min(static_cast<size_t>(scaled), last);
+			samples[i] = min + (scaled - static_cast<double>(index) < aliasProb[index] ? static_cast<int64_t>(index) : alias[index]);
+		}
+	}
+}
@@ -6,20 +6,15 @@ namespace DynaPlex
 {
 
 	int64_t JointDiscreteDist::DistinctValueCount() const {
-		return static_cast<int64_t>( translatedPMF.size());
+		return GetSupport().positions.DistinctValueCount();
 	}
 
 	std::vector<JointDiscreteDist::QtyProb> JointDiscreteDist::QuantityProbabilities() const {
-		std::vector<JointDiscreteDist::QtyProb> quantityProbabilities;
-		quantityProbabilities.reserve(DistinctValueCount());
-		for (auto qtyprob : *this)
-		{
-			quantityProbabilities.push_back(qtyprob);
-		}
-		return quantityProbabilities;
+		return GetSupport().positions.QuantityProbabilities();
 	}
 
-	JointDiscreteDist::JointDiscreteDist() : JointQtys({ { 0, 0 } }), translatedPMF({ 1.0 })
+	JointDiscreteDist::JointDiscreteDist() 
+		: JointDiscreteDist(DiscreteDist::GetZeroDist(), DiscreteDist::GetZeroDist())
 	{
 	}
 
@@ -27,7 +22,7 @@ namespace DynaPlex
 		: dist_(dist), index_(index) {}
 
 	JointDiscreteDist::QtyProb JointDiscreteDist::Iterator::operator*() const {
-		return { static_cast<int64_t>(index_), dist_.translatedPMF[index_] };
+		return { static_cast<int64_t>(index_), dist_.ProbabilityAt(static_cast<int64_t>(index_)) };
 	}
 
 	JointDiscreteDist::Iterator& JointDiscreteDist::Iterator::operator++() {
@@ -54,7 +49,11 @@ namespace DynaPlex
 	}
 
 	JointDiscreteDist::Iterator JointDiscreteDist::end() const {
-		return Iterator(*this, translatedPMF.size());
+		return Iterator(*this, static_cast<std::size_t>(DistinctValueCount()));
+	}
+
+	bool JointDiscreteDist::operator==(const JointDiscreteDist& other) const {
+		return components == other.components;
 	}
 
 	JointDiscreteDist::JointDiscreteDist(const DiscreteDist& dist1, const DiscreteDist& dist2)
@@ -62,138 +61,134 @@ namespace DynaPlex
 	}
 
 	JointDiscreteDist::JointDiscreteDist(const std::vector<DynaPlex::DiscreteDist>& distributions)
+		: components(distributions), lazy(std::make_shared<LazySupport>())
 	{
 		if (distributions.size() < 2) {
 			throw DynaPlex::Error("JointDiscretDist: provide at least two discrete distibutions to create a joint distribution.");
 		}
-
-		std::vector<double> probVec;
-		std::vector<std::vector<int64_t>> Qtys;
-		GetJointDistribution(distributions, 0, Qtys, probVec, {}, 1.0);
-
-		if (!IsProbMassFunction(probVec))
-		{
-			throw DynaPlex::Error("JointDiscretDist: Probabilities should be nonnegative and sum to 1.0");
-		}
-
-		*this = JointDiscreteDist(std::move(probVec), std::move(Qtys));
 	}
 
-	void JointDiscreteDist::GetJointDistribution(const std::vector<DynaPlex::DiscreteDist>& distributions,
-		size_t currentDistIndex,
-		std::vector<std::vector<int64_t>>& Qtys,
-		std::vector<double>& probVec,
-		std::vector<int64_t> currentQtys,
-		double currentProb) {
-
-		if (currentDistIndex == distributions.size()) {
-			// Base case: all distributions processed
-			if (currentProb > epsilon) {
-				Qtys.push_back(currentQtys);
-				probVec.push_back(currentProb);
-			}
-			return;
-		}
-
-		for (const auto& [qty, prob] : distributions[currentDistIndex]) {
-			std::vector<int64_t> newQtys = currentQtys;
-			newQtys.push_back(qty);
-			double newProb = currentProb * prob;
-			GetJointDistribution(distributions, currentDistIndex + 1, Qtys, probVec, newQtys, newProb);
-		}
+	const JointDiscreteDist::Support& JointDiscreteDist::GetSupport() const {
+		std::call_once(lazy->flag, [this]() { lazy->support = EnumerateSupport(components); });
+		return lazy->support;
 	}
 
-	bool JointDiscreteDist::IsProbMassFunction(const std::vector<double>& PMF)
-	{
-		auto copy = PMF;
-		//Sorts in ascending order for numerical stability.
-		std::sort(copy.begin(), copy.end());
-		if (copy[0] < 0.0)
-		{//negative probabilities are not allowed.
-			return false;
-		}
-		double TotalProb = 0.0;
-		for (const auto& d : copy)
+	JointDiscreteDist::Support JointDiscreteDist::EnumerateSupport(const std::vector<DynaPlex::DiscreteDist>& components) {
+		size_t n = components.size();
+		Support support;
+		std::vector<double> probVec;
+		//odometer over the component supports, the last component running fastest:
+		std::vector<int64_t> current(n);
+		for (size_t i = 0; i < n; i++)
+			current[i] = components[i].Min();
+		while (true)
 		{
-			TotalProb += d;
+			double prob = 1.0;
+			for (size_t i = 0; i < n; i++)
+				prob *= components[i].ProbabilityAt(current[i]);
+			if (prob > epsilon)
+			{
+				support.qtys.insert(support.qtys.end(), current.begin(), current.end());
+				probVec.push_back(prob);
+			}
+			size_t i = n;
+			while (i > 0 && current[i - 1] == components[i - 1].Max())
+			{
+				current[i - 1] = components[i - 1].Min();
+				i--;
+			}
+			if (i == 0)
+				break;
+			current[i - 1]++;
 		}
-		return std::abs(TotalProb - 1.0) < 1e-8;
-	}
-
-	JointDiscreteDist::JointDiscreteDist(std::vector<double>&& TranslatedProbMF, std::vector<std::vector<int64_t>>&& JointQtys)
-		: translatedPMF(std::move(TranslatedProbMF)), JointQtys(std::move(JointQtys))
-	{
-	}
-
-	JointDiscreteDist::JointDiscreteDist(const std::vector<double>& TranslatedProbMF, const std::vector<std::vector<int64_t>>& JointQtys)
-		: translatedPMF(TranslatedProbMF), JointQtys(JointQtys)
-	{
+		support.positions = DiscreteDist::GetCustomDist(std::move(probVec), 0);
+		return support;
 	}
 
 	double JointDiscreteDist::ProbabilityAt(int64_t value) const
 	{
-		if (value < 0 || value > Max())
-		{
-			return 0.0;
-		}
-		return translatedPMF[value];
+		return GetSupport().positions.ProbabilityAt(value);
 	}
 
 	int64_t JointDiscreteDist::GetSample(DynaPlex::RNG& rng) const {
-		// Generate a uniform random number between 0 and 1
-		double randomValue = rng.genUniform();
-		double cumulativeProbability = 0.0;
-		for (size_t i = 0; i < translatedPMF.size(); i++) {
-			cumulativeProbability += translatedPMF[i];
-			if (randomValue < cumulativeProbability) {
-				return static_cast<int64_t>(i);
-			}
-		}
-
-		// This should technically never be reached if probabilities sum to 1, 
-		// but it handles potential numerical inaccuracies.
-		return Max();
+		return GetSupport().positions.GetSample(rng);
 	}
 
 	std::vector<int64_t> JointDiscreteDist::GetSampleQtys(DynaPlex::RNG& rng) const {
-		// Generate a uniform random number between 0 and 1
-		double randomValue = rng.genUniform();
-		double cumulativeProbability = 0.0;
-		for (size_t i = 0; i < translatedPMF.size(); i++) {
-			cumulativeProbability += translatedPMF[i];
-			if (randomValue < cumulativeProbability) {
-				return GetQtysForJointDist(static_cast<int64_t>(i));
-			}
-		}
+		std::vector<int64_t> qtys(components.size());
+		GetSampleQtys(rng, qtys);
+		return qtys;
+	}
 
-		// This should technically never be reached if probabilities sum to 1, 
-		// but it handles potential numerical inaccuracies.
-		return GetQtysForJointDist(Max());
+	void JointDiscreteDist::GetSampleQtys(DynaPlex::RNG& rng, std::span<int64_t> qtys) const {
+		if (qtys.size() != components.size())
+		{
+			throw DynaPlex::Error("JointDiscreteDist::GetSampleQtys - size of qtys differs from number of components.");
+		}
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			qtys[i] = components[i].GetSample(rng);
+		}
 	}
 
 	std::vector<int64_t> JointDiscreteDist::GetQtysForJointDist(int64_t pos) const {
-		if (pos >= JointQtys.size() || pos < 0)
+		const auto& support = GetSupport();
+		if (pos >= DistinctValueCount() || pos < 0)
 		{
 			throw DynaPlex::Error("JointDiscreteDist: vector length error for JointQty.");
 		}
-		return JointQtys[pos];
+		auto first = support.qtys.begin() + pos * static_cast<int64_t>(components.size());
+		return std::vector<int64_t>(first, first + components.size());
 	}
 
-	int64_t JointDiscreteDist::FindPositionInJointQtys(const std::vector<int64_t> qty) const {
-		for (int64_t i = 0; i < JointQtys.size(); ++i) {
-			if (JointQtys[i] == qty) {
-				return i;  // Return the index if found
+	int64_t JointDiscreteDist::FindPositionInJointQtys(const std::vector<int64_t>& qty) const {
+		if (qty.size() == components.size())
+		{
+			const auto& support = GetSupport();
+			//the support is in lexicographic order, so binary search:
+			int64_t stride = static_cast<int64_t>(components.size());
+			int64_t low = 0, high = DistinctValueCount();
+			while (low < high)
+			{
+				int64_t mid = low + (high - low) / 2;
+				auto first = support.qtys.begin() + mid * stride;
+				if (std::lexicographical_compare(first, first + stride, qty.begin(), qty.end()))
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			if (low < DistinctValueCount() && std::equal(qty.begin(), qty.end(), support.qtys.begin() + low * stride))
+			{
+				return low;
 			}
 		}
-
 		// Throw an exception if the element is not found
 		throw DynaPlex::Error("JointDiscreteDist: joint quantities not found in JointQtys.");
 	}
 
-	double JointDiscreteDist::ProbabilityAtFromQtys(const std::vector<int64_t> qty) const
+	double JointDiscreteDist::ProbabilityAtFromQtys(const std::vector<int64_t>& qty) const
+	{
+		if (qty.size() != components.size())
+		{
+			throw DynaPlex::Error("JointDiscreteDist::ProbabilityAtFromQtys - size of qty differs from number of components.");
+		}
+		double prob = 1.0;
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			prob *= components[i].ProbabilityAt(qty[i]);
+		}
+		return prob;
+	}
+
+	std::vector<std::vector<int64_t>> JointDiscreteDist::GetJointQtys() const
 	{
-		int64_t pos = FindPositionInJointQtys(qty);
-		return translatedPMF[pos];
+		std::vector<std::vector<int64_t>> jointQtys;
+		jointQtys.reserve(static_cast<size_t>(DistinctValueCount()));
+		for (int64_t pos = 0; pos < DistinctValueCount(); pos++)
+		{
+			jointQtys.push_back(GetQtysForJointDist(pos));
+		}
+		return jointQtys;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #include "mdp.h"
 #include "dynaplex/erasure/mdpregistrar.h"
 #include "policies.h"
+#include <algorithm>
+#include <cmath>
 
 namespace DynaPlex::Models {
 	namespace lost_sales /*keep this in line with id below and with namespace name in header*/
@@ -44,6 +46,7 @@ namespace DynaPlex::Models {
 			config.Get("leadtime", leadtime);
 			config.Get("demand_dist",demand_dist);
 			demand_dist.OptimizeForSampling();
+			mean_demand = demand_dist.Expectation();
 			//providing discount_factor is optional. 
 			if (config.HasKey("discount_factor"))
 				config.Get("discount_factor", discount_factor);
@@ -52,11 +55,7 @@ namespace DynaPlex::Models {
 			
 
 			//Initiate members that are computed from the parameters:
-			auto DemOverLeadtime = DiscreteDist::GetZeroDist();
-			for (size_t i = 0; i <= leadtime; i++)
-			{
-				DemOverLeadtime = DemOverLeadtime.Add(demand_dist);
-			}
+			auto DemOverLeadtime = demand_dist.AddN(leadtime + 1);
 			MaxOrderSize = demand_dist.Fractile(p / (p + h));
 			MaxSystemInv = DemOverLeadtime.Fractile(p / (p + h));
 
@@ -68,6 +67,168 @@ namespace DynaPlex::Models {
 			return demand_dist.GetSample(rng);
 		}
 
+		void MDP::GetEvents(std::span<RNG*> rngs, std::span<Event> events) const {
+			demand_dist.GetSamples(rngs, events);
+		}
+
+		double MDP::ControlVariate(const Event& event) const {
+			return static_cast<double>(event) - mean_demand;
+		}
+
+
+		bool MDP::ProvidesPolicyFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const {
+			std::string id;
+			policy_config.GetOrDefault("id", id, std::string{});
+			return id == "base_stock" && parameter == "base_stock_level";
+		}
+
+		void MDP::EvolvePolicyFamily(const State& state, DynaPlex::RNG& rng, const DynaPlex::VarGroup& policy_config, const std::string& parameter,
+			std::span<const double> values, int64_t warmup_periods, int64_t periods, std::span<double> returns) const
+		{
+			if (!ProvidesPolicyFamily(policy_config, parameter))
+				throw DynaPlex::Error("Lost Sales: policy family only available for base_stock_level of base_stock");
+			//the K copies of the state are evolved as lanes of a batch state:
+			const size_t K = values.size();
+			std::vector<int64_t> levels(K), actions(K);
+			for (size_t k = 0; k < K; k++)
+			{
+				levels[k] = static_cast<int64_t>(std::llround(values[k]));
+				if (static_cast<double>(levels[k]) != values[k])
+					throw DynaPlex::Error("Lost Sales: base_stock_level should be integer, got " + std::to_string(values[k]));
+			}
+			std::vector<const State*> copies(K, &state);
+			BatchState batch{};
+			GetBatchState(copies, batch);
+			std::vector<Event> events(K);
+			std::vector<double> costs(K), cumulative(K, 0.0);
+			double discount = 1.0;
+			if (warmup_periods == 0)
+				std::fill(returns.begin(), returns.end(), 0.0);
+			for (int64_t period = 0; period < warmup_periods + periods; period++)
+			{
+				BaseStockPolicy::GetActions(*this, batch.total_inv, levels, actions);
+				ModifyStatesWithActions(batch, actions, costs);
+				for (size_t k = 0; k < K; k++)
+					cumulative[k] += costs[k] * discount;
+				discount *= discount_factor;
+				//a single event for all lanes:
+				std::fill(events.begin(), events.end(), GetEvent(rng));
+				ModifyStatesWithEvents(batch, events, costs);
+				for (size_t k = 0; k < K; k++)
+					cumulative[k] += costs[k] * discount;
+				//returns temporarily holds the cumulative return at the end of the warm-up:
+				if (period + 1 == warmup_periods)
+					std::copy(cumulative.begin(), cumulative.end(), returns.begin());
+			}
+			for (size_t k = 0; k < K; k++)
+				returns[k] = cumulative[k] - returns[k];
+		}
+
+		void MDP::GetBatchState(std::span<const State* const> states, BatchState& batch) const
+		{
+			if (states.empty())
+				throw DynaPlex::Error("Lost Sales: GetBatchState requires at least one state.");
+			const size_t K = states.size();
+			const size_t slots = static_cast<size_t>(leadtime) + 1;
+			batch.cat = states.front()->cat;
+			batch.lanes = K;
+			batch.pipeline.assign(slots * K, 0);
+			batch.head = 0;
+			batch.total_inv.assign(K, 0);
+			//the pipeline holds leadtime orders when awaiting an action, and leadtime+1 after the order is placed:
+			const size_t length = batch.cat.IsAwaitEvent() ? slots : slots - 1;
+			for (size_t k = 0; k < K; k++)
+			{
+				const State& state = *states[k];
+				size_t slot = 0;
+				auto it = state.state_vector.begin();
+				for (; it != state.state_vector.end() && slot < slots; ++it, ++slot)
+					batch.pipeline[slot * K + k] = *it;
+				if (state.cat != batch.cat || slot != length || it != state.state_vector.end())
+					throw DynaPlex::Error("Lost Sales: states in a batch should have the same category, and a pipeline of length consistent with the leadtime.");
+				batch.total_inv[k] = state.total_inv;
+			}
+		}
+
+		void MDP::UpdateStates(const BatchState& batch, std::span<State* const> states) const
+		{
+			const size_t K = batch.lanes;
+			const size_t slots = static_cast<size_t>(leadtime) + 1;
+			const size_t length = batch.cat.IsAwaitEvent() ? slots : slots - 1;
+			for (size_t k = 0; k < K; k++)
+			{
+				State& state = *states[k];
+				state.cat = batch.cat;
+				state.state_vector.clear();
+				state.state_vector.reserve(slots);
+				for (size_t i = 0; i < length; i++)
+					state.state_vector.push_back(batch.pipeline[((batch.head + i) % slots) * K + k]);
+				state.total_inv = batch.total_inv[k];
+			}
+		}
+
+		DynaPlex::StateCategory MDP::GetStateCategory(const BatchState& batch) const
+		{
+			return batch.cat;
+		}
+
+		//arithmetic of the kernels is exactly as in ModifyStateWithAction / ModifyStateWithEvent, such that results equal those of separate simulation.
+		void MDP::ModifyStatesWithActions(BatchState& batch, std::span<const int64_t> actions, std::span<double> costs) const
+		{
+			const size_t K = batch.lanes;
+			const size_t slots = static_cast<size_t>(leadtime) + 1;
+			int64_t* __restrict tail = batch.pipeline.data() + ((batch.head + slots - 1) % slots) * K;
+			int64_t* __restrict total = batch.total_inv.data();
+			for (size_t k = 0; k < K; k++)
+			{
+				if (!((total[k] + actions[k] <= MaxSystemInv && actions[k] <= MaxOrderSize) || actions[k] == 0))
+					throw DynaPlex::Error("Lost Sales: action not allowed: state.total_inv: " + std::to_string(total[k]) + "  action: " + std::to_string(actions[k]) + "  MaxSystemInv: " + std::to_string(MaxSystemInv) + " MaxOrderSize " + std::to_string(MaxOrderSize));
+				tail[k] = actions[k];
+				total[k] += actions[k];
+				costs[k] = 0.0;
+			}
+			batch.cat = StateCategory::AwaitEvent();
+		}
+
+		void MDP::ModifyStatesWithEvents(BatchState& batch, std::span<const Event> events, std::span<double> costs) const
+		{
+			const size_t K = batch.lanes;
+			const size_t slots = static_cast<size_t>(leadtime) + 1;
+			int64_t* __restrict front = batch.pipeline.data() + batch.head * K;
+			batch.head = (batch.head + 1) % slots;
+			int64_t* __restrict next = batch.pipeline.data() + batch.head * K;
+			int64_t* __restrict total = batch.total_inv.data();
+			for (size_t k = 0; k < K; k++)
+			{
+				int64_t onHand = front[k];
+				int64_t event = events[k];
+				bool sufficient = onHand > event;
+				int64_t leftover = sufficient ? onHand - event : 0;
+				total[k] -= sufficient ? event : onHand;
+				next[k] += leftover;
+				costs[k] = sufficient ? leftover * h : (event - onHand) * p;
+			}
+			batch.cat = StateCategory::AwaitAction();
+		}
+
+		bool MDP::ProvidesBatchPolicy(const DynaPlex::VarGroup& policy_config) const {
+			std::string id;
+			policy_config.GetOrDefault("id", id, std::string{});
+			return id == "base_stock";
+		}
+
+		MDP::BatchPolicy MDP::GetBatchPolicy(const DynaPlex::VarGroup& policy_config) const {
+			if (!ProvidesBatchPolicy(policy_config))
+				throw DynaPlex::Error("Lost Sales: batch evolution only available for base_stock");
+			BatchPolicy policy{};
+			//same default as BaseStockPolicy:
+			policy_config.GetOrDefault("base_stock_level", policy.base_stock_level, MaxSystemInv);
+			return policy;
+		}
+
+		void MDP::GetBatchActions(const BatchState& batch, const BatchPolicy& policy, std::span<int64_t> actions) const {
+			BaseStockPolicy::GetActions(*this, batch.total_inv, policy.base_stock_level, actions);
+		}
 
 		std::vector<std::tuple<MDP::Event, double>> MDP::EventProbabilities() const {
 			return demand_dist.QuantityProbabilities();
@@ -119,7 +280,7 @@ namespace DynaPlex::Models {
 
 		MDP::State MDP::GetInitialState() const
 		{
-			auto queue = Queue<int64_t>{};
+			auto queue = Queue<int64_t, 16>{};
 			queue.reserve(leadtime + 1);
 			queue.push_back(0);//<- initial on-hand
 			for (size_t i = 0; i < leadtime - 1; i++)
@@ -142,6 +303,16 @@ namespace DynaPlex::Models {
 			vars.Get("total_inv", state.total_inv);
 			return state;
 		}
+		void MDP::Serialize(const State& state, DynaPlex::ByteSink& sink) const
+		{
+			sink.Write(state.cat, state.state_vector, state.total_inv);
+		}
+		MDP::State MDP::Deserialize(DynaPlex::ByteSource& source) const
+		{
+			State state{};
+			source.Read(state.cat, state.state_vector, state.total_inv);
+			return state;
+		}
 		DynaPlex::VarGroup MDP::State::ToVarGroup() const
 		{
 			DynaPlex::VarGroup vars;
@@ -20,6 +20,7 @@ namespace DynaPlex::Models {
 			int64_t MaxOrderSize;
 			int64_t MaxSystemInv;
 			DynaPlex::DiscreteDist demand_dist;
+			double mean_demand;
 
 			//A state is a struct (or class) that represents state information for the MDP:
 			struct State {
@@ -30,7 +31,8 @@ namespace DynaPlex::Models {
 				DynaPlex::StateCategory cat;
 
 				//Other members depend on the MDP:
-				Queue<int64_t> state_vector;
+				//stored inline for typical pipeline lengths, such that cloning states does not allocate:
+				Queue<int64_t, 16> state_vector;
 				int64_t total_inv;
 
 				//declaration; for definition see mdp.cpp:
@@ -52,6 +54,35 @@ namespace DynaPlex::Models {
 			double ModifyStateWithAction(State&, int64_t action) const;
 			double ModifyStateWithEvent(State&, const Event&) const;
 			Event GetEvent(DynaPlex::RNG&) const;
+			//Optional: draws events for several trajectories at once, one per rng; used when they all await the same event stream.
+			void GetEvents(std::span<DynaPlex::RNG*>, std::span<Event>) const;
+			//Optional: zero-mean quantity used by PolicyComparer for variance reduction. 
+			double ControlVariate(const Event&) const;
+			//Optional: lock-step simulation of base_stock policies that differ only in base_stock_level, see PolicyComparer::CompareFamily.
+			bool ProvidesPolicyFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const;
+			void EvolvePolicyFamily(const State&, DynaPlex::RNG&, const DynaPlex::VarGroup& policy_config, const std::string& parameter,
+				std::span<const double> values, int64_t warmup_periods, int64_t periods, std::span<double> returns) const;
+			//Optional: several states (lanes) in structure-of-arrays form, evolved in lock-step, see MDPInterface::EvolveBatch.
+			struct BatchState {
+				DynaPlex::StateCategory cat = DynaPlex::StateCategory::AwaitEvent();
+				size_t lanes{ 0 };
+				//ring of leadtime+1 slots of lanes each; slot head holds the on-hand inventory.
+				std::vector<int64_t> pipeline;
+				size_t head{ 0 };
+				std::vector<int64_t> total_inv;
+			};
+			struct BatchPolicy {
+				int64_t base_stock_level;
+			};
+			//fills the batch state, reusing its storage:
+			void GetBatchState(std::span<const State* const>, BatchState&) const;
+			void UpdateStates(const BatchState&, std::span<State* const>) const;
+			DynaPlex::StateCategory GetStateCategory(const BatchState&) const;
+			void ModifyStatesWithActions(BatchState&, std::span<const int64_t> actions, std::span<double> costs) const;
+			void ModifyStatesWithEvents(BatchState&, std::span<const Event> events, std::span<double> costs) const;
+			bool ProvidesBatchPolicy(const DynaPlex::VarGroup& policy_config) const;
+			BatchPolicy GetBatchPolicy(const DynaPlex::VarGroup& policy_config) const;
+			void GetBatchActions(const BatchState&, const BatchPolicy&, std::span<int64_t> actions) const;
 			std::vector<std::tuple<Event, double>> EventProbabilities() const;
 			DynaPlex::VarGroup GetStaticInfo() const;
 			DynaPlex::StateCategory GetStateCategory(const State&) const;
@@ -59,6 +90,9 @@ namespace DynaPlex::Models {
 			//You may also define this with a parameter DynaPlex::RNG&, for random initial states:
 			State GetInitialState() const;
 			State GetState(const VarGroup&) const;
+			//Optional: compact binary codec for states, see MDPInterface::SerializeStates.
+			void Serialize(const State&, DynaPlex::ByteSink&) const;
+			State Deserialize(DynaPlex::ByteSource&) const;
 			void GetFeatures(const State&, DynaPlex::Features&) const;
 			//Enables all MDPs to be constructed in a uniform manner. 
 			explicit MDP(const DynaPlex::VarGroup&);
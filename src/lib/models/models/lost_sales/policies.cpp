@@ -23,5 +23,25 @@ namespace DynaPlex::Models {
 			return action;
 		}
 
+		void BaseStockPolicy::GetActions(const MDP& mdp, std::span<const int64_t> total_inv, std::span<const int64_t> base_stock_levels, std::span<int64_t> actions)
+		{
+			const int64_t max_order_size = mdp.MaxOrderSize;
+			for (size_t k = 0; k < actions.size(); k++)
+			{
+				int64_t action = base_stock_levels[k] - total_inv[k];
+				actions[k] = action > max_order_size ? max_order_size : action;
+			}
+		}
+
+		void BaseStockPolicy::GetActions(const MDP& mdp, std::span<const int64_t> total_inv, int64_t base_stock_level, std::span<int64_t> actions)
+		{
+			const int64_t max_order_size = mdp.MaxOrderSize;
+			for (size_t k = 0; k < actions.size(); k++)
+			{
+				int64_t action = base_stock_level - total_inv[k];
+				actions[k] = action > max_order_size ? max_order_size : action;
+			}
+		}
+
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "mdp.h"
 #include "dynaplex/vargroup.h"
 #include <memory>
+#include <span>
 
 namespace DynaPlex::Models {
 	namespace lost_sales /*must be consistent everywhere for complete mdp defininition and associated policies.*/
@@ -19,6 +20,10 @@ namespace DynaPlex::Models {
 		public:
 			BaseStockPolicy(std::shared_ptr<const MDP> mdp, const VarGroup& config);
 			int64_t GetAction(const MDP::State& state) const;
+			//Batched version for a family of base-stock levels, one per lane: 
+			static void GetActions(const MDP& mdp, std::span<const int64_t> total_inv, std::span<const int64_t> base_stock_levels, std::span<int64_t> actions);
+			//Batched version for a single base-stock level:
+			static void GetActions(const MDP& mdp, std::span<const int64_t> total_inv, int64_t base_stock_level, std::span<int64_t> actions);
 		};
 
 	}
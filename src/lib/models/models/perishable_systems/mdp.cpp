@@ -74,12 +74,7 @@ namespace DynaPlex::Models {
 				lifo_demand_dist = DiscreteDist::GetZeroDist();
 			}
 
-			auto DemOverLeadtime = DiscreteDist::GetZeroDist();
-			for (size_t i = 0; i <= LeadTime + ProductLife; i++)
-			{
-				DemOverLeadtime = DemOverLeadtime.Add(fifo_demand_dist);
-				DemOverLeadtime = DemOverLeadtime.Add(lifo_demand_dist);
-			}
+			auto DemOverLeadtime = fifo_demand_dist.Add(lifo_demand_dist).AddN(LeadTime + ProductLife + 1);
 			MaxSystemInv = DemOverLeadtime.Fractile(p / (p + o));
 
 			// also possible to use this
@@ -87,15 +82,14 @@ namespace DynaPlex::Models {
 			//demand_dist = JointDiscreteDist(dist);
 
 			demand_dist = JointDiscreteDist(fifo_demand_dist, lifo_demand_dist);
-			demand_combination_holder = demand_dist.GetJointQtys();
 		}
 
 		MDP::Event MDP::GetEvent(RNG& rng) const {
-			return demand_dist.GetSample(rng);
+			return demand_dist.GetSampleTuple<2>(rng);
 		}
 
 		std::vector<std::tuple<MDP::Event, double>> MDP::EventProbabilities() const {
-			return demand_dist.QuantityProbabilities();
+			return demand_dist.TupleProbabilities<2>();
 		}
 
 		double MDP::ModifyStateWithEvent(State& state, const MDP::Event& event) const
@@ -103,8 +97,7 @@ namespace DynaPlex::Models {
 			state.cat = StateCategory::AwaitAction();
 
 			int64_t onHand = state.state_vector.at(ProductLife - 1);			
-			int64_t FIFOdemand = demand_combination_holder[event][0];
-			int64_t LIFOdemand = demand_combination_holder[event][1];
+			auto [FIFOdemand, LIFOdemand] = event;
 			int64_t TotalDemand = FIFOdemand + LIFOdemand;
 
 			double cost{ 0.0 };
@@ -188,7 +181,7 @@ namespace DynaPlex::Models {
 
 		MDP::State MDP::GetInitialState() const
 		{
-			auto queue = Queue<int64_t>{};
+			auto queue = Queue<int64_t, 16>{};
 
 			queue.reserve(LeadTime + ProductLife);
 			for (size_t i = 0; i < LeadTime + ProductLife - 1; i++)
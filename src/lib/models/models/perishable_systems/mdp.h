@@ -4,6 +4,7 @@
 #include "dynaplex/modelling/jointdiscretedist.h"
 #include "dynaplex/modelling/queue.h"
 #include <map>
+#include <array>
 
 namespace DynaPlex::Models {
 	namespace perishable_systems /*must be consistent everywhere for complete mdp definition and associated policies and states.*/
@@ -23,8 +24,8 @@ namespace DynaPlex::Models {
 			double f, mu, cvr; //issuance policy ratio, mean demand, square root of variance over mean
 
 			int64_t MaxSystemInv;
+			//joint distribution of FIFO and LIFO demand:
 			DynaPlex::JointDiscreteDist demand_dist;
-			std::vector<std::vector<int64_t>> demand_combination_holder;
 
 			//A state is a struct (or class) that represents state information for the MDP:
 			struct State {
@@ -35,14 +36,16 @@ namespace DynaPlex::Models {
 				DynaPlex::StateCategory cat;
 
 				//Other members depend on the MDP:
-				Queue<int64_t> state_vector;
+				//stored inline for typical pipeline lengths, such that cloning states does not allocate:
+				Queue<int64_t, 16> state_vector;
 
 				//declaration; for definition see mdp.cpp:
 				DynaPlex::VarGroup ToVarGroup() const;
 				bool operator==(const State& other) const = default;
 			};
 
-			using Event = int64_t;
+			//FIFO and LIFO demand:
+			using Event = std::array<int64_t, 2>;
 
 			//Remainder of the DynaPlex API:
 			double ModifyStateWithAction(State&, int64_t action) const;
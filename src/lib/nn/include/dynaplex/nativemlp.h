@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace DynaPlex::NN
+{
+	/**
+	 * Inference engine for the multi-layer perceptrons provided by NeuralNetworkProvider (type "mlp") that does
+	 * not depend on libtorch. Layers are Linear layers with ReLU activation on all but the last layer.
+	 * Forward passes use cache-blocked kernels with fused bias and activation, which are written such that the
+	 * compiler can vectorize the innermost loop. Quantized networks use AVX512-VNNI (int8) or AVX512-BF16 (bf16) dot-product
+	 * kernels, selected at run time if the cpu provides them; otherwise, they use the float32 kernels on dequantized weights.
+	 */
+	class NativeMLP
+	{
+	public:
+		/// precision of the weights used in Forward. Quantized kernels also round the inputs of each layer to the precision,
+		/// and accumulate in float32 (bf16) or int32 (int8); outputs of each layer are float32. 
+		enum class Precision {
+			Float32,
+			BFloat16,
+			/// symmetric int8 quantization of weights with a scale per output channel; inputs of each layer are quantized
+			/// to uint8 with a scale per row. 
+			Int8
+		};
+		/// "float32", "bf16" or "int8".
+		static Precision PrecisionFromString(const std::string&);
+		static std::string ToString(Precision);
+		/// whether this cpu provides the instructions for the quantized kernels of the precision; always true for Float32.
+		static bool HasQuantizedKernels(Precision);
+
+		struct Layer {
+			int64_t num_inputs;
+			int64_t num_outputs;
+			/// num_inputs x num_outputs, row-major; i.e. transposed with respect to torch::nn::Linear::weight. For quantized networks,
+			/// the dequantized weights if the cpu lacks the quantized kernels, and empty otherwise. 
+			std::vector<float> weights;
+			std::vector<float> bias;
+			/// quantized weights in the layout of the dot-product instructions: for each output, groups of consecutive inputs (pairs
+			/// for bf16, quadruples for int8) are adjacent, and outputs are padded to a multiple of 16. Only filled if weights is empty. 
+			std::vector<uint16_t> weights_bf16{};
+			std::vector<int8_t> weights_int8{};
+			/// per output channel, such that weights ~ weights_int8 * scales. 
+			std::vector<float> scales{};
+			/// per (padded) output channel, the sum of weights_int8 over the inputs; corrects for the zero point of quantized inputs.
+			std::vector<int32_t> column_sums{};
+		};
+
+		NativeMLP() = default;
+
+		/// adds a layer, with weights given in the layout of torch::nn::Linear, i.e. num_outputs x num_inputs, row-major.
+		void AddLayer(int64_t num_inputs, int64_t num_outputs, std::span<const float> weights, std::span<const float> bias);
+
+		int64_t NumInputs() const;
+		int64_t NumOutputs() const;
+		const std::vector<Layer>& Layers() const;
+
+		/// returns a copy of this network that uses weights of the given precision in Forward. Only the quantized weights are
+		/// retained, so SaveToFile of the copy writes the dequantized weights. 
+		NativeMLP Quantized(Precision) const;
+		Precision GetPrecision() const;
+
+		/// computes outputs (batch_size x NumOutputs()) for inputs (batch_size x NumInputs()), both row-major.
+		void Forward(std::span<const float> inputs, int64_t batch_size, std::span<float> outputs) const;
+
+		/// saves weights in a flat binary format; weights are written in the layout of torch::nn::Linear.
+		void SaveToFile(const std::string& path) const;
+		static NativeMLP LoadFromFile(const std::string& path);
+
+	private:
+		std::vector<Layer> layers;
+		Precision precision{ Precision::Float32 };
+	};
+}//namespace DynaPlex::NN
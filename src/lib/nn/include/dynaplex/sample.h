@@ -26,7 +26,8 @@ namespace DynaPlex::NN
 
 
 
-        DynaPlex::VarGroup ToVarGroup() const;
+        /// include_state may be false if the state is stored separately, e.g. using MDPInterface::SerializeStates.
+        DynaPlex::VarGroup ToVarGroup(bool include_state = true) const;
 
         DynaPlex::VarGroup ToVarGroupWithFeats(DynaPlex::MDP mdp) const;
     };
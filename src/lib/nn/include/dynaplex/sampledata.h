@@ -12,8 +12,14 @@ namespace DynaPlex::NN
 	public:
 		std::vector<DynaPlex::NN::Sample> Samples;
 		SampleData(DynaPlex::MDP);
+		/**
+		 * Saves the samples to path. If the mdp provides a binary codec for states (see MDPInterface::ProvidesStateSerialization), 
+		 * states are stored in binary form in a separate file, path + ".states". 
+		 */
 		void SaveToFile(DynaPlex::MDP, std::string path, int64_t json_indent=-1, bool silent=true);
 		static SampleData CreateNewFromFile(DynaPlex::MDP, std::string path);
+		/// removes the samples saved to path with SaveToFile, including the file with binary states, if any. 
+		static void RemoveFiles(const std::string& path);
 		void AddFromFile(DynaPlex::MDP, std::string path);
 		void PrintStatistics();
 	};
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "dynaplex/mdp.h"
+#include "dynaplex/sampledata.h"
 
 namespace DynaPlex {	
 
@@ -12,6 +13,11 @@ namespace DynaPlex {
 		static DynaPlex::Policy LoadPolicy(DynaPlex::MDP mdp, std::string path_to_policy_without_extension);
 		//Attempts to save the policy, assuming it is a neural network policy trained in c++. 
 		static void SavePolicy(DynaPlex::Policy, std::string path_to_policy_without_extension);
+		//Returns a copy of a neural network policy with mlp architecture that evaluates using weights quantized to precision ("bf16" or "int8").
+		//Arg-max decisions of the quantized and the original policy are compared for the states in validation_data, and the fraction of
+		//agreeing decisions is stored as "quantization_agreement" in the config of the returned policy. The precision is stored as
+		//"quantization", such that it is reapplied by LoadPolicy after saving. 
+		static DynaPlex::Policy QuantizePolicy(DynaPlex::Policy, const std::string& precision, const DynaPlex::NN::SampleData& validation_data);
 	};
 
 }//namespace DynaPlex
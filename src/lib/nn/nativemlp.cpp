@@ -0,0 +1,543 @@
+#include "dynaplex/nativemlp.h"
+#include "dynaplex/error.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <bit>
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define DP_NATIVEMLP_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace DynaPlex::NN
+{
+	namespace {
+		constexpr char file_tag[8] = { 'D','P','M','L','P','0','0','1' };
+
+		//block sizes: a block of weights (block_k x block_n floats) is 128KB, such that it remains in L2 cache
+		//while it is applied to all rows of the current row block.
+		constexpr int64_t block_m = 8;
+		constexpr int64_t block_n = 256;
+		constexpr int64_t block_k = 128;
+		//number of outputs per 512-bit register in the quantized kernels; outputs of quantized weights are padded to a multiple of this:
+		constexpr int64_t lanes = 16;
+
+		int64_t round_up(int64_t value, int64_t multiple)
+		{
+			return (value + multiple - 1) / multiple * multiple;
+		}
+
+		//bfloat16 are the upper 16 bits of a float32:
+		inline float to_float(uint16_t w) { return std::bit_cast<float>(static_cast<uint32_t>(w) << 16); }
+
+		uint16_t to_bfloat16(float value)
+		{//round to nearest even
+			uint32_t bits = std::bit_cast<uint32_t>(value);
+			uint32_t rounding = 0x7FFF + ((bits >> 16) & 1);
+			return static_cast<uint16_t>((bits + rounding) >> 16);
+		}
+
+		/// position of weight (in, out) in quantized weights with group_size consecutive inputs adjacent, and padded_outputs outputs.
+		size_t packed_index(int64_t in, int64_t out, int64_t group_size, int64_t padded_outputs)
+		{
+			return static_cast<size_t>(((in / group_size) * padded_outputs + out) * group_size + in % group_size);
+		}
+
+		/// weights of the layer in float32, num_inputs x num_outputs row-major; dequantizes if only quantized weights are stored. 
+		std::vector<float> float_weights(const NativeMLP::Layer& layer)
+		{
+			if (!layer.weights.empty())
+				return layer.weights;
+			int64_t padded_outputs = round_up(layer.num_outputs, lanes);
+			std::vector<float> weights(layer.num_inputs * layer.num_outputs);
+			for (int64_t in = 0; in < layer.num_inputs; in++)
+				for (int64_t out = 0; out < layer.num_outputs; out++)
+				{
+					if (!layer.weights_int8.empty())
+						weights[in * layer.num_outputs + out] = layer.weights_int8[packed_index(in, out, 4, padded_outputs)] * layer.scales[out];
+					else
+						weights[in * layer.num_outputs + out] = to_float(layer.weights_bf16[packed_index(in, out, 2, padded_outputs)]);
+				}
+			return weights;
+		}
+
+		/// Y = X * W + b, optionally followed by ReLU. X is m x k, W is k x n, Y is m x n, all row-major.
+		void gemm_bias_activation(const float* __restrict X, const float* __restrict W, const float* __restrict b,
+			float* __restrict Y, int64_t m, int64_t k, int64_t n, bool relu)
+		{
+			for (int64_t m0 = 0; m0 < m; m0 += block_m)
+			{
+				int64_t m1 = std::min(m0 + block_m, m);
+				for (int64_t n0 = 0; n0 < n; n0 += block_n)
+				{
+					int64_t nb = std::min(block_n, n - n0);
+					for (int64_t row = m0; row < m1; row++)
+						std::fill_n(Y + row * n + n0, nb, 0.0f);
+
+					for (int64_t k0 = 0; k0 < k; k0 += block_k)
+					{
+						int64_t k1 = std::min(k0 + block_k, k);
+						for (int64_t row = m0; row < m1; row++)
+						{
+							float* __restrict y = Y + row * n + n0;
+							const float* x = X + row * k;
+							for (int64_t inner = k0; inner < k1; inner++)
+							{
+								const float xv = x[inner];
+								const float* __restrict w = W + inner * n + n0;
+								for (int64_t col = 0; col < nb; col++)
+									y[col] += xv * w[col];
+							}
+						}
+					}
+					//epilogue: bias and activation
+					for (int64_t row = m0; row < m1; row++)
+					{
+						float* __restrict y = Y + row * n + n0;
+						const float* __restrict bias = b + n0;
+						for (int64_t col = 0; col < nb; col++)
+							y[col] += bias[col];
+						if (relu)
+						{
+							for (int64_t col = 0; col < nb; col++)
+								y[col] = std::max(y[col], 0.0f);
+						}
+					}
+				}
+			}
+		}
+
+		/// quantizes each row of X (m x k) to uint8, with a scale per row and a zero point of 0 for non-negative rows (e.g. after
+		/// ReLU) and 128 otherwise. Rows of Xq are padded to length round_up(k, 4). 
+		void quantize_rows(const float* X, int64_t m, int64_t k, uint8_t* Xq, float* row_scales, int32_t* zero_points)
+		{
+			int64_t padded = round_up(k, 4);
+			for (int64_t row = 0; row < m; row++)
+			{
+				const float* __restrict x = X + row * k;
+				float lo = 0.0f, hi = 0.0f;
+				for (int64_t i = 0; i < k; i++)
+				{
+					lo = std::min(lo, x[i]);
+					hi = std::max(hi, x[i]);
+				}
+				int32_t zero = lo < 0.0f ? 128 : 0;
+				float range = zero ? std::max(hi, -lo) / 127.0f : hi / 255.0f;
+				float scale = range > 0.0f ? range : 1.0f;
+				//after the shift by the zero point the values are non-negative, so truncation after adding 0.5 rounds:
+				float offset = static_cast<float>(zero) + 0.5f;
+				float inverse = 1.0f / scale;
+				uint8_t* __restrict xq = Xq + row * padded;
+				for (int64_t i = 0; i < k; i++)
+					xq[i] = static_cast<uint8_t>(std::clamp(x[i] * inverse + offset, 0.0f, 255.0f));
+				std::fill(xq + k, xq + padded, static_cast<uint8_t>(zero));
+				row_scales[row] = scale;
+				zero_points[row] = zero;
+			}
+		}
+
+#ifdef DP_NATIVEMLP_X86_KERNELS
+		//the kernels below are compiled for AVX512 regardless of build flags, and only called if the cpu supports them.
+
+		bool cpu_has_vnni()
+		{
+			static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vnni");
+			return supported;
+		}
+
+		bool cpu_has_bf16()
+		{
+			static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bf16");
+			return supported;
+		}
+
+		__attribute__((target("avx512f")))
+		inline __mmask16 tail_mask(int64_t remaining)
+		{
+			return remaining >= lanes ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+		}
+
+		/// R rows of Y = dequantize(Xq * W) + b, optionally followed by ReLU, where products of uint8 inputs and int8 weights
+		/// are accumulated in int32 by vpdpbusd, four inputs at a time. 
+		template<int R>
+		__attribute__((target("avx512f,avx512vnni")))
+		void int8_rows(const uint8_t* Xq, int64_t padded_inputs, const float* row_scales, const int32_t* zero_points,
+			const NativeMLP::Layer& layer, float* Y, bool relu)
+		{
+			const int64_t n = layer.num_outputs;
+			const int64_t padded_outputs = round_up(n, lanes);
+			const int8_t* W = layer.weights_int8.data();
+			for (int64_t c0 = 0; c0 < padded_outputs; c0 += lanes)
+			{
+				__m512i acc[R];
+				for (int r = 0; r < R; r++)
+					acc[r] = _mm512_setzero_si512();
+				for (int64_t k0 = 0; k0 < padded_inputs; k0 += 4)
+				{
+					__m512i w = _mm512_loadu_si512(W + k0 * padded_outputs + c0 * 4);
+					for (int r = 0; r < R; r++)
+					{
+						int32_t quad;
+						std::memcpy(&quad, Xq + r * padded_inputs + k0, sizeof(quad));
+						acc[r] = _mm512_dpbusd_epi32(acc[r], _mm512_set1_epi32(quad), w);
+					}
+				}
+				//epilogue: zero point correction, scaling, bias and activation
+				__mmask16 mask = tail_mask(n - c0);
+				__m512i sums = _mm512_loadu_si512(layer.column_sums.data() + c0);
+				__m512 scales = _mm512_maskz_loadu_ps(mask, layer.scales.data() + c0);
+				__m512 bias = _mm512_maskz_loadu_ps(mask, layer.bias.data() + c0);
+				for (int r = 0; r < R; r++)
+				{
+					__m512i corrected = _mm512_sub_epi32(acc[r], _mm512_mullo_epi32(_mm512_set1_epi32(zero_points[r]), sums));
+					__m512 y = _mm512_fmadd_ps(_mm512_cvtepi32_ps(corrected), _mm512_mul_ps(scales, _mm512_set1_ps(row_scales[r])), bias);
+					if (relu)
+						y = _mm512_max_ps(y, _mm512_setzero_ps());
+					_mm512_mask_storeu_ps(Y + r * n + c0, mask, y);
+				}
+			}
+		}
+
+		__attribute__((target("avx512f,avx512vnni")))
+		void gemm_int8(const uint8_t* Xq, const float* row_scales, const int32_t* zero_points, const NativeMLP::Layer& layer,
+			float* Y, int64_t m, bool relu)
+		{
+			const int64_t padded_inputs = round_up(layer.num_inputs, 4);
+			const int64_t n = layer.num_outputs;
+			int64_t row = 0;
+			for (; row + 8 <= m; row += 8)
+				int8_rows<8>(Xq + row * padded_inputs, padded_inputs, row_scales + row, zero_points + row, layer, Y + row * n, relu);
+			for (; row + 4 <= m; row += 4)
+				int8_rows<4>(Xq + row * padded_inputs, padded_inputs, row_scales + row, zero_points + row, layer, Y + row * n, relu);
+			for (; row < m; row++)
+				int8_rows<1>(Xq + row * padded_inputs, padded_inputs, row_scales + row, zero_points + row, layer, Y + row * n, relu);
+		}
+
+		/// R rows of Y = Xb * W + b, optionally followed by ReLU, where products of bf16 inputs and weights are accumulated in
+		/// float32 by vdpbf16ps, two inputs at a time. 
+		template<int R>
+		__attribute__((target("avx512f,avx512bf16")))
+		void bf16_rows(const uint16_t* Xb, int64_t padded_inputs, const NativeMLP::Layer& layer, float* Y, bool relu)
+		{
+			const int64_t n = layer.num_outputs;
+			const int64_t padded_outputs = round_up(n, lanes);
+			const uint16_t* W = layer.weights_bf16.data();
+			for (int64_t c0 = 0; c0 < padded_outputs; c0 += lanes)
+			{
+				__m512 acc[R];
+				for (int r = 0; r < R; r++)
+					acc[r] = _mm512_setzero_ps();
+				for (int64_t k0 = 0; k0 < padded_inputs; k0 += 2)
+				{
+					__m512i w = _mm512_loadu_si512(W + k0 * padded_outputs + c0 * 2);
+					for (int r = 0; r < R; r++)
+					{
+						int32_t pair;
+						std::memcpy(&pair, Xb + r * padded_inputs + k0, sizeof(pair));
+						acc[r] = _mm512_dpbf16_ps(acc[r], (__m512bh)_mm512_set1_epi32(pair), (__m512bh)w);
+					}
+				}
+				//epilogue: bias and activation
+				__mmask16 mask = tail_mask(n - c0);
+				__m512 bias = _mm512_maskz_loadu_ps(mask, layer.bias.data() + c0);
+				for (int r = 0; r < R; r++)
+				{
+					__m512 y = _mm512_add_ps(acc[r], bias);
+					if (relu)
+						y = _mm512_max_ps(y, _mm512_setzero_ps());
+					_mm512_mask_storeu_ps(Y + r * n + c0, mask, y);
+				}
+			}
+		}
+
+		__attribute__((target("avx512f,avx512bf16")))
+		void gemm_bf16(const uint16_t* Xb, const NativeMLP::Layer& layer, float* Y, int64_t m, bool relu)
+		{
+			const int64_t padded_inputs = round_up(layer.num_inputs, 2);
+			const int64_t n = layer.num_outputs;
+			int64_t row = 0;
+			for (; row + 8 <= m; row += 8)
+				bf16_rows<8>(Xb + row * padded_inputs, padded_inputs, layer, Y + row * n, relu);
+			for (; row + 4 <= m; row += 4)
+				bf16_rows<4>(Xb + row * padded_inputs, padded_inputs, layer, Y + row * n, relu);
+			for (; row < m; row++)
+				bf16_rows<1>(Xb + row * padded_inputs, padded_inputs, layer, Y + row * n, relu);
+		}
+#else
+		bool cpu_has_vnni() { return false; }
+		bool cpu_has_bf16() { return false; }
+#endif
+	}
+
+	NativeMLP::Precision NativeMLP::PrecisionFromString(const std::string& precision)
+	{
+		if (precision == "float32")
+			return Precision::Float32;
+		if (precision == "bf16")
+			return Precision::BFloat16;
+		if (precision == "int8")
+			return Precision::Int8;
+		throw DynaPlex::Error("NativeMLP::PrecisionFromString - unknown precision \"" + precision + "\". Supported are \"float32\", \"bf16\" and \"int8\".");
+	}
+
+	std::string NativeMLP::ToString(Precision precision)
+	{
+		switch (precision)
+		{
+		case Precision::Float32:
+			return "float32";
+		case Precision::BFloat16:
+			return "bf16";
+		case Precision::Int8:
+			return "int8";
+		}
+		throw DynaPlex::Error("NativeMLP::ToString - unknown precision.");
+	}
+
+	bool NativeMLP::HasQuantizedKernels(Precision precision)
+	{
+		switch (precision)
+		{
+		case Precision::Float32:
+			return true;
+		case Precision::BFloat16:
+			return cpu_has_bf16();
+		case Precision::Int8:
+			return cpu_has_vnni();
+		}
+		return false;
+	}
+
+	void NativeMLP::AddLayer(int64_t num_inputs, int64_t num_outputs, std::span<const float> weights, std::span<const float> bias)
+	{
+		if (num_inputs <= 0 || num_outputs <= 0)
+			throw DynaPlex::Error("NativeMLP::AddLayer - layer dimensions must be positive.");
+		if (weights.size() != static_cast<size_t>(num_inputs * num_outputs) || bias.size() != static_cast<size_t>(num_outputs))
+			throw DynaPlex::Error("NativeMLP::AddLayer - size of weights or bias does not match layer dimensions.");
+		if (!layers.empty() && layers.back().num_outputs != num_inputs)
+			throw DynaPlex::Error("NativeMLP::AddLayer - num_inputs " + std::to_string(num_inputs) + " does not match num_outputs of previous layer " + std::to_string(layers.back().num_outputs) + ".");
+
+		Layer layer{ num_inputs, num_outputs, std::vector<float>(num_inputs * num_outputs), std::vector<float>(bias.begin(), bias.end()) };
+		for (int64_t out = 0; out < num_outputs; out++)
+			for (int64_t in = 0; in < num_inputs; in++)
+				layer.weights[in * num_outputs + out] = weights[out * num_inputs + in];
+		layers.push_back(std::move(layer));
+	}
+
+	int64_t NativeMLP::NumInputs() const
+	{
+		if (layers.empty())
+			throw DynaPlex::Error("NativeMLP::NumInputs - network has no layers.");
+		return layers.front().num_inputs;
+	}
+
+	int64_t NativeMLP::NumOutputs() const
+	{
+		if (layers.empty())
+			throw DynaPlex::Error("NativeMLP::NumOutputs - network has no layers.");
+		return layers.back().num_outputs;
+	}
+
+	const std::vector<NativeMLP::Layer>& NativeMLP::Layers() const
+	{
+		return layers;
+	}
+
+	NativeMLP NativeMLP::Quantized(Precision target) const
+	{
+		NativeMLP network;
+		network.precision = target;
+		//without quantized kernels, the float32 kernels are used on the dequantized weights:
+		bool packed = HasQuantizedKernels(target);
+		for (const auto& source : layers)
+		{
+			Layer layer{ source.num_inputs, source.num_outputs, float_weights(source), source.bias };
+			int64_t padded_outputs = round_up(layer.num_outputs, lanes);
+			if (target == Precision::BFloat16)
+			{
+				if (packed)
+				{
+					layer.weights_bf16.assign(round_up(layer.num_inputs, 2) * padded_outputs, 0);
+					for (int64_t in = 0; in < layer.num_inputs; in++)
+						for (int64_t out = 0; out < layer.num_outputs; out++)
+							layer.weights_bf16[packed_index(in, out, 2, padded_outputs)] = to_bfloat16(layer.weights[in * layer.num_outputs + out]);
+					layer.weights.clear();
+				}
+				else
+				{
+					for (auto& weight : layer.weights)
+						weight = to_float(to_bfloat16(weight));
+				}
+			}
+			else if (target == Precision::Int8)
+			{
+				std::vector<float> scales(layer.num_outputs, 0.0f);
+				for (int64_t in = 0; in < layer.num_inputs; in++)
+					for (int64_t out = 0; out < layer.num_outputs; out++)
+						scales[out] = std::max(scales[out], std::abs(layer.weights[in * layer.num_outputs + out]));
+				for (auto& scale : scales)
+					scale = (scale > 0.0f) ? scale / 127.0f : 1.0f;
+				if (packed)
+				{
+					layer.weights_int8.assign(round_up(layer.num_inputs, 4) * padded_outputs, 0);
+					layer.column_sums.assign(padded_outputs, 0);
+				}
+				for (int64_t in = 0; in < layer.num_inputs; in++)
+					for (int64_t out = 0; out < layer.num_outputs; out++)
+					{
+						float& weight = layer.weights[in * layer.num_outputs + out];
+						auto quantized = static_cast<int8_t>(std::clamp(std::round(weight / scales[out]), -127.0f, 127.0f));
+						if (packed)
+						{
+							layer.weights_int8[packed_index(in, out, 4, padded_outputs)] = quantized;
+							layer.column_sums[out] += quantized;
+						}
+						else
+							weight = quantized * scales[out];
+					}
+				if (packed)
+				{
+					layer.scales = std::move(scales);
+					layer.weights.clear();
+				}
+			}
+			layer.weights.shrink_to_fit();
+			network.layers.push_back(std::move(layer));
+		}
+		return network;
+	}
+
+	NativeMLP::Precision NativeMLP::GetPrecision() const
+	{
+		return precision;
+	}
+
+	void NativeMLP::Forward(std::span<const float> inputs, int64_t batch_size, std::span<float> outputs) const
+	{
+		if (inputs.size() != static_cast<size_t>(batch_size * NumInputs()) || outputs.size() != static_cast<size_t>(batch_size * NumOutputs()))
+			throw DynaPlex::Error("NativeMLP::Forward - size of inputs or outputs does not match batch_size and network dimensions.");
+
+		//intermediate activations and quantized inputs; grown as needed and reused for subsequent calls on the same thread.
+		thread_local std::vector<float> buffers[2];
+#ifdef DP_NATIVEMLP_X86_KERNELS
+		thread_local std::vector<uint8_t> int8_inputs;
+		thread_local std::vector<uint16_t> bf16_inputs;
+		thread_local std::vector<float> row_scales;
+		thread_local std::vector<int32_t> zero_points;
+#endif
+
+		const float* current = inputs.data();
+		for (size_t i = 0; i < layers.size(); i++)
+		{
+			const auto& layer = layers[i];
+			bool last = (i + 1 == layers.size());
+			float* target;
+			if (last)
+				target = outputs.data();
+			else
+			{
+				auto& buffer = buffers[i % 2];
+				if (buffer.size() < static_cast<size_t>(batch_size * layer.num_outputs))
+					buffer.resize(batch_size * layer.num_outputs);
+				target = buffer.data();
+			}
+#ifdef DP_NATIVEMLP_X86_KERNELS
+			if (!layer.weights_int8.empty())
+			{
+				size_t size = static_cast<size_t>(batch_size * round_up(layer.num_inputs, 4));
+				if (int8_inputs.size() < size)
+					int8_inputs.resize(size);
+				if (row_scales.size() < static_cast<size_t>(batch_size))
+				{
+					row_scales.resize(batch_size);
+					zero_points.resize(batch_size);
+				}
+				quantize_rows(current, batch_size, layer.num_inputs, int8_inputs.data(), row_scales.data(), zero_points.data());
+				gemm_int8(int8_inputs.data(), row_scales.data(), zero_points.data(), layer, target, batch_size, !last);
+			}
+			else if (!layer.weights_bf16.empty())
+			{
+				int64_t padded_inputs = round_up(layer.num_inputs, 2);
+				size_t size = static_cast<size_t>(batch_size * padded_inputs);
+				if (bf16_inputs.size() < size)
+					bf16_inputs.resize(size);
+				for (int64_t row = 0; row < batch_size; row++)
+				{
+					uint16_t* xb = bf16_inputs.data() + row * padded_inputs;
+					std::transform(current + row * layer.num_inputs, current + (row + 1) * layer.num_inputs, xb, to_bfloat16);
+					std::fill(xb + layer.num_inputs, xb + padded_inputs, uint16_t{ 0 });
+				}
+				gemm_bf16(bf16_inputs.data(), layer, target, batch_size, !last);
+			}
+			else
+#endif
+				gemm_bias_activation(current, layer.weights.data(), layer.bias.data(), target, batch_size, layer.num_inputs, layer.num_outputs, !last);
+			current = target;
+		}
+	}
+
+	void NativeMLP::SaveToFile(const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+			throw DynaPlex::Error("NativeMLP::SaveToFile - unable to open file for writing: " + path);
+
+		auto write_int = [&](int64_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+		file.write(file_tag, sizeof(file_tag));
+		write_int(static_cast<int64_t>(layers.size()));
+		std::vector<float> weights;
+		for (const auto& layer : layers)
+		{
+			write_int(layer.num_inputs);
+			write_int(layer.num_outputs);
+			auto layer_weights = float_weights(layer);
+			weights.resize(layer_weights.size());
+			for (int64_t out = 0; out < layer.num_outputs; out++)
+				for (int64_t in = 0; in < layer.num_inputs; in++)
+					weights[out * layer.num_inputs + in] = layer_weights[in * layer.num_outputs + out];
+			file.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(float));
+			file.write(reinterpret_cast<const char*>(layer.bias.data()), layer.bias.size() * sizeof(float));
+		}
+		if (!file)
+			throw DynaPlex::Error("NativeMLP::SaveToFile - error while writing file: " + path);
+	}
+
+	NativeMLP NativeMLP::LoadFromFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw DynaPlex::Error("NativeMLP::LoadFromFile - unable to open file: " + path);
+
+		char tag[sizeof(file_tag)];
+		file.read(tag, sizeof(tag));
+		if (!file || !std::equal(std::begin(tag), std::end(tag), std::begin(file_tag)))
+			throw DynaPlex::Error("NativeMLP::LoadFromFile - file is not a native mlp weight file: " + path);
+
+		auto read_int = [&]() {
+			int64_t value{};
+			file.read(reinterpret_cast<char*>(&value), sizeof(value));
+			return value;
+		};
+		NativeMLP network;
+		int64_t num_layers = read_int();
+		if (!file || num_layers <= 0)
+			throw DynaPlex::Error("NativeMLP::LoadFromFile - invalid number of layers in file: " + path);
+		std::vector<float> weights, bias;
+		for (int64_t i = 0; i < num_layers; i++)
+		{
+			int64_t num_inputs = read_int();
+			int64_t num_outputs = read_int();
+			if (!file || num_inputs <= 0 || num_outputs <= 0)
+				throw DynaPlex::Error("NativeMLP::LoadFromFile - invalid layer dimensions in file: " + path);
+			weights.resize(num_inputs * num_outputs);
+			bias.resize(num_outputs);
+			file.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(float));
+			file.read(reinterpret_cast<char*>(bias.data()), bias.size() * sizeof(float));
+			if (!file)
+				throw DynaPlex::Error("NativeMLP::LoadFromFile - unexpected end of file: " + path);
+			network.AddLayer(num_inputs, num_outputs, weights, bias);
+		}
+		return network;
+	}
+}//namespace DynaPlex::NN
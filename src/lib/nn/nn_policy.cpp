@@ -1,10 +1,27 @@
 #include "nn_policy.h"
 #include "dynaplex/system.h"
+#include "dynaplex/parallel_execute.h"
 #if DP_TORCH_AVAILABLE
 #include <torch/torch.h>
 #endif
 namespace DynaPlex {
 
+#if DP_TORCH_AVAILABLE
+	namespace {
+		/// returns a {rows, cols} view on buffer, which is (re)allocated only when its capacity is insufficient. 
+		torch::Tensor GetBufferView(torch::Tensor& buffer, int64_t rows, int64_t cols, torch::ScalarType type)
+		{
+			int64_t required = rows * cols;
+			if (!buffer.defined() || buffer.numel() < required)
+			{
+				int64_t capacity = buffer.defined() ? std::max(required, 2 * buffer.numel()) : required;
+				buffer = torch::empty({ capacity }, type);
+			}
+			return buffer.narrow(0, 0, required).view({ rows, cols });
+		}
+	}
+#endif
+
 	NN_Policy::NN_Policy(DynaPlex::MDP mdp)
 		: mdp(mdp) {
 
@@ -19,15 +36,40 @@ namespace DynaPlex {
 	}
 
 	void NN_Policy::SetAction(std::span<Trajectory> trajectories) const {
-#if DP_TORCH_AVAILABLE
 		int64_t input_dim = mdp->NumFlatFeatures();
 		int64_t output_dim = mdp->NumValidActions();
+		int64_t batch_size = static_cast<int64_t>(trajectories.size());
+		if (native_network)
+		{
+			//reused over calls on the same thread; resizing within capacity does not allocate.
+			thread_local std::vector<float> inputs, outputs;
+			inputs.resize(batch_size * input_dim);
+			outputs.resize(batch_size * output_dim);
+			mdp->GetFlatFeatures(trajectories, inputs);
+			native_network->Forward(inputs, batch_size, outputs);
+			mdp->SetArgMaxAction(trajectories, outputs);
+			return;
+		}
+#if DP_TORCH_AVAILABLE
+		//Buffers are kept per thread and reused over calls, such that inference does not allocate in steady state.
+		//Buffers are not tied to a specific policy; their capacity is grown as needed. 
+		thread_local torch::Tensor input_buffer, mask_buffer;
+		thread_local torch::Dict<std::string, torch::Tensor> dict;
+
 		// Convert trajectories into a tensor for the neural network.
-		torch::Tensor batched_inputs = torch::empty({ static_cast<int64_t>(trajectories.size()), input_dim }, torch::kFloat32);
-		float* input_data_ptr = batched_inputs.data_ptr<float>();
+		torch::Tensor batched_inputs = GetBufferView(input_buffer, batch_size, input_dim, torch::kFloat32);
+		mdp->GetFlatFeatures(trajectories, std::span<float>(batched_inputs.data_ptr<float>(), batch_size * input_dim));
 
-		mdp->GetFlatFeatures(trajectories, std::span<float>(input_data_ptr, trajectories.size() * input_dim));
 
+		//on worker threads of parallel rollouts, limit intra-op threads according to the threading policy of the system,
+		//to avoid oversubscription. Intra-op thread settings of torch apply to the calling thread. 
+		thread_local int64_t intra_op_threads = 0;
+		int64_t threads_per_worker = DynaPlex::Parallel::worker_threads_per_worker();
+		if (threads_per_worker > 0 && threads_per_worker != intra_op_threads)
+		{
+			torch::set_num_threads(static_cast<int>(threads_per_worker));
+			intra_op_threads = threads_per_worker;
+		}
 
 		torch::NoGradGuard no_grad;
 		torch::Tensor output_scores;
@@ -41,16 +83,16 @@ namespace DynaPlex {
 		case DynaPlex::NN_Policy::NetworkForwardType::TensorDict:
 		case DynaPlex::NN_Policy::NetworkForwardType::TensorDictMask:
 		{
-			torch::Dict<std::string, torch::Tensor> dict;
-			dict.reserve(1);
-			dict.insert("obs",std::move( batched_inputs));
+			dict.insert_or_assign("obs", batched_inputs);
 			if (fw_type == DynaPlex::NN_Policy::NetworkForwardType::TensorDictMask)
 			{
-				torch::Tensor batched_mask = torch::zeros({ static_cast<int64_t>(trajectories.size()), output_dim }, torch::kBool);
-				bool* mask_data_ptr = batched_mask.data_ptr<bool>();
-				mdp->GetMask(trajectories, std::span<bool>(mask_data_ptr, trajectories.size() * output_dim));
-				dict.insert("mask", std::move(batched_mask));
+				torch::Tensor batched_mask = GetBufferView(mask_buffer, batch_size, output_dim, torch::kBool);
+				batched_mask.zero_();
+				mdp->GetMask(trajectories, std::span<bool>(batched_mask.data_ptr<bool>(), batch_size * output_dim));
+				dict.insert_or_assign("mask", batched_mask);
 			}
+			else
+				dict.erase("mask");
 			output_scores = neural_network->forward(dict);
 		}
 		break;
@@ -63,7 +105,7 @@ namespace DynaPlex {
 
 
 		// Use MDP's SetArgMaxAction to determine the action based on the neural network's scores.
-		mdp->SetArgMaxAction(trajectories, std::span<float>(output_scores.data_ptr<float>(), trajectories.size() * output_dim));
+		mdp->SetArgMaxAction(trajectories, std::span<float>(output_scores.data_ptr<float>(), batch_size * output_dim));
 #else
 		throw DynaPlex::Error("NN_Policy: Torch not available - Cannot SetAction. To make torch available, set dynaplex_enable_pytorch to true and dynaplex_pytorch_path to an appropriate path, e.g. in CMakeUserPresets.txt. ");
 #endif
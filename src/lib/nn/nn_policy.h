@@ -2,6 +2,7 @@
 #include "dynaplex/mdp.h"
 #include "dynaplex/policy.h"
 #include "neuralnetworkprovider.h"
+#include "dynaplex/nativemlp.h"
 
 
 // Forward declarations
@@ -27,6 +28,8 @@ namespace DynaPlex {
         NetworkForwardType fw_type = NetworkForwardType::Tensor;
 
         DynaPlex::MDP mdp;
+        //if set, used for inference instead of neural_network; does not require torch. 
+        std::shared_ptr<const NN::NativeMLP> native_network;
 #if DP_TORCH_AVAILABLE
         std::unique_ptr<torch::nn::AnyModule> neural_network;
 #endif
@@ -6,6 +6,7 @@
 #include "dynaplex/trainedpolicyprovider.h"
 #include "neuralnetworkprovider.h"
 #include <algorithm>
+#include <numeric>
 
 namespace DynaPlex::NN {
 
@@ -28,24 +29,46 @@ namespace DynaPlex::NN {
 
     }
 #if DP_TORCH_AVAILABLE
-    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor> prepare_batch(const std::span<DynaPlex::NN::Sample> samples, const DynaPlex::MDP& mdp) {
-        int batch_size = samples.size();
-        int input_dim = mdp->NumFlatFeatures();
-        int output_dim = mdp->NumValidActions();
-
-        torch::Tensor batched_inputs = torch::empty({ batch_size, input_dim }, torch::kFloat32);
-        torch::Tensor batched_targets = torch::empty({ batch_size }, torch::kInt64);
-        torch::Tensor batched_probs = torch::full({ batch_size, output_dim }, .0f);
-        torch::Tensor batched_relative_costs = torch::full({ batch_size, output_dim }, 32.0f);
-        torch::Tensor mask = torch::full({ batch_size, output_dim }, 32.0f);
-
-        float* input_data_ptr = batched_inputs.data_ptr<float>();
-        int64_t* target_data_ptr = batched_targets.data_ptr<int64_t>();
-        float* mask_ptr = mask.data_ptr<float>();
-        float* cost_ptr = batched_relative_costs.data_ptr<float>();
-        float* probs_ptr = batched_probs.data_ptr<float>();
-
-        for (int idx = 0; idx < batch_size; idx++) {
+    /**
+     * Materializes inputs, targets, mask, probabilities and relative costs for all samples in one go, such that
+     * features and allowed actions are computed only once per dataset instead of once per mini-batch per epoch. 
+     * Mini-batches are subsequently obtained by gathering rows with index_select. When CUDA is available, the
+     * tensors are placed in pinned memory to allow asynchronous host-to-device copies.
+     */
+    struct SampleTensors {
+        torch::Tensor inputs;
+        torch::Tensor targets;
+        torch::Tensor mask;
+        torch::Tensor probs;
+        torch::Tensor relative_costs;
+
+        SampleTensors gather(const torch::Tensor& indices) const {
+            return { inputs.index_select(0, indices), targets.index_select(0, indices), mask.index_select(0, indices),
+                probs.index_select(0, indices), relative_costs.index_select(0, indices) };
+        }
+    };
+
+    SampleTensors prepare_tensors(const std::span<DynaPlex::NN::Sample> samples, const DynaPlex::MDP& mdp) {
+        int64_t num_samples = static_cast<int64_t>(samples.size());
+        int64_t input_dim = mdp->NumFlatFeatures();
+        int64_t output_dim = mdp->NumValidActions();
+
+        auto options = torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(torch::cuda::is_available());
+        SampleTensors tensors{
+            torch::empty({ num_samples, input_dim }, options),
+            torch::empty({ num_samples }, options.dtype(torch::kInt64)),
+            torch::full({ num_samples, output_dim }, 32.0f, options),
+            torch::full({ num_samples, output_dim }, .0f, options),
+            torch::full({ num_samples, output_dim }, 32.0f, options)
+        };
+
+        float* input_data_ptr = tensors.inputs.data_ptr<float>();
+        int64_t* target_data_ptr = tensors.targets.data_ptr<int64_t>();
+        float* mask_ptr = tensors.mask.data_ptr<float>();
+        float* probs_ptr = tensors.probs.data_ptr<float>();
+        float* cost_ptr = tensors.relative_costs.data_ptr<float>();
+
+        for (int64_t idx = 0; idx < num_samples; idx++) {
             const auto& sample = samples[idx];
 
             std::span<float> span(input_data_ptr + idx * input_dim, input_dim);
@@ -53,29 +76,25 @@ namespace DynaPlex::NN {
             target_data_ptr[idx] = sample.action_label;
 
             std::vector<int64_t> AllowedActions = mdp->AllowedActions(sample.state);
-            for (int64_t action : AllowedActions) {
-                mask_ptr[idx * output_dim + action] = 0.0f;
-                auto it = std::lower_bound(AllowedActions.begin(), AllowedActions.end(), action);
-                if (it != AllowedActions.end() && *it == action) {
-                    size_t index = it - AllowedActions.begin();
-                    cost_ptr[idx * output_dim + action] = sample.cost_improvement[index];
-                    probs_ptr[idx * output_dim + action] = sample.probabilities[index];
-                }
-                else {
-                    throw DynaPlex::Error("PolicyTrainer::prepare_batch - cannot find action index.");
-                }
+            bool has_costs = sample.cost_improvement.size() == AllowedActions.size();
+            bool has_probs = sample.probabilities.size() == AllowedActions.size();
+            if (!has_costs || !has_probs)
+                throw DynaPlex::Error("PolicyTrainer::prepare_tensors - number of allowed actions does not match sample statistics.");
+            //sample statistics are stored in the order of AllowedActions, so no lookup is needed:
+            for (size_t index = 0; index < AllowedActions.size(); index++) {
+                int64_t offset = idx * output_dim + AllowedActions[index];
+                mask_ptr[offset] = 0.0f;
+                cost_ptr[offset] = static_cast<float>(sample.cost_improvement[index]);
+                probs_ptr[offset] = static_cast<float>(sample.probabilities[index]);
             }
         }
 
-        return { batched_inputs, batched_targets, mask, batched_probs, batched_relative_costs };
+        return tensors;
     }
 #endif
     DynaPlex::Policy PolicyTrainer::LoadPolicy(DynaPlex::VarGroup nn_architecture, int64_t generation) {
-#if DP_TORCH_AVAILABLE
+        //mlp policies can be loaded without torch, see TrainedPolicyProvider::LoadPolicy.
         return TrainedPolicyProvider::LoadPolicy(mdp, PathToPolicy(nn_architecture, generation));
-#else
-        throw DynaPlex::Error("PolicyTrainer::LoadPolicy - Torch not available, cannot load policy. To make torch available, set dynaplex_enable_pytorch to true and dynaplex_pytorch_path to an appropriate path, e.g. in CMakeUserPresets.txt ");
-#endif
     }
     	
 	void PolicyTrainer::TrainPolicy(DynaPlex::VarGroup nn_architecture, int64_t generation, std::string path_to_sample_data, bool silent) {
@@ -109,7 +128,10 @@ namespace DynaPlex::NN {
         std::shuffle(data.Samples.begin(), data.Samples.end(), rng.gen());
         std::span<DynaPlex::NN::Sample> training_data(data.Samples.begin(), data.Samples.begin() + training_size);
         std::span<DynaPlex::NN::Sample> validation_data(data.Samples.begin() + training_size, data.Samples.end());
-        auto [validation_samples, validation_targets, validation_mask, validation_probs, validation_relative_costs] = prepare_batch(validation_data, mdp);
+        auto training_tensors = prepare_tensors(training_data, mdp);
+        auto [validation_samples, validation_targets, validation_mask, validation_probs, validation_relative_costs] = prepare_tensors(validation_data, mdp);
+        std::vector<int64_t> permutation(training_size);
+        std::iota(permutation.begin(), permutation.end(), 0);
 
         int64_t num_batches = training_size / mini_batch_size;
         float best_validation_loss = std::numeric_limits<float>::max();
@@ -123,11 +145,12 @@ namespace DynaPlex::NN {
         auto start_time = std::chrono::steady_clock::now();
 
         do {
-            std::shuffle(training_data.begin(), training_data.end(), rng.gen());
+            std::shuffle(permutation.begin(), permutation.end(), rng.gen());
+            torch::Tensor shuffled_indices = torch::from_blob(permutation.data(), { training_size }, torch::kInt64);
             float total_training_loss = 0.0;
             for (int64_t batch = 0; batch < num_batches; batch++) {
                 optimizer.zero_grad();       
-                auto [batched_inputs, batched_targets, mask, batched_probs, _] = prepare_batch({ &training_data[batch * mini_batch_size], static_cast<size_t>(mini_batch_size) }, mdp);
+                auto [batched_inputs, batched_targets, mask, batched_probs, _] = training_tensors.gather(shuffled_indices.narrow(0, batch * mini_batch_size, mini_batch_size));
 
                 // Forward pass.
                 torch::Tensor output = any_module.forward(batched_inputs) - mask;
@@ -8,13 +8,14 @@ namespace DynaPlex::NN {
 		: action_label(action_label), state(std::move(state))
 	{
 	}
-	DynaPlex::VarGroup Sample::ToVarGroup() const
+	DynaPlex::VarGroup Sample::ToVarGroup(bool include_state) const
 	{
 		//note: loading logic is in sampledata.cpp
 		DynaPlex::VarGroup vars;
 		vars.Add("action_label", action_label);
 		vars.Add("sample_number", sample_number);
-		vars.Add("state", state->ToVarGroup());
+		if (include_state)
+			vars.Add("state", state->ToVarGroup());
 		for (const auto& value : q_hat_vec) {
 			if (std::isnan(value) || std::isinf(value)) {
 				DynaPlex::Error("Sample: Value error, q-values contain NaN or infinity.");
@@ -1,11 +1,22 @@
 #include "dynaplex/sampledata.h"
 #include "dynaplex/error.h"
 #include "dynaplex/rng.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 namespace DynaPlex::NN
 {
+	namespace {
+		std::string StateFilePath(const std::string& path)
+		{
+			return path + ".states";
+		}
+	}
+
 	void SampleData::SaveToFile(DynaPlex::MDP mdp, std::string path,int64_t json_indent, bool silent)
 	{
-		if (!mdp->SupportsGetStateFromVarGroup())
+		bool binary_states = mdp->ProvidesStateSerialization();
+		if (!binary_states && !mdp->SupportsGetStateFromVarGroup())
 		{
 			throw DynaPlex::Error("This MDP does not support getting state from VarGroup. Currently, samples cannot be saved.");
 		}
@@ -23,11 +34,55 @@ namespace DynaPlex::NN
 
 		VarGroup vars{};
 		vars.Add("unique_identifier", mdp->Identifier());
-		vars.Add("Samples", Samples);
+		if (binary_states)
+		{//states are written in a single batch, bypassing VarGroup:
+			std::vector<DynaPlex::dp_State> states;
+			states.reserve(Samples.size());
+			for (auto& sample : Samples)
+				states.push_back(std::move(sample.state));
+			std::vector<uint8_t> bytes;
+			try {
+				bytes = mdp->SerializeStates(states);
+			}
+			catch (...) {
+				for (size_t i = 0; i < Samples.size(); i++)
+					Samples[i].state = std::move(states[i]);
+				throw;
+			}
+			for (size_t i = 0; i < Samples.size(); i++)
+				Samples[i].state = std::move(states[i]);
+
+			std::ofstream file(StateFilePath(path), std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				throw DynaPlex::Error("SampleData::SaveToFile - failed to open file for writing: " + StateFilePath(path));
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			if (!file)
+				throw DynaPlex::Error("SampleData::SaveToFile - failed to write " + StateFilePath(path));
+
+			VarGroup::VarGroupVec samples;
+			samples.reserve(Samples.size());
+			for (auto& sample : Samples)
+				samples.push_back(sample.ToVarGroup(false));
+			vars.Add("binary_states", true);
+			vars.Add("Samples", samples);
+		}
+		else
+		{
+			vars.Add("Samples", Samples);
+			//a sidecar from an earlier save would otherwise remain:
+			std::filesystem::remove(StateFilePath(path));
+		}
 
 		vars.SaveToFile(path,json_indent);
 	}
 
+	void SampleData::RemoveFiles(const std::string& path)
+	{
+		if (!std::filesystem::remove(path))
+			throw DynaPlex::Error("SampleData::RemoveFiles - could not delete " + path);
+		std::filesystem::remove(StateFilePath(path));
+	}
+
 	void SampleData::PrintStatistics()
 	{
 		std::vector<double> levels = { 0.5, 1.0, 1.5, 2.0, 2.5, 3.0 };
@@ -58,11 +113,13 @@ namespace DynaPlex::NN
 
 	SampleData SampleData::CreateNewFromFile(DynaPlex::MDP mdp, std::string path)
 	{
-		if (!mdp->SupportsGetStateFromVarGroup())
+		auto vars = VarGroup::LoadFromFile(path);
+		bool binary_states;
+		vars.GetOrDefault("binary_states", binary_states, false);
+		if (!binary_states && !mdp->SupportsGetStateFromVarGroup())
 		{
 			throw DynaPlex::Error("This MDP does not support getting state from VarGroup. Currently, samples cannot be saved or loaded.");
 		}
-		auto vars = VarGroup::LoadFromFile(path);
 		std::string unique_identifier;
 		vars.Get("unique_identifier", unique_identifier);
 
@@ -74,17 +131,35 @@ namespace DynaPlex::NN
 		std::vector<DynaPlex::VarGroup> vg_vec;
 		vars.Get("Samples", vg_vec);
 
+		std::vector<DynaPlex::dp_State> states;
+		if (binary_states)
+		{
+			std::ifstream file(StateFilePath(path), std::ios::binary);
+			if (!file.is_open())
+				throw DynaPlex::Error("SampleData::CreateNewFromFile - unable to open file: " + StateFilePath(path));
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			states = mdp->DeserializeStates(bytes);
+			if (states.size() != vg_vec.size())
+				throw DynaPlex::Error("SampleData::CreateNewFromFile - number of states in " + StateFilePath(path) + " does not match number of samples in " + path);
+		}
+
 		SampleData result{mdp};
 		result.Samples.reserve(vg_vec.size());
-		for (auto& vg : vg_vec)
+		for (size_t i = 0; i < vg_vec.size(); i++)
 		{
+			auto& vg = vg_vec[i];
 			//emplace a default-constructed sample. 
 			result.Samples.emplace_back();
 			auto& sample = result.Samples.back();
 
-			VarGroup state_as_vg{};
-			vg.Get("state", state_as_vg);
-		    sample.state = mdp->GetState(state_as_vg);
+			if (binary_states)
+				sample.state = std::move(states[i]);
+			else
+			{
+				VarGroup state_as_vg{};
+				vg.Get("state", state_as_vg);
+				sample.state = mdp->GetState(state_as_vg);
+			}
 
 			vg.Get("action_label", sample.action_label);
 			vg.Get("sample_number", sample.sample_number);
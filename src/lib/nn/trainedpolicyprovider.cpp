@@ -2,12 +2,51 @@
 #include "neuralnetworkprovider.h"
 #include "torchscriptwrapper.h"
 #include "nn_policy.h"
+#include "dynaplex/nativemlp.h"
+#include <filesystem>
 #if DP_TORCH_AVAILABLE
 #include <torch/torch.h>
 #endif
 //#if DP_TORCH_AVAILABLE
 namespace DynaPlex {
 
+	namespace {
+		//returns the native network of the policy, converting the torch network if needed.
+		std::shared_ptr<const NN::NativeMLP> GetNativeNetwork(const NN_Policy& policy)
+		{
+			if (policy.native_network)
+				return policy.native_network;
+#if DP_TORCH_AVAILABLE
+			if (policy.neural_network)
+			{
+				auto native_network = std::make_shared<NN::NativeMLP>();
+				auto parameters = policy.neural_network->ptr()->parameters();
+				if (parameters.size() % 2 != 0)
+					throw DynaPlex::Error("TrainedPolicyProvider - expected weight and bias for each layer of mlp.");
+				for (size_t i = 0; i < parameters.size(); i += 2)
+				{
+					auto weight = parameters[i].detach().to(torch::kCPU, torch::kFloat32).contiguous();
+					auto bias = parameters[i + 1].detach().to(torch::kCPU, torch::kFloat32).contiguous();
+					native_network->AddLayer(weight.size(1), weight.size(0),
+						std::span<const float>(weight.data_ptr<float>(), weight.numel()),
+						std::span<const float>(bias.data_ptr<float>(), bias.numel()));
+				}
+				return native_network;
+			}
+#endif
+			throw DynaPlex::Error("TrainedPolicyProvider - policy does not hold a neural network.");
+		}
+
+		void CheckMLPArchitecture(const DynaPlex::VarGroup& policy_config)
+		{
+			DynaPlex::VarGroup nn_architecture;
+			policy_config.Get("nn_architecture", nn_architecture);
+			std::string type;
+			nn_architecture.Get("type", type);
+			if (type != "mlp")
+				throw DynaPlex::Error("TrainedPolicyProvider - only neural network policies with type mlp can be converted to native format, type is " + type + ".");
+		}
+	}
 
 	DynaPlex::Policy TrainedPolicyProvider::LoadPolicy(DynaPlex::MDP mdp, std::string path_to_policy_without_extension)
 	{
@@ -20,7 +59,6 @@ namespace DynaPlex {
 		std::string id;
 			
 		policy_config.Get("id", id);
-#if DP_TORCH_AVAILABLE		
 		if (id == "NN_Policy")
 		{
 			//check whether dimensionalities are matching:
@@ -32,10 +70,30 @@ namespace DynaPlex {
 			if (num_outputs != mdp->NumValidActions())
 				throw DynaPlex::Error("NeuralNetworkProvider::LoadPolicy - cannot create neural network policy from loaded data for this mdp because num_outputs for the loaded policy does not match mdp->NumValidActions(). ");
 	
-			//create policy:
-			auto policy = std::make_shared<NN_Policy>(mdp);
 			DynaPlex::VarGroup nn_architecture;
 			policy_config.Get("nn_architecture", nn_architecture);
+			std::string type;
+			nn_architecture.Get("type", type);
+			//mlp networks are evaluated natively, i.e. without torch, if the flat weight file is available:
+			auto path_to_native_weights = System::SetFileExtension(path_to_policy_without_extension, "mlp");
+			if (type == "mlp" && std::filesystem::exists(path_to_native_weights))
+			{
+				auto native_network = std::make_shared<NN::NativeMLP>(NN::NativeMLP::LoadFromFile(path_to_native_weights));
+				std::string quantization;
+				policy_config.GetOrDefault("quantization", quantization, "float32");
+				auto precision = NN::NativeMLP::PrecisionFromString(quantization);
+				if (precision != NN::NativeMLP::Precision::Float32)
+					native_network = std::make_shared<NN::NativeMLP>(native_network->Quantized(precision));
+				if (native_network->NumInputs() != num_inputs || native_network->NumOutputs() != num_outputs)
+					throw DynaPlex::Error("NeuralNetworkProvider::LoadPolicy - dimensions of native weights in " + path_to_native_weights + " do not match num_inputs and num_outputs.");
+				auto policy = std::make_shared<NN_Policy>(mdp);
+				policy->native_network = std::move(native_network);
+				policy->policy_config = policy_config;
+				return policy;
+			}
+#if DP_TORCH_AVAILABLE
+			//create policy:
+			auto policy = std::make_shared<NN_Policy>(mdp);
 			NeuralNetworkProvider provider(mdp);
 			policy->neural_network = std::make_unique<torch::nn::AnyModule>(provider.GetTrainableNN(nn_architecture));
 			//loading weights:
@@ -44,8 +102,11 @@ namespace DynaPlex {
 			//set config:
 			policy->policy_config = policy_config;
 			return policy;
-
+#else
+			throw DynaPlex::Error("NeuralNetworkProvider::LoadPolicy: Torch not available and no native weights found at " + path_to_native_weights + " - Cannot construct. To make torch available, set dynaplex_enable_pytorch to true and dynaplex_pytorch_path to an appropriate path, e.g. in CMakeUserPresets.txt ");
+#endif
 		}
+#if DP_TORCH_AVAILABLE
 		else if (id == "torchscript")
 		{
 
@@ -107,11 +168,26 @@ namespace DynaPlex {
 			if (!as_NN_policy) {
 				throw DynaPlex::Error("NeuralNetworkProvider::SavePolicy - cannot save this policy of declared type+ " + id + ". Cast to NN_Policy fails.");
 			}
+			if (as_NN_policy->native_network)
+			{
+				as_NN_policy->native_network->SaveToFile(System::SetFileExtension(path_to_policy_without_extension, "mlp"));
+				as_NN_policy->policy_config.SaveToFile(System::SetFileExtension(path_to_policy_without_extension, "json"), 1);
+				return;
+			}
 #if DP_TORCH_AVAILABLE		
 			auto weights_path = System::SetFileExtension(path_to_policy_without_extension, "pth");
 			torch::save(as_NN_policy->neural_network->ptr(), weights_path);
 			auto json_path = System::SetFileExtension(path_to_policy_without_extension, "json");
 			as_NN_policy->policy_config.SaveToFile(json_path, 1);
+
+			DynaPlex::VarGroup nn_architecture;
+			policy_config.Get("nn_architecture", nn_architecture);
+			std::string type;
+			nn_architecture.Get("type", type);
+			if (type == "mlp")
+			{//export flat weights, such that the policy can be evaluated without torch. 
+				GetNativeNetwork(*as_NN_policy)->SaveToFile(System::SetFileExtension(path_to_policy_without_extension, "mlp"));
+			}
 #else
 			throw DynaPlex::Error("NeuralNetworkProvider::SavePolicy - Torch not available, cannot save. To make torch available, set dynaplex_enable_pytorch to true and dynaplex_pytorch_path to an appropriate path, e.g. in CMakeUserPresets.txt ");
 
@@ -121,4 +197,47 @@ namespace DynaPlex {
 			throw DynaPlex::Error("NeuralNetworkProvider::SavePolicy - do not know how to save policy of declared type+ " + id + ".");
 		}
 	}
+
+	DynaPlex::Policy TrainedPolicyProvider::QuantizePolicy(DynaPlex::Policy policy, const std::string& precision, const DynaPlex::NN::SampleData& validation_data)
+	{
+		std::shared_ptr<NN_Policy> as_NN_policy = std::dynamic_pointer_cast<NN_Policy>(policy);
+		if (!as_NN_policy)
+			throw DynaPlex::Error("TrainedPolicyProvider::QuantizePolicy - policy is not a neural network policy.");
+		CheckMLPArchitecture(as_NN_policy->policy_config);
+		if (validation_data.Samples.empty())
+			throw DynaPlex::Error("TrainedPolicyProvider::QuantizePolicy - validation_data contains no samples.");
+
+		auto& mdp = as_NN_policy->mdp;
+		auto reference = GetNativeNetwork(*as_NN_policy);
+		auto quantized = std::make_shared<NN::NativeMLP>(reference->Quantized(NN::NativeMLP::PrecisionFromString(precision)));
+
+		int64_t input_dim = mdp->NumFlatFeatures();
+		int64_t output_dim = mdp->NumValidActions();
+		int64_t num_samples = static_cast<int64_t>(validation_data.Samples.size());
+		std::vector<float> inputs(num_samples * input_dim);
+		std::vector<float> reference_outputs(num_samples * output_dim), quantized_outputs(num_samples * output_dim);
+		for (int64_t i = 0; i < num_samples; i++)
+			mdp->GetFlatFeatures(validation_data.Samples[i].state, std::span<float>(inputs.data() + i * input_dim, input_dim));
+		reference->Forward(inputs, num_samples, reference_outputs);
+		quantized->Forward(inputs, num_samples, quantized_outputs);
+
+		int64_t agreeing = 0;
+		for (int64_t i = 0; i < num_samples; i++)
+		{
+			auto allowed_actions = mdp->AllowedActions(validation_data.Samples[i].state);
+			auto arg_max = [&](const std::vector<float>& outputs) {
+				return *std::max_element(allowed_actions.begin(), allowed_actions.end(), [&](int64_t a, int64_t b) {
+					return outputs[i * output_dim + a] < outputs[i * output_dim + b]; });
+			};
+			if (arg_max(reference_outputs) == arg_max(quantized_outputs))
+				agreeing++;
+		}
+
+		auto quantized_policy = std::make_shared<NN_Policy>(mdp);
+		quantized_policy->native_network = std::move(quantized);
+		quantized_policy->policy_config = as_NN_policy->policy_config;
+		quantized_policy->policy_config.Set("quantization", precision);
+		quantized_policy->policy_config.Set("quantization_agreement", static_cast<double>(agreeing) / num_samples);
+		return quantized_policy;
+	}
 }//namespace DynaPlex
\ No newline at end of file
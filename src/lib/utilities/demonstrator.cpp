@@ -24,6 +24,15 @@ namespace DynaPlex :: Utilities{
 		config.GetOrDefault("rng_seed", rng_seed, 11112014);
 		if (rng_seed < 0)
 			throw DynaPlex::Error("Demonstrator :: Invalid rng_seed - should be non-negative");		
+		if (config.HasKey("event_log"))
+		{
+			std::string log_path;
+			config.Get("event_log", log_path);
+			config.GetOrDefault("event_log_stream", event_log_stream, 0);
+			event_log = std::make_shared<const DynaPlex::EventLog>(log_path);
+			//checks that the stream exists:
+			event_log->StreamLength(event_log_stream);
+		}
 	}
 
 	std::vector<TraceElement> Demonstrator::GetObjectTrace(DynaPlex::MDP mdp, DynaPlex::Policy policy) {
@@ -41,6 +50,13 @@ namespace DynaPlex :: Utilities{
 		// Vector that will hold a single trajectory.
 		Trajectory trajectory{};
 		trajectory.RNGProvider.SeedEventStreams(true, rng_seed);
+		if (event_log)
+		{
+			if (event_log->RecordSize() != mdp->EventRecordSize())
+				throw DynaPlex::Error("Demonstrator: record size of event log (" + std::to_string(event_log->RecordSize()) + ") differs from size of events of mdp " + mdp->TypeIdentifier() + " (" + std::to_string(mdp->EventRecordSize()) + ")");
+			trajectory.Replay.Events = event_log->Stream(event_log_stream);
+			trajectory.Replay.RecordSize = event_log->RecordSize();
+		}
 		mdp->InitiateState({ &trajectory,1 });
 		
 		double cumulative_return = 0.0;
@@ -3,6 +3,8 @@
 #include "dynaplex/policy.h"
 #include "dynaplex/system.h"
 #include "dynaplex/vargroup.h"
+#include "dynaplex/eventlog.h"
+#include <memory>
 namespace DynaPlex::Utilities {
 
 	class TraceElement {
@@ -23,6 +25,8 @@ namespace DynaPlex::Utilities {
 		/**
 		 *Config may include max_event_count (default:3)
 		 * it may also include rng_seed (default:11112014). 
+		 * If config includes event_log, the path of a file written with EventLog::Write, events are replayed from 
+		 * stream event_log_stream (default: 0) of that log instead of being sampled. 
 		 */
 		Demonstrator(const DynaPlex::System& system, const VarGroup& config = VarGroup{});
 
@@ -42,6 +46,8 @@ namespace DynaPlex::Utilities {
 	private:
 		int64_t max_period_count;
 		int64_t rng_seed;
+		std::shared_ptr<const DynaPlex::EventLog> event_log{};
+		int64_t event_log_stream{ 0 };
 		System system;
 
 
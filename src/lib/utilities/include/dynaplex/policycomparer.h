@@ -1,8 +1,13 @@
 #pragma once
 #include "dynaplex/mdp.h"
 #include "dynaplex/policy.h"
+#include "dynaplex/trajectory.h"
 #include "dynaplex/system.h"
 #include "dynaplex/vargroup.h"
+#include "dynaplex/policycomparison.h"
+#include "dynaplex/statepool.h"
+#include "dynaplex/eventlog.h"
+#include <functional>
 namespace DynaPlex::Utilities {
 	class PolicyComparer {
 
@@ -12,7 +17,37 @@ namespace DynaPlex::Utilities {
 		void CheckTrajectoriesInfiniteHorizon(std::span<DynaPlex::Trajectory>, int64_t) const;
 		void CheckTrajectoriesFiniteHorizon(std::span<DynaPlex::Trajectory>) const;
 
-		void ComputeReturns(std::span<double>& ReturnPerTrajectory, const DynaPlex::Policy& policy, int64_t offset) const;
+		std::vector<DynaPlex::Trajectory> CreateTrajectories(int64_t number, int64_t offset) const;
+		/// initiates the states of trajectories, from the initial state pool if set. 
+		void InitiateState(std::span<DynaPlex::Trajectory> trajectories) const;
+		/// evolves initiated trajectories under policy; the return (and control variate, if ControlPerTrajectory is non-empty) of each trajectory is stored at index ExternalIndex - offset. 
+		void ComputeReturns(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::Policy& policy, std::span<double> ReturnPerTrajectory, std::span<double> ControlPerTrajectory, int64_t offset) const;
+		/// computes for each experiment the returns of all policies (followed by their control variates, if enabled), with experiment numbers starting at offset.
+		void ComputeReturns(std::span<std::vector<double>> ReturnsPerExperiment, const std::vector<DynaPlex::Policy>& policies, int64_t offset) const;
+
+		/// batch means: for each run, evolves a single long trajectory per policy, and stores the returns (and control variates) of its batches_per_run consecutive batches. 
+		void ComputeBatchMeans(std::span<std::vector<double>> BatchesPerRun, const std::vector<DynaPlex::Policy>& policies, int64_t first_run) const;
+
+		std::vector<std::vector<double>> SimulateExperiments(const std::vector<DynaPlex::Policy>& policies, int64_t offset, int64_t number) const;
+
+		/// lock-step simulation of the policy family (see CompareFamily); computes for each experiment the returns for all values.
+		void ComputeFamilyReturns(std::span<std::vector<double>> ReturnsPerExperiment, const DynaPlex::VarGroup& policy_config, const std::string& parameter, std::span<const double> values, int64_t offset) const;
+		std::vector<std::vector<double>> SimulateFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter, const std::vector<double>& values, int64_t offset, int64_t number) const;
+		/// whether the family can be simulated in lock-step; otherwise, the policies of the family are simulated separately.
+		bool UsesFamilySimulation(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const;
+		/// the policies of the family, with parameter set to each of the values. 
+		std::vector<DynaPlex::Policy> GetFamily(const DynaPlex::Policy& policy, const std::string& parameter, const std::vector<double>& values) const;
+
+		using ExperimentSimulator = std::function<std::vector<std::vector<double>>(int64_t offset, int64_t number)>;
+		/// with multiple ranks, each rank simulates part of the experiments, and the returns of all experiments are gathered on all ranks.
+		std::vector<std::vector<double>> SimulateDistributed(const ExperimentSimulator& simulate, int64_t offset, int64_t number, size_t num_columns) const;
+		/// compares policies based on returns obtained from simulate, which is called with consecutive blocks of experiments. 
+		std::vector<VarGroup> CompareExperiments(const std::vector<DynaPlex::Policy>& policies, int64_t index_of_benchmark, const ExperimentSimulator& simulate) const;
+
+		/// comparison based on statistics of the returns per trajectory, or on reduced (if not null) when variance reduction is used.
+		DynaPlex::PolicyComparison GetComparison(const DynaPlex::ReturnStatistics& statistics, const DynaPlex::ReturnStatistics* reduced, size_t num_policies) const;
+
+		bool TargetPrecisionReached(const DynaPlex::PolicyComparison& comparison, int64_t number_of_policies, int64_t index_of_benchmark) const;
 
 	public:
 		/**
@@ -22,10 +57,56 @@ namespace DynaPlex::Utilities {
 		 * If mdp is finite horizon: config may include max_periods_until_error (default: 16384), this is the maximum number of steps in a trajectory until
 		 * mdp is expected to terminate by reaching final state. 
 		 * Config may also include rng_seed (default 13021984). 
+		 * 
+		 * Sequential stopping: if config includes target_half_width or target_relative_error (default: 0.0, i.e. inactive), trajectories 
+		 * are simulated in rounds of trajectories_per_round (default: 256), until the half-width of the 95% confidence interval
+		 * on the mean (or on the difference with the benchmark policy) is at most target_half_width, or at most target_relative_error
+		 * times the absolute mean (of the benchmark policy, if any), for all policies. number_of_trajectories is then the maximum budget. 
+		 * In all cases, results report the number_of_trajectories actually used. 
+		 * 
+		 * Variance reduction (default: off): with antithetic set to true, trajectories are simulated in pairs of which the second uses 
+		 * mirrored event streams (see RNG::SetAntithetic), and both
+		 * request monotone sampling (see RNG::SetMonotone). With control_variate set to true, for mdps that provide ControlVariate(const Event&),
+		 * the cumulative control variate of each trajectory is regressed out of its return. Results then report the variance_reduction,
+		 * i.e. the fraction of variance removed compared to the same number of trajectories without these techniques. 
+		 * 
+		 * Batch means (default: off): for undiscounted infinite horizon mdps, with batch_means set to true, each experiment is a batch of 
+		 * periods_per_trajectory periods, and runs of batches_per_run (default: 64) consecutive batches share a single long trajectory, 
+		 * such that warmup_periods are simulated once per run instead of once per experiment. Confidence intervals treat batches as 
+		 * independent, which is appropriate if periods_per_trajectory is long compared to the mixing time of the mdp under the policies. 
+		 * number_of_trajectories (and trajectories_per_round, for sequential stopping) then count batches, and should be multiples of 
+		 * batches_per_run. Cannot be combined with antithetic. 
+		 * 
+		 * Initial states (default: from the mdp): if config includes initial_state_pool, the path of a file saved with StatePool::SaveToFile,
+		 * trajectories are initiated with states drawn from that pool, and warmup_periods defaults to 0. See also SetInitialStatePool. 
+		 * 
+		 * Trace-driven evaluation (default: off): if config includes event_log, the path of a file written with EventLog::Write, events 
+		 * (for mdps whose Event is trivially copyable) are replayed from that log instead of being sampled. Experiment e replays stream 
+		 * e % n of the n streams in the log, starting at record (e / n) * event_log_stride (default: 0, in which case there should be 
+		 * at least as many streams as experiments). All policies face the same recorded events. Cannot be combined with antithetic. 
+		 * With batch_means, each run replays a stream. See also SetEventLog. 
+		 * 
+		 * With multiple (MPI) ranks, experiments are divided over the ranks, and all ranks return the same results, which do not depend 
+		 * on the number of ranks (or threads). All ranks must then call the same functions, with the same arguments. 
+		 * 
+		 * Config may include quantiles (default: none), a list of probabilities in (0,1). Results then include estimated quantiles 
+		 * of the return of each policy (not relative to the benchmark). Statistics are accumulated in streaming fashion, so memory
+		 * use does not grow with number_of_trajectories. 
 		 */
 		PolicyComparer(const DynaPlex::System& system, DynaPlex::MDP mdp, const DynaPlex::VarGroup& config = VarGroup{});
 
 
+		/**
+		 * Initiates trajectories with states drawn from pool (or from the mdp, if pool is null), e.g. a pool of steady-state states 
+		 * under a similar policy, in which case warmup_periods may be reduced. Draws depend on the pool seed and the experiment number.  
+		 */
+		void SetInitialStatePool(std::shared_ptr<const StatePool> pool);
+
+		/**
+		 * Replays events from log (or samples them, if log is null), see event_log. 
+		 */
+		void SetEventLog(std::shared_ptr<const DynaPlex::EventLog> log, int64_t stride = 0);
+
 		/**
 		 * @brief Assesses a policy by evaluating the return averaged over a number of trajectories.
 		 */
@@ -42,10 +123,44 @@ namespace DynaPlex::Utilities {
          */
 		std::vector<VarGroup> Compare(std::vector<DynaPlex::Policy> policies, int64_t index_of_benchmark = -1) const;
 
+		/**
+		 * @brief Simulates experiments first_experiment, ..., first_experiment + number - 1 for each of the policies, with common random numbers. 
+		 * 
+		 * Returns, for each experiment, the return of each policy. Experiments with the same number are identical across calls, such that
+		 * callers may e.g. extend the evaluation of a subset of policies. With batch_means, experiments are batches, and first_experiment
+		 * and number should be multiples of batches_per_run. 
+		 */
+		std::vector<std::vector<double>> GetReturns(const std::vector<DynaPlex::Policy>& policies, int64_t first_experiment, int64_t number) const;
+
+		/**
+		 * @brief Assesses the family of policies obtained by setting numeric parameter of policy to each of the values, e.g. all 
+		 * base_stock_level values of a base-stock policy. Results are as for Compare on these policies. 
+		 * 
+		 * If the mdp provides the family (see MDPInterface::ProvidesPolicyFamily) and the mdp is infinite horizon, all family members 
+		 * are simulated in lock-step on shared events, at a cost that grows slowly with the number of values. Otherwise (or with 
+		 * control_variate, batch_means or event_log), the members are simulated as separate policies. 
+		 */
+		std::vector<VarGroup> CompareFamily(DynaPlex::Policy policy, const std::string& parameter, const std::vector<double>& values, int64_t index_of_benchmark = -1) const;
+
+		/**
+		 * @brief As GetReturns, for the family of policies obtained by setting parameter of policy to each of the values (see CompareFamily). 
+		 */
+		std::vector<std::vector<double>> GetFamilyReturns(DynaPlex::Policy policy, const std::string& parameter, const std::vector<double>& values, int64_t first_experiment, int64_t number) const;
+
 	private:
 		int64_t number_of_trajectories, periods_per_trajectory, warmup_periods, max_periods_until_error, rng_seed;
+		int64_t trajectories_per_round;
+		double target_half_width, target_relative_error;
+		std::vector<double> quantiles{};
+		bool antithetic, control_variate, batch_means;
+		int64_t batches_per_run;
+		/// maximum number of experiments simulated in a single parallel pass.
+		static constexpr int64_t max_chunk_size = 8192;
 		DynaPlex::MDP mdp;
 		System system;
+		std::shared_ptr<const StatePool> initial_state_pool{};
+		std::shared_ptr<const DynaPlex::EventLog> event_log{};
+		int64_t event_log_stride{ 0 };
 
 
 	};
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include "dynaplex/error.h"
+#include "dynaplex/returnstatistics.h"
 
 namespace DynaPlex {
     /**
@@ -14,6 +15,9 @@ namespace DynaPlex {
     class PolicyComparison {
     private:
         std::vector<std::vector<double>> data;
+        size_t num_alternatives = 0;
+        /// number of observations per alternative, if rectangular.
+        size_t num_observations = 0;
         std::vector<double> means;
         std::vector<std::vector<double>> covariances;
         std::vector<double> probs;
@@ -41,6 +45,20 @@ namespace DynaPlex {
         */
         PolicyComparison(std::vector<std::vector<double>>&& nestedVector);
 
+        /**
+         * @brief Construct a new PolicyComparison object from streaming statistics of paired observations.
+         *
+         * Per-observation data is not retained, so rank-based probabilities are not available.
+         */
+        PolicyComparison(const ReturnStatistics& statistics);
+
+        /**
+         * @brief Construct a new PolicyComparison object from means and the (sample) covariance matrix of paired observations.
+         *
+         * @param num_observations The number of observations for each alternative.
+         */
+        PolicyComparison(std::vector<double> means, std::vector<std::vector<double>> covariances, size_t num_observations);
+
         static PolicyComparison GetComparison(const std::vector<double> vector);
 
 
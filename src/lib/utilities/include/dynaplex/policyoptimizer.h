@@ -0,0 +1,50 @@
+#pragma once
+#include "dynaplex/mdp.h"
+#include "dynaplex/policy.h"
+#include "dynaplex/system.h"
+#include "dynaplex/vargroup.h"
+#include "dynaplex/policycomparer.h"
+namespace DynaPlex::Utilities {
+	/**
+	 * Optimizes numeric parameters of a (parametric) policy, e.g. the base_stock_level of a base-stock policy, over a grid.
+	 * All candidates are simulated concurrently with common random numbers, in rounds of trajectories_per_round. After each round,
+	 * candidates that are significantly worse than the current best (paired z-test) are eliminated (racing), such that the
+	 * remaining budget is spent on the contenders. Paired differences are accumulated with respect to the current best, and restart
+	 * when another candidate becomes best; memory does not grow with the number of trajectories.
+	 */
+	class PolicyOptimizer {
+	public:
+		/**
+		 * Config must include parameters: a list of VarGroups, each with name (a numeric key in the policy config), min, and max, and
+		 * optionally step (default: 1) and integer (default: true; if false, the parameter is set as double). Candidates are all points on
+		 * the resulting (multi-dimensional) grid.
+		 * Config may include number_of_trajectories (default: 4096), the maximum number of trajectories per candidate, and
+		 * trajectories_per_round (default: 256).
+		 * Config may include elimination_z (default: 2.0), the z-statistic above which a candidate is eliminated, and max_candidates
+		 * (default: 4096), the maximum grid size.
+		 * Other settings (periods_per_trajectory, warmup_periods, rng_seed, etc.) are passed on to PolicyComparer; antithetic and
+		 * control_variate are not supported. 
+		 */
+		PolicyOptimizer(const DynaPlex::System& system, DynaPlex::MDP mdp, const DynaPlex::VarGroup& config);
+
+		/**
+		 * Optimizes the parameters, starting from the config of policy, which is retained for all other keys. Returns a VarGroup with the
+		 * config of the best policy (policy), its parameter values (parameters), mean and error, the number of candidates and of candidates
+		 * remaining at the end (survivors), and the total number of trajectories simulated.
+		 */
+		DynaPlex::VarGroup Optimize(DynaPlex::Policy policy) const;
+
+	private:
+		struct Parameter {
+			std::string name;
+			double min, max, step;
+			bool integer;
+			int64_t NumValues() const;
+		};
+		std::vector<Parameter> parameters;
+		int64_t number_of_trajectories, trajectories_per_round, max_candidates;
+		double elimination_z;
+		DynaPlex::MDP mdp;
+		PolicyComparer comparer;
+	};
+}//namespace DynaPlex::Utilities
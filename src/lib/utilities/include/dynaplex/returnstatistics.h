@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "dynaplex/error.h"
+
+namespace DynaPlex {
+    /**
+     * @class ReturnStatistics
+     * @brief Streaming accumulator for paired observations of multiple policies or other options.
+     *
+     * Each observation contains one value per alternative (e.g. the returns of all policies on a single
+     * trajectory with common random numbers). Means and the co-moment matrix are updated with Welford's
+     * algorithm, and accumulators can be merged (Chan et al.), such that e.g. threads can accumulate
+     * separately. Quantiles are estimated with the P-square algorithm. Memory is O(alternatives^2),
+     * independent of the number of observations.
+     */
+    class ReturnStatistics {
+    public:
+        /**
+         * @param num_alternatives Number of values in each observation.
+         * @param quantile_probabilities Probabilities (in (0,1)) of the quantiles to estimate for each alternative.
+         */
+        explicit ReturnStatistics(size_t num_alternatives, std::vector<double> quantile_probabilities = {});
+
+        /// adds an observation, containing one value for each alternative.
+        void Add(std::span<const double> observation);
+        /**
+         * @brief Merges the observations of other into this accumulator.
+         *
+         * Means and covariances are merged exactly. Quantile estimates are merged approximately,
+         * unless one of the accumulators has fewer than 5 observations.
+         */
+        void Merge(const ReturnStatistics& other);
+
+        size_t NumAlternatives() const;
+        int64_t Count() const;
+        double Mean(size_t i) const;
+        /// sample covariance (i.e. normalized by Count()-1) of alternatives i and j.
+        double Covariance(size_t i, size_t j) const;
+
+        const std::vector<double>& QuantileProbabilities() const;
+        /// estimate of quantile QuantileProbabilities()[q] for alternative i.
+        double Quantile(size_t i, size_t q) const;
+
+    private:
+        /// P-square estimator for a single quantile (Jain and Chlamtac, 1985).
+        class P2Quantile {
+        public:
+            explicit P2Quantile(double probability = 0.5);
+            void Add(double x);
+            void Merge(const P2Quantile& other);
+            double Estimate() const;
+        private:
+            double probability;
+            int64_t count{ 0 };
+            /// marker heights; the first observations are stored here until there are 5.
+            double heights[5]{};
+            double positions[5]{};
+            double desired[5]{};
+            double increments[5]{};
+            void Initialize();
+            double Parabolic(int i, double d) const;
+            double Linear(int i, int d) const;
+        };
+
+        size_t IndexOf(size_t i, size_t j) const;
+
+        size_t num_alternatives;
+        int64_t count{ 0 };
+        std::vector<double> means;
+        /// co-moments, packed upper triangle (row-major, j>=i).
+        std::vector<double> comoments;
+        std::vector<double> deltas;
+        std::vector<double> quantile_probabilities;
+        /// num_alternatives x quantile_probabilities.size().
+        std::vector<P2Quantile> quantiles;
+    };
+
+}  // namespace DynaPlex
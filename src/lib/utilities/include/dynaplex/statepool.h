@@ -0,0 +1,61 @@
+#pragma once
+#include "dynaplex/mdp.h"
+#include "dynaplex/policy.h"
+#include "dynaplex/state.h"
+#include "dynaplex/system.h"
+#include "dynaplex/trajectory.h"
+#include "dynaplex/rng.h"
+#include "dynaplex/vargroup.h"
+#include <span>
+#include <vector>
+namespace DynaPlex::Utilities {
+	/**
+	 * A pool of (approximately) steady-state states of an infinite horizon mdp under some policy, obtained from long runs.
+	 * Trajectories may be initiated from the pool instead of from GetInitialState, such that burn-in periods (warmup_periods
+	 * for PolicyComparer, L for sample generation) need not be simulated again. Pools are keyed on the identifier of the mdp
+	 * and the config of the policy, and may be saved to and loaded from file. Generation and draws are reproducible, based on
+	 * the pool_seed.
+	 */
+	class StatePool {
+	public:
+		/**
+		 * Generates a pool for mdp under policy. Config may include number_of_states (default: 1024), burn_in_periods (default: 1024),
+		 * states_per_run (default: 64), spacing_periods (default: 16), and pool_seed (default: 25011990). States are collected from
+		 * independent runs: after burn_in_periods, each run contributes states_per_run states, spacing_periods apart, each awaiting an action.
+		 */
+		StatePool(const DynaPlex::System& system, DynaPlex::MDP mdp, DynaPlex::Policy policy, const DynaPlex::VarGroup& config = VarGroup{});
+
+		/// loads a pool saved with SaveToFile, for an mdp with the same Identifier() as the mdp that generated the pool.
+		StatePool(DynaPlex::MDP mdp, const std::string& file_path);
+
+		/// saves the pool, with its key and seed, in binary form (states via MDPInterface::SerializeStates). Requires that the states can be 
+		/// deserialized, i.e. that the mdp provides a binary codec for states or supports GetState(const VarGroup&).
+		void SaveToFile(const std::string& file_path) const;
+
+		/// pools with the same key are generated for the same mdp and under the same policy.
+		static std::string Key(const DynaPlex::MDP& mdp, const DynaPlex::VarGroup& policy_config);
+		std::string Key() const;
+		const std::string& MDPIdentifier() const;
+		const DynaPlex::VarGroup& PolicyConfig() const;
+		int64_t Seed() const;
+		size_t Size() const;
+
+		/// returns a state from the pool, chosen based on the pool_seed and key. Equal keys give equal states.
+		const DynaPlex::dp_State& Draw(int64_t key) const;
+		/// returns a state from the pool, chosen using rng.
+		const DynaPlex::dp_State& Draw(DynaPlex::RNG& rng) const;
+
+		/// initiates each trajectory with Draw(trajectory.ExternalIndex).
+		void InitiateState(std::span<DynaPlex::Trajectory> trajectories) const;
+
+	private:
+		void GenerateRuns(std::span<std::vector<DynaPlex::dp_State>> runs, const DynaPlex::Policy& policy, int64_t first_run) const;
+
+		DynaPlex::MDP mdp;
+		std::string mdp_identifier;
+		DynaPlex::VarGroup policy_config;
+		int64_t pool_seed;
+		int64_t burn_in_periods, states_per_run, spacing_periods;
+		std::vector<DynaPlex::dp_State> states;
+	};
+}//namespace DynaPlex::Utilities
@@ -1,23 +1,94 @@
 #include "dynaplex/policycomparer.h"
 #include "dynaplex/trajectory.h"
 #include "dynaplex/parallel_execute.h"
-#include "dynaplex/policycomparison.h"
+#include "dynaplex/returnstatistics.h"
+#include <cmath>
+#include <limits>
+#include <optional>
 namespace DynaPlex::Utilities {
 
-	void PolicyComparer::ComputeReturns(std::span<double>& ReturnPerTrajectory,const DynaPlex::Policy& policy, int64_t offset) const
+	std::vector<DynaPlex::Trajectory> PolicyComparer::CreateTrajectories(int64_t number, int64_t offset) const
 	{
 		std::vector<DynaPlex::Trajectory> trajectories{};
-		trajectories.reserve(ReturnPerTrajectory.size());
+		trajectories.reserve(number);
+		for (int64_t experiment_number = offset; experiment_number < offset + number; experiment_number++)
+		{
+			trajectories.emplace_back(experiment_number);
+			//with antithetic sampling, consecutive experiments 2k and 2k+1 use the same seed, and the latter has mirrored event streams. 
+			//both request monotone sampling, as e.g. alias-table samples of mirrored uniforms are hardly correlated. 
+			int64_t sample = antithetic ? experiment_number / 2 : experiment_number;
+			trajectories.back().RNGProvider.SeedEventStreams(true, rng_seed, sample);
+			if (antithetic)
+			{
+				trajectories.back().RNGProvider.SetMonotoneEventStreams(true);
+				if (experiment_number % 2 == 1)
+					trajectories.back().RNGProvider.SetAntitheticEventStreams(true);
+			}
+			if (event_log)
+			{//experiments cycle through the streams of the log, and each cycle starts event_log_stride records further:
+				int64_t num_streams = event_log->NumStreams();
+				int64_t start = (experiment_number / num_streams) * event_log_stride;
+				if (event_log_stride == 0 && experiment_number >= num_streams)
+					throw DynaPlex::Error("PolicyComparer :: event log has " + std::to_string(num_streams) + " streams, which does not suffice for experiment " + std::to_string(experiment_number) + "; set event_log_stride to reuse streams");
+				auto events = event_log->Stream(experiment_number % num_streams);
+				size_t first_byte = static_cast<size_t>(start) * event_log->RecordSize();
+				auto& replay = trajectories.back().Replay;
+				replay.Events = first_byte < events.size() ? events.subspan(first_byte) : std::span<const std::byte>{};
+				replay.RecordSize = event_log->RecordSize();
+				replay.Position = 0;
+			}
+		}
+		return trajectories;
+	}
 
-		
-		for (int64_t experiment_number = 0; experiment_number < ReturnPerTrajectory.size(); experiment_number++)
+	void PolicyComparer::InitiateState(std::span<DynaPlex::Trajectory> trajectories) const
+	{
+		if (!initial_state_pool)
 		{
-			trajectories.emplace_back(experiment_number + offset);
-			trajectories.back().RNGProvider.SeedEventStreams(true, rng_seed, experiment_number + offset);
+			mdp->InitiateState(trajectories);
+			return;
+		}
+		for (auto& traj : trajectories)
+		{//antithetic pairs share their initial state:
+			int64_t key = antithetic ? traj.ExternalIndex / 2 : traj.ExternalIndex;
+			mdp->InitiateState({ &traj,1 }, initial_state_pool->Draw(key));
 		}
+	}
 
-		//Initiate each trajectory with a random state. 
-		mdp->InitiateState(trajectories);		
+	void PolicyComparer::SetInitialStatePool(std::shared_ptr<const StatePool> pool)
+	{
+		if (pool && pool->MDPIdentifier() != mdp->Identifier())
+			throw DynaPlex::Error("PolicyComparer :: initial state pool was generated for mdp " + pool->MDPIdentifier() + ", not for " + mdp->Identifier());
+		initial_state_pool = std::move(pool);
+	}
+
+	void PolicyComparer::SetEventLog(std::shared_ptr<const DynaPlex::EventLog> log, int64_t stride)
+	{
+		if (log)
+		{
+			if (mdp->EventRecordSize() == 0)
+				throw DynaPlex::Error("PolicyComparer :: events cannot be replayed for mdp " + mdp->TypeIdentifier() + ", since its Event is not trivially copyable, or it does not define ModifyStateWithEvent(MDP::State&, const MDP::Event&)");
+			if (log->RecordSize() != mdp->EventRecordSize())
+				throw DynaPlex::Error("PolicyComparer :: record size of event log (" + std::to_string(log->RecordSize()) + ") differs from size of events of mdp " + mdp->TypeIdentifier() + " (" + std::to_string(mdp->EventRecordSize()) + ")");
+			if (log->NumStreams() == 0)
+				throw DynaPlex::Error("PolicyComparer :: event log contains no streams");
+			if (antithetic)
+				throw DynaPlex::Error("PolicyComparer :: event log cannot be combined with antithetic");
+		}
+		if (stride < 0)
+			throw DynaPlex::Error("PolicyComparer :: Invalid event_log_stride - should be non-negative");
+		event_log = std::move(log);
+		event_log_stride = stride;
+	}
+
+	void PolicyComparer::ComputeReturns(std::span<DynaPlex::Trajectory> trajectories, const DynaPlex::Policy& policy, std::span<double> ReturnPerTrajectory, std::span<double> ControlPerTrajectory, int64_t offset) const
+	{
+		//Evolve may reorder trajectories, so returns are stored based on the experiment number in ExternalIndex.
+		auto index = [offset](const DynaPlex::Trajectory& traj) { return static_cast<size_t>(traj.ExternalIndex - offset); };
+		//control variates are optional, and are treated in the same way as returns.
+		bool controls = !ControlPerTrajectory.empty();
+		std::fill(ReturnPerTrajectory.begin(), ReturnPerTrajectory.end(), 0.0);
+		std::fill(ControlPerTrajectory.begin(), ControlPerTrajectory.end(), 0.0);
 
 		if (mdp->IsInfiniteHorizon())
 		{
@@ -29,8 +100,12 @@ namespace DynaPlex::Utilities {
 			if (mdp->DiscountFactor() == 1.0)
 			{
 				Evolve(policy, trajectories, warmup_periods);
-				for (size_t i = 0; i < ReturnPerTrajectory.size(); i++)
-					ReturnPerTrajectory[i] = trajectories[i].CumulativeReturn;
+				for (auto& traj : trajectories)
+				{
+					ReturnPerTrajectory[index(traj)] = traj.CumulativeReturn;
+					if (controls)
+						ControlPerTrajectory[index(traj)] = traj.CumulativeControlVariate;
+				}
 			}
 			else
 				if (warmup_periods != 0)
@@ -40,23 +115,57 @@ namespace DynaPlex::Utilities {
 			CheckTrajectoriesInfiniteHorizon(trajectories, warmup_periods);
 			Evolve(policy, trajectories, warmup_periods + periods_per_trajectory);
 			CheckTrajectoriesInfiniteHorizon(trajectories, warmup_periods + periods_per_trajectory);
-			for (size_t i = 0; i < ReturnPerTrajectory.size(); i++)
+			for (auto& traj : trajectories)
 			{
-				ReturnPerTrajectory[i] = trajectories[i].CumulativeReturn - ReturnPerTrajectory[i];
+				ReturnPerTrajectory[index(traj)] = traj.CumulativeReturn - ReturnPerTrajectory[index(traj)];
+				if (controls)
+					ControlPerTrajectory[index(traj)] = traj.CumulativeControlVariate - ControlPerTrajectory[index(traj)];
 			}
 			if (mdp->DiscountFactor() == 1)
 			{
 				for (auto& returnVal : ReturnPerTrajectory)
 					returnVal /= periods_per_trajectory;
+				for (auto& controlVal : ControlPerTrajectory)
+					controlVal /= periods_per_trajectory;
 			}
 		}
 		else
 		{//finite horizon:
 			Evolve(policy, trajectories, max_periods_until_error);
 			CheckTrajectoriesFiniteHorizon(trajectories);
-			for (size_t i = 0; i < ReturnPerTrajectory.size(); i++)
+			for (auto& traj : trajectories)
 			{
-				ReturnPerTrajectory[i] = trajectories[i].CumulativeReturn;
+				ReturnPerTrajectory[index(traj)] = traj.CumulativeReturn;
+				if (controls)
+					ControlPerTrajectory[index(traj)] = traj.CumulativeControlVariate;
+			}
+		}
+	}
+
+	void PolicyComparer::ComputeReturns(std::span<std::vector<double>> ReturnsPerExperiment, const std::vector<DynaPlex::Policy>& policies, int64_t offset) const
+	{
+		int64_t number = static_cast<int64_t>(ReturnsPerExperiment.size());
+		//Initiate each trajectory with a random state. Initiation does not depend on the policy, so is shared by all policies.
+		auto initial_trajectories = CreateTrajectories(number, offset);
+		InitiateState(initial_trajectories);
+
+		std::vector<double> returns(number), controls(control_variate ? number : 0);
+		size_t num_policies = policies.size();
+		for (size_t policy_index = 0; policy_index < policies.size(); policy_index++)
+		{
+			//common random numbers: for each policy, the trajectories are seeded identically.  
+			auto trajectories = CreateTrajectories(number, offset);
+			for (int64_t i = 0; i < number; i++)
+			{
+				trajectories[i].Reset(initial_trajectories[i].GetState()->Clone());
+				trajectories[i].Category = initial_trajectories[i].Category;
+			}
+			ComputeReturns(trajectories, policies[policy_index], returns, controls, offset);
+			for (int64_t i = 0; i < number; i++)
+			{
+				ReturnsPerExperiment[i][policy_index] = returns[i];
+				if (control_variate)
+					ReturnsPerExperiment[i][num_policies + policy_index] = controls[i];
 			}
 		}
 	}
@@ -75,7 +184,8 @@ namespace DynaPlex::Utilities {
 
 			if (mdp->DiscountFactor() == 1.0)
 			{
-				config.GetOrDefault("warmup_periods", warmup_periods, 128);
+				//with a pool of (steady-state) initial states, warm-up is typically not needed:
+				config.GetOrDefault("warmup_periods", warmup_periods, config.HasKey("initial_state_pool") ? 0 : 128);
 			}
 			else
 			{
@@ -92,6 +202,57 @@ namespace DynaPlex::Utilities {
 		config.GetOrDefault("rng_seed", rng_seed, 13021984);
 		if (rng_seed < 0)
 			throw DynaPlex::Error("PolicyComparer :: Invalid rng_seed - should be non-negative");
+		if (number_of_trajectories < 2)
+			throw DynaPlex::Error("PolicyComparer :: Invalid number_of_trajectories - should be at least 2");
+
+		config.GetOrDefault("target_half_width", target_half_width, 0.0);
+		config.GetOrDefault("target_relative_error", target_relative_error, 0.0);
+		config.GetOrDefault("trajectories_per_round", trajectories_per_round, 256);
+		if (target_half_width < 0.0 || target_relative_error < 0.0)
+			throw DynaPlex::Error("PolicyComparer :: Invalid target_half_width or target_relative_error - should be non-negative");
+		if (trajectories_per_round < 2)
+			throw DynaPlex::Error("PolicyComparer :: Invalid trajectories_per_round - should be at least 2");
+		config.GetOrDefault("antithetic", antithetic, false);
+		config.GetOrDefault("control_variate", control_variate, false);
+		if (antithetic && (number_of_trajectories % 2 != 0 || number_of_trajectories < 4 || trajectories_per_round % 2 != 0 || trajectories_per_round < 4))
+			throw DynaPlex::Error("PolicyComparer :: With antithetic, number_of_trajectories and trajectories_per_round should be even and at least 4");
+		if (control_variate && !mdp->ProvidesControlVariate())
+			throw DynaPlex::Error("PolicyComparer :: control_variate requires that mdp " + mdp->TypeIdentifier() + " publicly defines ControlVariate(const MDP::Event&) const returning double");
+		config.GetOrDefault("batch_means", batch_means, false);
+		config.GetOrDefault("batches_per_run", batches_per_run, 64);
+		if (batch_means)
+		{
+			if (!mdp->IsInfiniteHorizon() || mdp->DiscountFactor() != 1.0)
+				throw DynaPlex::Error("PolicyComparer :: batch_means is only available for undiscounted infinite horizon mdps");
+			if (antithetic)
+				throw DynaPlex::Error("PolicyComparer :: batch_means cannot be combined with antithetic");
+			if (batches_per_run < 1 || batches_per_run > max_chunk_size)
+				throw DynaPlex::Error("PolicyComparer :: Invalid batches_per_run - should be between 1 and " + std::to_string(max_chunk_size));
+			bool sequential = target_half_width > 0.0 || target_relative_error > 0.0;
+			if (number_of_trajectories % batches_per_run != 0 || (sequential && trajectories_per_round % batches_per_run != 0))
+				throw DynaPlex::Error("PolicyComparer :: With batch_means, number_of_trajectories and trajectories_per_round should be multiples of batches_per_run");
+		}
+		if (config.HasKey("initial_state_pool"))
+		{
+			std::string pool_path;
+			config.Get("initial_state_pool", pool_path);
+			SetInitialStatePool(std::make_shared<const StatePool>(mdp, pool_path));
+		}
+		if (config.HasKey("event_log"))
+		{
+			std::string log_path;
+			int64_t stride;
+			config.Get("event_log", log_path);
+			config.GetOrDefault("event_log_stride", stride, 0);
+			SetEventLog(std::make_shared<const DynaPlex::EventLog>(log_path), stride);
+		}
+		if (config.HasKey("quantiles"))
+		{
+			config.Get("quantiles", quantiles);
+			for (double probability : quantiles)
+				if (!(probability > 0.0 && probability < 1.0))
+					throw DynaPlex::Error("PolicyComparer :: Invalid quantiles - probabilities should be in (0,1)");
+		}
 	}
 
 	void PolicyComparer::CheckTrajectoriesInfiniteHorizon(std::span<DynaPlex::Trajectory> trajectories, int64_t cumulative_periods) const {
@@ -121,6 +282,14 @@ namespace DynaPlex::Utilities {
 	template<bool SkipTrivialActions>
 	void PolicyComparer::Evolve(const DynaPlex::Policy& policy, std::span<DynaPlex::Trajectory> span, int64_t max_periods) const
 	{
+		if constexpr (!SkipTrivialActions)
+		{//EvolveBatch incorporates trivial actions like IncorporateUntilNonTrivialAction, so it only replaces this variant:
+			if (mdp->ProvidesBatchEvolution(policy->GetConfig()))
+			{//the mdp simulates lanes of trajectories in lock-step, with identical results:
+				mdp->EvolveBatch(span, policy->GetConfig(), max_periods, std::numeric_limits<int64_t>::max());
+				return;
+			}
+		}
 		while (true)
 		{
 			bool all_require_action;
@@ -165,30 +334,332 @@ namespace DynaPlex::Utilities {
 		return Compare(polVec, index_of_benchmark);
 	}
 
+	bool PolicyComparer::TargetPrecisionReached(const DynaPlex::PolicyComparison& comparison, int64_t number_of_policies, int64_t index_of_benchmark) const
+	{
+		const double z_value = 1.96;
+		for (int64_t i = 0; i < number_of_policies; i++)
+		{
+			if (i == index_of_benchmark)
+				continue;
+			double half_width = z_value * comparison.standardError(i, index_of_benchmark);
+			double reference = std::abs(comparison.mean(index_of_benchmark == -1 ? i : index_of_benchmark));
+			bool reached = (target_half_width > 0.0 && half_width <= target_half_width)
+				|| (target_relative_error > 0.0 && half_width <= target_relative_error * reference);
+			if (!reached)
+				return false;
+		}
+		return true;
+	}
+
+	void PolicyComparer::ComputeBatchMeans(std::span<std::vector<double>> BatchesPerRun, const std::vector<DynaPlex::Policy>& policies, int64_t first_run) const
+	{
+		int64_t number = static_cast<int64_t>(BatchesPerRun.size());
+		//runs are seeded by run number, and all policies start each run in the same initial state.
+		auto initial_trajectories = CreateTrajectories(number, first_run);
+		InitiateState(initial_trajectories);
+
+		size_t num_policies = policies.size();
+		size_t num_columns = control_variate ? 2 * num_policies : num_policies;
+		std::vector<double> previous_return(number), previous_control(number);
+		auto index = [first_run](const DynaPlex::Trajectory& traj) { return static_cast<size_t>(traj.ExternalIndex - first_run); };
+		for (size_t policy_index = 0; policy_index < num_policies; policy_index++)
+		{
+			auto trajectories = CreateTrajectories(number, first_run);
+			for (int64_t i = 0; i < number; i++)
+			{
+				trajectories[i].Reset(initial_trajectories[i].GetState()->Clone());
+				trajectories[i].Category = initial_trajectories[i].Category;
+			}
+			//warm-up is simulated once per run:
+			Evolve(policies[policy_index], trajectories, warmup_periods);
+			CheckTrajectoriesInfiniteHorizon(trajectories, warmup_periods);
+			for (auto& traj : trajectories)
+			{
+				previous_return[index(traj)] = traj.CumulativeReturn;
+				previous_control[index(traj)] = traj.CumulativeControlVariate;
+			}
+			for (int64_t batch = 0; batch < batches_per_run; batch++)
+			{
+				int64_t batch_end = warmup_periods + (batch + 1) * periods_per_trajectory;
+				Evolve(policies[policy_index], trajectories, batch_end);
+				CheckTrajectoriesInfiniteHorizon(trajectories, batch_end);
+				for (auto& traj : trajectories)
+				{
+					auto i = index(traj);
+					auto& row = BatchesPerRun[i];
+					row[batch * num_columns + policy_index] = (traj.CumulativeReturn - previous_return[i]) / periods_per_trajectory;
+					previous_return[i] = traj.CumulativeReturn;
+					if (control_variate)
+					{
+						row[batch * num_columns + num_policies + policy_index] = (traj.CumulativeControlVariate - previous_control[i]) / periods_per_trajectory;
+						previous_control[i] = traj.CumulativeControlVariate;
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<std::vector<double>> PolicyComparer::SimulateExperiments(const std::vector<DynaPlex::Policy>& policies, int64_t offset, int64_t number) const
+	{
+		size_t num_columns = control_variate ? 2 * policies.size() : policies.size();
+		if (batch_means)
+		{
+			if (offset % batches_per_run != 0 || number % batches_per_run != 0)
+				throw DynaPlex::Error("PolicyComparer: with batch_means, experiments should be simulated in whole runs of batches_per_run batches");
+			std::vector<std::vector<double>> batches_per_run_rows(number / batches_per_run, std::vector<double>(batches_per_run * num_columns, 0.0));
+			int64_t first_run = offset / batches_per_run;
+			//runs are sequential, so the parallel pass is over runs rather than over experiments:
+			DynaPlex::Parallel::parallel_compute<std::vector<double>>(batches_per_run_rows, [this, &policies, first_run](std::span<std::vector<double>> span, int64_t start) {
+				this->ComputeBatchMeans(span, policies, start + first_run);
+				}, system);
+			std::vector<std::vector<double>> returns_per_experiment;
+			returns_per_experiment.reserve(number);
+			for (auto& run : batches_per_run_rows)
+				for (int64_t batch = 0; batch < batches_per_run; batch++)
+					returns_per_experiment.emplace_back(run.begin() + batch * num_columns, run.begin() + (batch + 1) * num_columns);
+			return returns_per_experiment;
+		}
+		std::vector<std::vector<double>> returns_per_experiment(number, std::vector<double>(num_columns, 0.0));
+		//a single parallel pass for all policies: each worker evaluates all policies on its block of experiments. 
+		DynaPlex::Parallel::parallel_compute<std::vector<double>>(returns_per_experiment, [this, &policies, offset](std::span<std::vector<double>> span, int64_t start) {
+			this->ComputeReturns(span, policies, start + offset);
+			}, system);
+		return returns_per_experiment;
+	}
+
+	std::vector<std::vector<double>> PolicyComparer::SimulateDistributed(const ExperimentSimulator& simulate, int64_t offset, int64_t number, size_t num_columns) const
+	{
+		std::uint32_t world_size = system.WorldSize();
+		if (world_size == 1)
+			return simulate(offset, number);
+		//runs of batch means are not split over ranks:
+		int64_t unit = batch_means ? batches_per_run : 1;
+		if (number % unit != 0)
+			throw DynaPlex::Error("PolicyComparer: with batch_means, experiments should be simulated in whole runs of batches_per_run batches");
+		auto splits = DynaPlex::Parallel::get_splits(number / unit, world_size);
+		auto [start, end] = splits[system.WorldRank()];
+		auto local = simulate(offset + start * unit, (end - start) * unit);
+		//raw returns are gathered (rather than e.g. statistics per rank), such that all ranks fold the returns in order of
+		//experiment number, and results are bitwise independent of the number of ranks. 
+		std::vector<double> flat;
+		flat.reserve(local.size() * num_columns);
+		for (auto& row : local)
+			flat.insert(flat.end(), row.begin(), row.end());
+		auto all = system.AllGather(flat);
+		if (all.size() != static_cast<size_t>(number) * num_columns)
+			throw DynaPlex::Error("PolicyComparer: inconsistent number of returns gathered from ranks - all ranks should make identical calls.");
+		std::vector<std::vector<double>> returns_per_experiment;
+		returns_per_experiment.reserve(number);
+		for (int64_t e = 0; e < number; e++)
+			returns_per_experiment.emplace_back(all.begin() + e * num_columns, all.begin() + (e + 1) * num_columns);
+		return returns_per_experiment;
+	}
+
+	std::vector<std::vector<double>> PolicyComparer::GetReturns(const std::vector<DynaPlex::Policy>& policies, int64_t first_experiment, int64_t number) const
+	{
+		if (first_experiment < 0 || number < 0)
+			throw DynaPlex::Error("PolicyComparer::GetReturns: first_experiment and number should be non-negative");
+		for (auto& policy : policies)
+		{
+			if (!policy) {
+				throw DynaPlex::Error("PolicyComparer: policy should not be null");
+			}
+		}
+		size_t num_columns = control_variate ? 2 * policies.size() : policies.size();
+		auto returns_per_experiment = SimulateDistributed([this, &policies](int64_t offset, int64_t count) {
+			return SimulateExperiments(policies, offset, count);
+			}, first_experiment, number, num_columns);
+		for (auto& returns : returns_per_experiment)
+			returns.resize(policies.size());
+		return returns_per_experiment;
+	}
+
+	void PolicyComparer::ComputeFamilyReturns(std::span<std::vector<double>> ReturnsPerExperiment, const DynaPlex::VarGroup& policy_config, const std::string& parameter, std::span<const double> values, int64_t offset) const
+	{
+		int64_t number = static_cast<int64_t>(ReturnsPerExperiment.size());
+		size_t num_values = values.size();
+		//trajectories are created, seeded and initiated exactly as in ComputeReturns, such that results are identical.
+		auto trajectories = CreateTrajectories(number, offset);
+		InitiateState(trajectories);
+		std::vector<double> returns(number * num_values);
+		mdp->EvolvePolicyFamily(trajectories, policy_config, parameter, values, warmup_periods, periods_per_trajectory, returns);
+		for (int64_t i = 0; i < number; i++)
+		{
+			for (size_t k = 0; k < num_values; k++)
+			{
+				double returnVal = returns[i * num_values + k];
+				if (mdp->DiscountFactor() == 1.0)
+					returnVal /= periods_per_trajectory;
+				ReturnsPerExperiment[i][k] = returnVal;
+			}
+		}
+	}
+
+	std::vector<std::vector<double>> PolicyComparer::SimulateFamily(const DynaPlex::VarGroup& policy_config, const std::string& parameter, const std::vector<double>& values, int64_t offset, int64_t number) const
+	{
+		std::vector<std::vector<double>> returns_per_experiment(number, std::vector<double>(values.size(), 0.0));
+		DynaPlex::Parallel::parallel_compute<std::vector<double>>(returns_per_experiment, [this, &policy_config, &parameter, &values, offset](std::span<std::vector<double>> span, int64_t start) {
+			this->ComputeFamilyReturns(span, policy_config, parameter, values, start + offset);
+			}, system);
+		return returns_per_experiment;
+	}
+
+	bool PolicyComparer::UsesFamilySimulation(const DynaPlex::VarGroup& policy_config, const std::string& parameter) const
+	{
+		return mdp->IsInfiniteHorizon() && !control_variate && !batch_means && !event_log && mdp->ProvidesPolicyFamily(policy_config, parameter);
+	}
+
+	std::vector<DynaPlex::Policy> PolicyComparer::GetFamily(const DynaPlex::Policy& policy, const std::string& parameter, const std::vector<double>& values) const
+	{
+		if (!policy)
+			throw DynaPlex::Error("PolicyComparer: policy should not be null");
+		if (values.empty())
+			throw DynaPlex::Error("PolicyComparer: values of policy family should not be empty");
+		std::vector<DynaPlex::Policy> family;
+		family.reserve(values.size());
+		auto config = policy->GetConfig();
+		for (double value : values)
+		{
+			if (value == std::round(value))
+				config.Set(parameter, static_cast<int64_t>(std::llround(value)));
+			else
+				config.Set(parameter, value);
+			family.push_back(mdp->GetPolicy(config));
+		}
+		return family;
+	}
+
+	std::vector<VarGroup> PolicyComparer::CompareFamily(DynaPlex::Policy policy, const std::string& parameter, const std::vector<double>& values, int64_t index_of_benchmark) const
+	{
+		auto family = GetFamily(policy, parameter, values);
+		int64_t size = family.size();
+		if (!(index_of_benchmark >= -1 && index_of_benchmark < size))
+			throw DynaPlex::Error("PolicyComparer: invalid value for index_of_benchmark; should be -1 or an index corresponding to a value. Actual value: " + std::to_string(index_of_benchmark));
+		auto policy_config = policy->GetConfig();
+		if (!UsesFamilySimulation(policy_config, parameter))
+			return Compare(family, index_of_benchmark);
+		return CompareExperiments(family, index_of_benchmark, [this, &policy_config, &parameter, &values](int64_t offset, int64_t number) {
+			return SimulateFamily(policy_config, parameter, values, offset, number);
+			});
+	}
+
+	std::vector<std::vector<double>> PolicyComparer::GetFamilyReturns(DynaPlex::Policy policy, const std::string& parameter, const std::vector<double>& values, int64_t first_experiment, int64_t number) const
+	{
+		if (!policy)
+			throw DynaPlex::Error("PolicyComparer: policy should not be null");
+		auto policy_config = policy->GetConfig();
+		if (!UsesFamilySimulation(policy_config, parameter))
+			return GetReturns(GetFamily(policy, parameter, values), first_experiment, number);
+		if (first_experiment < 0 || number < 0)
+			throw DynaPlex::Error("PolicyComparer::GetFamilyReturns: first_experiment and number should be non-negative");
+		return SimulateDistributed([this, &policy_config, &parameter, &values](int64_t offset, int64_t count) {
+			return SimulateFamily(policy_config, parameter, values, offset, count);
+			}, first_experiment, number, values.size());
+	}
+
+	DynaPlex::PolicyComparison PolicyComparer::GetComparison(const DynaPlex::ReturnStatistics& statistics, const DynaPlex::ReturnStatistics* reduced, size_t num_policies) const
+	{
+		if (!reduced)
+			return DynaPlex::PolicyComparison{ statistics };
+		if (!control_variate)
+			return DynaPlex::PolicyComparison{ *reduced };
+
+		//regression-adjusted returns Y_i - beta_i * C_i, where control C_i has expectation zero. Since the 
+		//co-moments of returns and controls are available, the adjusted covariances follow without the data. 
+		auto& stats = *reduced;
+		size_t p = num_policies;
+		std::vector<double> betas(p, 0.0), means(p);
+		for (size_t i = 0; i < p; i++)
+		{
+			double variance = stats.Covariance(p + i, p + i);
+			if (variance > 0.0)
+				betas[i] = stats.Covariance(i, p + i) / variance;
+			means[i] = stats.Mean(i) - betas[i] * stats.Mean(p + i);
+		}
+		std::vector<std::vector<double>> covariances(p, std::vector<double>(p));
+		for (size_t i = 0; i < p; i++)
+			for (size_t j = i; j < p; j++)
+			{
+				covariances[i][j] = stats.Covariance(i, j) - betas[j] * stats.Covariance(i, p + j) - betas[i] * stats.Covariance(p + i, j)
+					+ betas[i] * betas[j] * stats.Covariance(p + i, p + j);
+				covariances[j][i] = covariances[i][j];
+			}
+		return DynaPlex::PolicyComparison{ std::move(means), std::move(covariances), static_cast<size_t>(stats.Count()) };
+	}
+
 	std::vector<VarGroup> PolicyComparer::Compare(std::vector<DynaPlex::Policy> policies, int64_t index_of_benchmark) const {
-		std::vector<std::vector<double>> nestedReturnValues{};
-		nestedReturnValues.reserve(policies.size());
 		int64_t minusone = -1, size = policies.size();
 		if (!(index_of_benchmark >= minusone && index_of_benchmark < size))
 		{
 			throw DynaPlex::Error("PolicyComparer: invalid value for index_of_benchmark; should be -1 or an index corresponding to a policy. Actual value: " + std::to_string(index_of_benchmark));
 		}
-		
-		for (int i=0;i<policies.size();i++)
+		for (auto& policy : policies)
 		{
-			auto& policy = policies[i];
 			if (!policy) {
 				throw DynaPlex::Error("PolicyComparer: policy should not be null");
 			}
-			nestedReturnValues.push_back(std::vector<double>(number_of_trajectories, 0.0));
-		
+		}
+		return CompareExperiments(policies, index_of_benchmark, [this, &policies](int64_t offset, int64_t number) {
+			return SimulateExperiments(policies, offset, number);
+			});
+	}
 
-			DynaPlex::Parallel::parallel_compute<double>(nestedReturnValues[i], [this, &policy](std::span<double> span, int64_t start) {
-				this->ComputeReturns(span, policy, start);
-				}, system.HardwareThreads());			
+	std::vector<VarGroup> PolicyComparer::CompareExperiments(const std::vector<DynaPlex::Policy>& policies, int64_t index_of_benchmark, const ExperimentSimulator& simulate) const {
+		int64_t size = policies.size();
+		size_t num_policies = policies.size();
+		//returns are accumulated in streaming fashion, such that memory does not grow with number_of_trajectories.
+		DynaPlex::ReturnStatistics statistics{ num_policies, quantiles };
+		//with variance reduction, estimates are based on a second accumulator, with antithetic pairs averaged and
+		//control variates appended after the returns. statistics then serves as reference for the reduction achieved.
+		bool reduce_variance = antithetic || control_variate;
+		size_t num_columns = control_variate ? 2 * num_policies : num_policies;
+		std::optional<DynaPlex::ReturnStatistics> reduced{};
+		if (reduce_variance)
+			reduced.emplace(num_columns);
+		std::vector<double> pair_average(num_columns);
+		std::vector<std::vector<double>> returns_per_experiment{};
+
+		bool sequential = target_half_width > 0.0 || target_relative_error > 0.0;
+		int64_t per_round = sequential ? std::min(trajectories_per_round, number_of_trajectories) : number_of_trajectories;
+		int64_t trajectories_used = 0;
+		//with batch means, chunks consist of whole runs:
+		int64_t chunk_size = batch_means ? max_chunk_size - max_chunk_size % batches_per_run : max_chunk_size;
+		//for sequential stopping, trajectories are simulated in rounds. Round r uses experiment numbers following 
+		//those of round r-1, such that results are consistent with (a prefix of) those for a fixed budget. 
+		while (trajectories_used < number_of_trajectories)
+		{
+			int64_t round_end = std::min(trajectories_used + per_round, number_of_trajectories);
+			//rounds are processed in chunks, to bound the memory used for returns of a single round.
+			while (trajectories_used < round_end)
+			{
+				int64_t this_chunk = std::min(chunk_size, round_end - trajectories_used);
+				returns_per_experiment = SimulateDistributed(simulate, trajectories_used, this_chunk, num_columns);
+				//folded in order of experiment number, so results do not depend on the number of threads.
+				for (size_t e = 0; e < returns_per_experiment.size(); e++)
+				{
+					auto& returns = returns_per_experiment[e];
+					statistics.Add(std::span<const double>(returns).first(num_policies));
+					if (!reduce_variance)
+						continue;
+					if (!antithetic)
+						reduced->Add(returns);
+					else if (e % 2 == 1)
+					{//chunks start at even experiment numbers, so e-1 and e are an antithetic pair:
+						for (size_t c = 0; c < num_columns; c++)
+							pair_average[c] = 0.5 * (returns_per_experiment[e - 1][c] + returns[c]);
+						reduced->Add(pair_average);
+					}
+				}
+				trajectories_used += this_chunk;
+			}
+			if (!sequential)
+				break;
+			if (TargetPrecisionReached(GetComparison(statistics, reduced ? &*reduced : nullptr, num_policies), size, index_of_benchmark))
+				break;
 		}
 
-		DynaPlex::PolicyComparison comparison{ nestedReturnValues };
+		auto comparison = GetComparison(statistics, reduced ? &*reduced : nullptr, num_policies);
+		DynaPlex::PolicyComparison crude_comparison{ statistics };
 		std::vector<DynaPlex::VarGroup> varGroups;
 		varGroups.reserve(policies.size());
 		for (size_t i = 0; i < policies.size(); i++)
@@ -198,6 +669,23 @@ namespace DynaPlex::Utilities {
 			forPolicy.Add("policy", policy->GetConfig());
 			forPolicy.Add("mean", comparison.mean(i,index_of_benchmark));
 			forPolicy.Add("error", comparison.standardError(i,index_of_benchmark));
+			forPolicy.Add("number_of_trajectories", trajectories_used);
+			if (batch_means)
+				forPolicy.Add("number_of_runs", trajectories_used / batches_per_run);
+			if (reduce_variance && static_cast<int64_t>(i) != index_of_benchmark)
+			{//fraction of variance removed, relative to the same number of trajectories without antithetic or control variates:
+				double crude_error = crude_comparison.standardError(i, index_of_benchmark);
+				double error = comparison.standardError(i, index_of_benchmark);
+				if (crude_error > 0.0)
+					forPolicy.Add("variance_reduction", 1.0 - (error * error) / (crude_error * crude_error));
+			}
+			if (!quantiles.empty())
+			{
+				std::vector<double> estimates(quantiles.size());
+				for (size_t q = 0; q < quantiles.size(); q++)
+					estimates[q] = statistics.Quantile(i, q);
+				forPolicy.Add("quantiles", estimates);
+			}
 			if (i == index_of_benchmark)
 			{
 				forPolicy.Add("benchmark", "yes");
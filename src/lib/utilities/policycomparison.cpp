@@ -19,6 +19,7 @@ namespace DynaPlex {
         if (n == 0) {
             throw DynaPlex::Error("PolicyComparison: nestedVector must have non-zero length.");
         }
+        num_alternatives = n;
 
         // Check for uniformity of inner vector lengths and validity
         size_t len = data.front().size();
@@ -28,39 +29,43 @@ namespace DynaPlex {
                 break;
             }
         }
+        if (isRectangular)
+            num_observations = len;
 
         // Initialize mean and covariance matrices
         means.resize(data.size(), 0.0);
         covariances.resize(data.size(), std::vector<double>(data.size(), 0.0));
 
+        // Compute means
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto& value : data[i]) {
+                means[i] += value;
+            }
+            means[i] /= data[i].size();
+        }
+
         if (isRectangular) {
-            // Compute means
+            // Compute covariance matrix; center the data once, and compute only the upper triangle since the matrix is symmetric.
+            std::vector<std::vector<double>> centered(n, std::vector<double>(len));
             for (size_t i = 0; i < n; ++i) {
-                for (const auto& value : data[i]) {
-                    means[i] += value;
+                for (size_t k = 0; k < len; ++k) {
+                    centered[i][k] = data[i][k] - means[i];
                 }
-                means[i] /= len;
             }
-
-            // Compute covariance matrix
             for (size_t i = 0; i < n; ++i) {
-                for (size_t j = 0; j < n; ++j) {
-                        for (size_t k = 0; k < len; ++k) {
-                            covariances[i][j] += (data[i][k] - means[i]) * (data[j][k] - means[j]);
-                        }
-                    covariances[i][j] /= (len - 1);
+                const double* __restrict x = centered[i].data();
+                for (size_t j = i; j < n; ++j) {
+                    const double* __restrict y = centered[j].data();
+                    double sum{ 0.0 };
+                    for (size_t k = 0; k < len; ++k) {
+                        sum += x[k] * y[k];
+                    }
+                    covariances[i][j] = sum / (len - 1);
+                    covariances[j][i] = covariances[i][j];
                 }
             }
         }
         else {
-            // Compute means
-            for (size_t i = 0; i < n; ++i) {
-                for (const auto& value : data[i]) {
-                    means[i] += value;
-                }
-                means[i] /= data[i].size();
-            }
-
             // Compute covariance matrix, can only compute the diagonals because of the varying inner vector lengths
             for (size_t i = 0; i < n; ++i) {
                     for (size_t k = 0; k < data[i].size(); ++k) {
@@ -71,6 +76,39 @@ namespace DynaPlex {
         }
     }
 
+    PolicyComparison::PolicyComparison(const ReturnStatistics& statistics)
+        : num_alternatives{ statistics.NumAlternatives() }, num_observations{ static_cast<size_t>(statistics.Count()) } {
+        if (num_observations == 0) {
+            throw DynaPlex::Error("PolicyComparison: statistics must contain at least one observation.");
+        }
+        means.resize(num_alternatives);
+        covariances.resize(num_alternatives, std::vector<double>(num_alternatives, 0.0));
+        for (size_t i = 0; i < num_alternatives; ++i) {
+            means[i] = statistics.Mean(i);
+            if (num_observations > 1) {
+                for (size_t j = i; j < num_alternatives; ++j) {
+                    covariances[i][j] = statistics.Covariance(i, j);
+                    covariances[j][i] = covariances[i][j];
+                }
+            }
+        }
+    }
+
+    PolicyComparison::PolicyComparison(std::vector<double> means, std::vector<std::vector<double>> covariances, size_t num_observations)
+        : num_alternatives{ means.size() }, num_observations{ num_observations }, means(std::move(means)), covariances(std::move(covariances)) {
+        if (num_alternatives == 0 || num_observations == 0) {
+            throw DynaPlex::Error("PolicyComparison: means must have non-zero length, and num_observations must be positive.");
+        }
+        if (this->covariances.size() != num_alternatives) {
+            throw DynaPlex::Error("PolicyComparison: covariances must be a square matrix matching the number of means.");
+        }
+        for (const auto& row : this->covariances) {
+            if (row.size() != num_alternatives) {
+                throw DynaPlex::Error("PolicyComparison: covariances must be a square matrix matching the number of means.");
+            }
+        }
+    }
+
     PolicyComparison::PolicyComparison(const std::vector<std::vector<double>>& nestedVector)
         : data(nestedVector){
         Initialize();
@@ -82,7 +120,7 @@ namespace DynaPlex {
    
 
     double PolicyComparison::mean(int64_t i, int64_t j, bool pairedSamples) const {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         if (i >= n || i < 0)
             throw Error("PolicyComparison: index i out of range");
 
@@ -111,12 +149,12 @@ namespace DynaPlex {
     }
     
     double PolicyComparison::standardError(int64_t i, int64_t j, bool pairedSamples) const {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         if (i >= n || i < 0)
             throw Error("PolicyComparison: index i out of range");
 
         if (isRectangular) {
-            size_t len = data.front().size();
+            size_t len = num_observations;
             if (len == 1) {
                 throw Error("PolicyComparison: cannot compute standardError since there is only one datapoint per alternative. ");
             }
@@ -189,7 +227,7 @@ namespace DynaPlex {
     }
 
     void PolicyComparison::ComputeProbabilities(bool ValueBased) {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         probs.resize(n, 0.0);
         
         // discard alternatives with small inner-vector lengths - worse than the others
@@ -233,9 +271,12 @@ namespace DynaPlex {
             }
         }
         else {
+            if (data.empty()) {
+                throw Error("PolicyComparison: rank-based probabilities require per-observation data, which is not retained when constructed from ReturnStatistics.");
+            }
             size_t len{ 0 };
             if (isRectangular) {
-                len = data.front().size();
+                len = num_observations;
             }
             else {
                 for (size_t i = 0; i < n; i++) {
@@ -269,7 +310,7 @@ namespace DynaPlex {
     }
 
     double PolicyComparison::GetProbability(int64_t i) const {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         if (i >= n || i < 0)
             throw Error("PolicyComparison: index i out of range");
         if (probs.empty()) {
@@ -280,14 +321,14 @@ namespace DynaPlex {
     }
 
     void PolicyComparison::ComputeZstatistics(int64_t i) {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         if (i >= n || i < 0)
             throw Error("PolicyComparison: index i out of range");
 
         z_statistics.resize(n, 0.0);
 
         if (isRectangular) {
-            size_t len = data.front().size();
+            size_t len = num_observations;
             if (len == 1) {
                 throw Error("PolicyComparison: cannot compute z-statistics since there is only one datapoint per alternative.");
             }
@@ -342,7 +383,7 @@ namespace DynaPlex {
     }
 
     double PolicyComparison::GetZstatistic(int64_t i) const {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         if (i >= n || i < 0)
             throw Error("PolicyComparison: index i out of range");
         if (z_statistics.empty()) {
@@ -353,14 +394,14 @@ namespace DynaPlex {
     }
 
     std::vector<bool> PolicyComparison::mask(size_t numKeep) {
-        size_t n = data.size();
+        size_t n = num_alternatives;
         std::vector<size_t> sizes;
         std::vector<double> values;
         sizes.reserve(n);
         values.reserve(n);
         for (int64_t i = 0; i < n; i++)
         {
-            sizes.push_back(data[i].size());
+            sizes.push_back(isRectangular ? num_observations : data[i].size());
             values.push_back(mean(i));
         }
 
@@ -0,0 +1,215 @@
+#include "dynaplex/policyoptimizer.h"
+#include "dynaplex/error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace DynaPlex::Utilities {
+
+	int64_t PolicyOptimizer::Parameter::NumValues() const
+	{
+		//small tolerance, such that e.g. min 0.0, max 1.0, step 0.1 includes 1.0:
+		return static_cast<int64_t>(std::floor((max - min) / step + 1e-9)) + 1;
+	}
+
+	PolicyOptimizer::PolicyOptimizer(const DynaPlex::System& system, DynaPlex::MDP mdp, const DynaPlex::VarGroup& config)
+		: mdp{ mdp }, comparer{ system, mdp, config }
+	{
+		DynaPlex::VarGroup::VarGroupVec parameter_configs;
+		if (!config.HasKey("parameters"))
+			throw DynaPlex::Error("PolicyOptimizer: config should include parameters, a list of parameters to optimize.");
+		config.Get("parameters", parameter_configs);
+		if (parameter_configs.empty())
+			throw DynaPlex::Error("PolicyOptimizer: parameters should not be empty.");
+		for (auto& parameter_config : parameter_configs)
+		{
+			Parameter parameter{};
+			parameter_config.Get("name", parameter.name);
+			parameter_config.Get("min", parameter.min);
+			parameter_config.Get("max", parameter.max);
+			parameter_config.GetOrDefault("step", parameter.step, 1.0);
+			parameter_config.GetOrDefault("integer", parameter.integer, true);
+			if (!(parameter.step > 0.0) || parameter.max < parameter.min)
+				throw DynaPlex::Error("PolicyOptimizer: invalid range for parameter " + parameter.name + "; should have min <= max and step > 0.");
+			if (parameter.integer && (parameter.min != std::round(parameter.min) || parameter.step != std::round(parameter.step)))
+				throw DynaPlex::Error("PolicyOptimizer: integer parameter " + parameter.name + " should have integer min and step.");
+			parameters.push_back(parameter);
+		}
+
+		config.GetOrDefault("number_of_trajectories", number_of_trajectories, 4096);
+		config.GetOrDefault("trajectories_per_round", trajectories_per_round, 256);
+		config.GetOrDefault("max_candidates", max_candidates, 4096);
+		config.GetOrDefault("elimination_z", elimination_z, 2.0);
+		if (trajectories_per_round < 2)
+			throw DynaPlex::Error("PolicyOptimizer: trajectories_per_round should be at least 2.");
+		if (elimination_z <= 0.0)
+			throw DynaPlex::Error("PolicyOptimizer: elimination_z should be positive.");
+		//racing works with the raw returns per experiment, which are not paired or adjusted for variance reduction:
+		bool antithetic, control_variate;
+		config.GetOrDefault("antithetic", antithetic, false);
+		config.GetOrDefault("control_variate", control_variate, false);
+		if (antithetic || control_variate)
+			throw DynaPlex::Error("PolicyOptimizer: antithetic and control_variate are not supported.");
+	}
+
+	DynaPlex::VarGroup PolicyOptimizer::Optimize(DynaPlex::Policy policy) const
+	{
+		if (!policy)
+			throw DynaPlex::Error("PolicyOptimizer: policy should not be null");
+		auto base_config = policy->GetConfig();
+
+		int64_t num_candidates = 1;
+		for (auto& parameter : parameters)
+		{
+			num_candidates *= parameter.NumValues();
+			if (num_candidates > max_candidates)
+				throw DynaPlex::Error("PolicyOptimizer: grid has more than max_candidates (" + std::to_string(max_candidates) + ") candidates.");
+		}
+
+		//enumerate the grid, with the first parameter varying fastest:
+		std::vector<DynaPlex::Policy> candidates;
+		std::vector<std::vector<double>> candidate_values;
+		candidates.reserve(num_candidates);
+		candidate_values.reserve(num_candidates);
+		for (int64_t index = 0; index < num_candidates; index++)
+		{
+			auto config = base_config;
+			std::vector<double> values;
+			int64_t remainder = index;
+			for (auto& parameter : parameters)
+			{
+				double value = parameter.min + (remainder % parameter.NumValues()) * parameter.step;
+				remainder /= parameter.NumValues();
+				if (parameter.integer)
+					config.Set(parameter.name, static_cast<int64_t>(std::llround(value)));
+				else
+					config.Set(parameter.name, value);
+				values.push_back(value);
+			}
+			candidates.push_back(mdp->GetPolicy(config));
+			candidate_values.push_back(std::move(values));
+		}
+
+		//racing: all survivors are simulated on the same experiments, so observations are paired across candidates.
+		//Statistics are kept as running sums, such that memory does not grow with the number of trajectories: 
+		//per candidate, the sums of returns and squared returns, and the sums of paired differences d = objective * (leader - candidate)
+		//and of d^2 since the current leader became leader. 
+		struct Sums {
+			double returns{ 0.0 }, squared_returns{ 0.0 }, differences{ 0.0 }, squared_differences{ 0.0 };
+		};
+		double objective = mdp->Objective();
+		std::vector<size_t> survivors(num_candidates);
+		for (size_t i = 0; i < survivors.size(); i++)
+			survivors[i] = i;
+		std::vector<Sums> sums(num_candidates);
+		int64_t trajectories_used = 0, total_trajectories = 0, paired_trajectories = 0;
+		size_t best = 0;
+
+		while (trajectories_used < number_of_trajectories && (survivors.size() > 1 || trajectories_used == 0))
+		{
+			int64_t this_round = std::min(trajectories_per_round, number_of_trajectories - trajectories_used);
+			std::vector<std::vector<double>> returns_per_experiment;
+			if (parameters.size() == 1)
+			{//a single parameter: survivors form a policy family, which the mdp may simulate in lock-step. 
+				std::vector<double> values;
+				values.reserve(survivors.size());
+				for (auto survivor : survivors)
+					values.push_back(candidate_values[survivor][0]);
+				returns_per_experiment = comparer.GetFamilyReturns(policy, parameters[0].name, values, trajectories_used, this_round);
+			}
+			else
+			{
+				std::vector<DynaPlex::Policy> policies;
+				policies.reserve(survivors.size());
+				for (auto survivor : survivors)
+					policies.push_back(candidates[survivor]);
+				returns_per_experiment = comparer.GetReturns(policies, trajectories_used, this_round);
+			}
+			for (auto& experiment : returns_per_experiment)
+				for (size_t s = 0; s < survivors.size(); s++)
+				{
+					sums[survivors[s]].returns += experiment[s];
+					sums[survivors[s]].squared_returns += experiment[s] * experiment[s];
+				}
+			trajectories_used += this_round;
+			total_trajectories += this_round * static_cast<int64_t>(survivors.size());
+
+			//the best survivor has the highest objective * mean:
+			size_t leader = best;
+			size_t best_column = 0;
+			double best_score = -std::numeric_limits<double>::infinity();
+			for (size_t s = 0; s < survivors.size(); s++)
+			{
+				double score = objective * sums[survivors[s]].returns / trajectories_used;
+				if (score > best_score)
+				{
+					best_score = score;
+					best = survivors[s];
+					best_column = s;
+				}
+			}
+			if (best != leader)
+			{//differences with respect to the new leader are accumulated from this round onwards:
+				for (auto survivor : survivors)
+					sums[survivor].differences = sums[survivor].squared_differences = 0.0;
+				paired_trajectories = 0;
+			}
+			for (auto& experiment : returns_per_experiment)
+				for (size_t s = 0; s < survivors.size(); s++)
+				{
+					double difference = objective * (experiment[best_column] - experiment[s]);
+					sums[survivors[s]].differences += difference;
+					sums[survivors[s]].squared_differences += difference * difference;
+				}
+			paired_trajectories += this_round;
+			if (paired_trajectories < 2)
+				continue;
+
+			//eliminate candidates that are significantly worse than the best, based on paired differences:
+			std::vector<size_t> remaining;
+			double n = static_cast<double>(paired_trajectories);
+			for (auto survivor : survivors)
+			{
+				if (survivor == best)
+				{
+					remaining.push_back(survivor);
+					continue;
+				}
+				auto& survivor_sums = sums[survivor];
+				double mean = survivor_sums.differences / n;
+				double variance = std::max(0.0, (survivor_sums.squared_differences - n * mean * mean) / (n - 1.0));
+				double error = std::sqrt(variance / n);
+				bool worse = error > 0.0 ? mean / error > elimination_z : mean > 0.0;
+				if (!worse)
+					remaining.push_back(survivor);
+			}
+			survivors = std::move(remaining);
+		}
+
+		double n = static_cast<double>(trajectories_used);
+		double mean = sums[best].returns / n;
+		double variance = n > 1.0 ? std::max(0.0, (sums[best].squared_returns - n * mean * mean) / (n - 1.0)) : 0.0;
+		double error = std::sqrt(variance / n);
+
+		DynaPlex::VarGroup parameter_values{};
+		for (size_t p = 0; p < parameters.size(); p++)
+		{
+			if (parameters[p].integer)
+				parameter_values.Add(parameters[p].name, static_cast<int64_t>(std::llround(candidate_values[best][p])));
+			else
+				parameter_values.Add(parameters[p].name, candidate_values[best][p]);
+		}
+
+		DynaPlex::VarGroup result{};
+		result.Add("policy", candidates[best]->GetConfig());
+		result.Add("parameters", parameter_values);
+		result.Add("mean", mean);
+		result.Add("error", error);
+		result.Add("number_of_candidates", num_candidates);
+		result.Add("survivors", static_cast<int64_t>(survivors.size()));
+		result.Add("number_of_trajectories", trajectories_used);
+		result.Add("total_trajectories", total_trajectories);
+		return result;
+	}
+
+}//namespace DynaPlex::Utilities
@@ -0,0 +1,242 @@
+#include "dynaplex/returnstatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace DynaPlex {
+
+    ReturnStatistics::P2Quantile::P2Quantile(double probability)
+        : probability{ probability }
+    {
+    }
+
+    void ReturnStatistics::P2Quantile::Initialize() {
+        std::sort(std::begin(heights), std::end(heights));
+        double p = probability;
+        for (int i = 0; i < 5; ++i)
+            positions[i] = i + 1.0;
+        double init_desired[5] = { 1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0 };
+        double init_increments[5] = { 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 };
+        std::copy(std::begin(init_desired), std::end(init_desired), desired);
+        std::copy(std::begin(init_increments), std::end(init_increments), increments);
+    }
+
+    double ReturnStatistics::P2Quantile::Parabolic(int i, double d) const {
+        return heights[i] + d / (positions[i + 1] - positions[i - 1]) *
+            ((positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i])
+                + (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+    }
+
+    double ReturnStatistics::P2Quantile::Linear(int i, int d) const {
+        return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+    }
+
+    void ReturnStatistics::P2Quantile::Add(double x) {
+        if (count < 5)
+        {
+            heights[count++] = x;
+            if (count == 5)
+                Initialize();
+            return;
+        }
+        count++;
+        //find the cell k such that heights[k] <= x < heights[k+1], adjusting extreme markers if needed.
+        int k;
+        if (x < heights[0]) {
+            heights[0] = x;
+            k = 0;
+        }
+        else if (x >= heights[4]) {
+            heights[4] = x;
+            k = 3;
+        }
+        else {
+            k = 0;
+            while (x >= heights[k + 1])
+                ++k;
+        }
+        for (int i = k + 1; i < 5; ++i)
+            positions[i] += 1.0;
+        for (int i = 0; i < 5; ++i)
+            desired[i] += increments[i];
+
+        //adjust the heights of the middle markers if they are off their desired position.
+        for (int i = 1; i < 4; ++i)
+        {
+            double d = desired[i] - positions[i];
+            if ((d >= 1.0 && positions[i + 1] - positions[i] > 1.0) || (d <= -1.0 && positions[i - 1] - positions[i] < -1.0))
+            {
+                int sign = d >= 0.0 ? 1 : -1;
+                double candidate = Parabolic(i, sign);
+                if (heights[i - 1] < candidate && candidate < heights[i + 1])
+                    heights[i] = candidate;
+                else
+                    heights[i] = Linear(i, sign);
+                positions[i] += sign;
+            }
+        }
+    }
+
+    void ReturnStatistics::P2Quantile::Merge(const P2Quantile& other) {
+        if (other.count < 5)
+        {
+            for (int64_t i = 0; i < other.count; ++i)
+                Add(other.heights[i]);
+            return;
+        }
+        if (count < 5)
+        {
+            P2Quantile merged = other;
+            for (int64_t i = 0; i < count; ++i)
+                merged.Add(heights[i]);
+            *this = merged;
+            return;
+        }
+        //approximate: count-weighted marker heights, and markers placed at their desired positions for the total count.
+        double total = static_cast<double>(count + other.count);
+        double weight = count / total;
+        heights[0] = std::min(heights[0], other.heights[0]);
+        heights[4] = std::max(heights[4], other.heights[4]);
+        for (int i = 1; i < 4; ++i)
+            heights[i] = weight * heights[i] + (1.0 - weight) * other.heights[i];
+        count += other.count;
+        for (int i = 0; i < 5; ++i)
+        {
+            desired[i] = 1.0 + (total - 1.0) * increments[i];
+            positions[i] = std::round(desired[i]);
+        }
+        //markers must have distinct positions:
+        for (int i = 1; i < 4; ++i)
+            positions[i] = std::clamp(positions[i], positions[i - 1] + 1.0, total - (4 - i));
+    }
+
+    double ReturnStatistics::P2Quantile::Estimate() const {
+        if (count == 0)
+            throw DynaPlex::Error("ReturnStatistics: cannot estimate quantile without observations.");
+        if (count >= 5)
+            return heights[2];
+        //small sample: interpolate between order statistics.
+        double sorted[5];
+        std::copy(heights, heights + count, sorted);
+        std::sort(sorted, sorted + count);
+        double position = probability * (count - 1);
+        int64_t lower = static_cast<int64_t>(std::floor(position));
+        int64_t upper = std::min(lower + 1, count - 1);
+        return sorted[lower] + (position - lower) * (sorted[upper] - sorted[lower]);
+    }
+
+    ReturnStatistics::ReturnStatistics(size_t num_alternatives, std::vector<double> quantile_probabilities)
+        : num_alternatives{ num_alternatives }, means(num_alternatives, 0.0),
+        comoments(num_alternatives* (num_alternatives + 1) / 2, 0.0), deltas(num_alternatives, 0.0),
+        quantile_probabilities{ std::move(quantile_probabilities) }
+    {
+        if (num_alternatives == 0)
+            throw DynaPlex::Error("ReturnStatistics: num_alternatives must be positive.");
+        for (double probability : this->quantile_probabilities)
+        {
+            if (!(probability > 0.0 && probability < 1.0))
+                throw DynaPlex::Error("ReturnStatistics: quantile probabilities must be in (0,1), got " + std::to_string(probability) + ".");
+        }
+        quantiles.reserve(num_alternatives * this->quantile_probabilities.size());
+        for (size_t i = 0; i < num_alternatives; ++i)
+            for (double probability : this->quantile_probabilities)
+                quantiles.emplace_back(probability);
+    }
+
+    size_t ReturnStatistics::IndexOf(size_t i, size_t j) const {
+        if (i > j)
+            std::swap(i, j);
+        return i * num_alternatives - i * (i - 1) / 2 + (j - i);
+    }
+
+    void ReturnStatistics::Add(std::span<const double> observation) {
+        if (observation.size() != num_alternatives)
+            throw DynaPlex::Error("ReturnStatistics::Add - observation has " + std::to_string(observation.size()) + " values, expected " + std::to_string(num_alternatives) + ".");
+        count++;
+        double factor = static_cast<double>(count - 1) / count;
+        double* __restrict delta = deltas.data();
+        for (size_t i = 0; i < num_alternatives; ++i)
+        {
+            delta[i] = observation[i] - means[i];
+            means[i] += delta[i] / count;
+        }
+        //C_ij += (x_i - old_mean_i) * (x_j - new_mean_j) = delta_i * delta_j * (n-1)/n; contiguous, so vectorized over j.
+        double* __restrict comoment = comoments.data();
+        for (size_t i = 0; i < num_alternatives; ++i)
+        {
+            const double scaled = delta[i] * factor;
+            for (size_t j = i; j < num_alternatives; ++j)
+                comoment[j - i] += scaled * delta[j];
+            comoment += num_alternatives - i;
+        }
+        size_t num_quantiles = quantile_probabilities.size();
+        for (size_t i = 0; i < num_alternatives; ++i)
+            for (size_t q = 0; q < num_quantiles; ++q)
+                quantiles[i * num_quantiles + q].Add(observation[i]);
+    }
+
+    void ReturnStatistics::Merge(const ReturnStatistics& other) {
+        if (other.num_alternatives != num_alternatives || other.quantile_probabilities != quantile_probabilities)
+            throw DynaPlex::Error("ReturnStatistics::Merge - accumulators are not compatible.");
+        if (other.count == 0)
+            return;
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+        double total = static_cast<double>(count + other.count);
+        double factor = static_cast<double>(count) * other.count / total;
+        for (size_t i = 0; i < num_alternatives; ++i)
+            deltas[i] = other.means[i] - means[i];
+        const double* __restrict delta = deltas.data();
+        double* __restrict comoment = comoments.data();
+        const double* __restrict other_comoment = other.comoments.data();
+        for (size_t i = 0; i < num_alternatives; ++i)
+        {
+            const double scaled = delta[i] * factor;
+            for (size_t j = i; j < num_alternatives; ++j)
+                comoment[j - i] += other_comoment[j - i] + scaled * delta[j];
+            comoment += num_alternatives - i;
+            other_comoment += num_alternatives - i;
+        }
+        for (size_t i = 0; i < num_alternatives; ++i)
+            means[i] += delta[i] * other.count / total;
+        count += other.count;
+        for (size_t k = 0; k < quantiles.size(); ++k)
+            quantiles[k].Merge(other.quantiles[k]);
+    }
+
+    size_t ReturnStatistics::NumAlternatives() const {
+        return num_alternatives;
+    }
+
+    int64_t ReturnStatistics::Count() const {
+        return count;
+    }
+
+    double ReturnStatistics::Mean(size_t i) const {
+        if (i >= num_alternatives)
+            throw DynaPlex::Error("ReturnStatistics: index i out of range");
+        return means[i];
+    }
+
+    double ReturnStatistics::Covariance(size_t i, size_t j) const {
+        if (i >= num_alternatives || j >= num_alternatives)
+            throw DynaPlex::Error("ReturnStatistics: index out of range");
+        if (count < 2)
+            throw DynaPlex::Error("ReturnStatistics: cannot compute covariance with fewer than two observations.");
+        return comoments[IndexOf(i, j)] / (count - 1);
+    }
+
+    const std::vector<double>& ReturnStatistics::QuantileProbabilities() const {
+        return quantile_probabilities;
+    }
+
+    double ReturnStatistics::Quantile(size_t i, size_t q) const {
+        if (i >= num_alternatives || q >= quantile_probabilities.size())
+            throw DynaPlex::Error("ReturnStatistics: index out of range");
+        return quantiles[i * quantile_probabilities.size() + q].Estimate();
+    }
+
+}  // namespace DynaPlex
@@ -0,0 +1,179 @@
+#include "dynaplex/statepool.h"
+#include "dynaplex/parallel_execute.h"
+#include "dynaplex/error.h"
+#include "dynaplex/bytestream.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace DynaPlex::Utilities {
+
+	StatePool::StatePool(const DynaPlex::System& system, DynaPlex::MDP mdp, DynaPlex::Policy policy, const DynaPlex::VarGroup& config)
+		: mdp{ mdp }
+	{
+		if (!mdp)
+			throw DynaPlex::Error("StatePool: mdp should not be null");
+		if (!policy)
+			throw DynaPlex::Error("StatePool: policy should not be null");
+		if (!mdp->IsInfiniteHorizon())
+			throw DynaPlex::Error("StatePool: mdp " + mdp->TypeIdentifier() + " has finite horizon; steady-state pools are only available for infinite horizon mdps.");
+		mdp_identifier = mdp->Identifier();
+		policy_config = policy->GetConfig();
+
+		int64_t number_of_states;
+		config.GetOrDefault("number_of_states", number_of_states, 1024);
+		config.GetOrDefault("burn_in_periods", burn_in_periods, 1024);
+		config.GetOrDefault("states_per_run", states_per_run, 64);
+		config.GetOrDefault("spacing_periods", spacing_periods, 16);
+		config.GetOrDefault("pool_seed", pool_seed, 25011990);
+		if (number_of_states < 1 || states_per_run < 1)
+			throw DynaPlex::Error("StatePool: number_of_states and states_per_run should be positive.");
+		if (burn_in_periods < 0 || spacing_periods < 1)
+			throw DynaPlex::Error("StatePool: burn_in_periods should be non-negative, and spacing_periods positive.");
+		if (pool_seed < 0)
+			throw DynaPlex::Error("StatePool: pool_seed should be non-negative.");
+
+		int64_t number_of_runs = (number_of_states + states_per_run - 1) / states_per_run;
+		std::vector<std::vector<DynaPlex::dp_State>> runs(number_of_runs);
+		DynaPlex::Parallel::parallel_compute<std::vector<DynaPlex::dp_State>>(runs, [this, &policy](std::span<std::vector<DynaPlex::dp_State>> span, int64_t start) {
+			this->GenerateRuns(span, policy, start);
+			}, system);
+		//runs are concatenated in order, so the pool does not depend on the number of threads:
+		states.reserve(number_of_states);
+		for (auto& run : runs)
+			for (auto& state : run)
+				if (static_cast<int64_t>(states.size()) < number_of_states)
+					states.push_back(std::move(state));
+	}
+
+	void StatePool::GenerateRuns(std::span<std::vector<DynaPlex::dp_State>> runs, const DynaPlex::Policy& policy, int64_t first_run) const
+	{
+		for (size_t r = 0; r < runs.size(); r++)
+		{
+			int64_t run = first_run + static_cast<int64_t>(r);
+			DynaPlex::Trajectory trajectory{ run };
+			//training streams (eval=false), such that runs do not coincide with evaluation trajectories that use the same seed:
+			trajectory.RNGProvider.SeedEventStreams(false, pool_seed, run);
+			mdp->InitiateState({ &trajectory,1 });
+			//evolves until the trajectory is at least at period and awaits an action:
+			auto evolve_until = [&](int64_t period) {
+				while (true)
+				{
+					if (mdp->IncorporateUntilAction({ &trajectory,1 }))
+					{
+						if (trajectory.PeriodCount >= period)
+							return;
+						mdp->IncorporateAction({ &trajectory,1 }, policy);
+					}
+					else if (trajectory.Category.IsFinal())
+						throw DynaPlex::Error("StatePool: trajectory has Category.IsFinal() but mdp IsInfiniteHorizon().");
+				}
+			};
+			int64_t period = burn_in_periods;
+			runs[r].reserve(states_per_run);
+			for (int64_t k = 0; k < states_per_run; k++)
+			{
+				evolve_until(period);
+				runs[r].push_back(trajectory.GetState()->Clone());
+				period = trajectory.PeriodCount + spacing_periods;
+			}
+		}
+	}
+
+	namespace {
+		const std::string pool_magic = "DynaPlex::StatePool";
+		constexpr uint64_t pool_version = 1;
+
+		bool CanLoadStates(const DynaPlex::MDP& mdp) {
+			return mdp->ProvidesStateSerialization() || mdp->SupportsGetStateFromVarGroup();
+		}
+	}
+
+	StatePool::StatePool(DynaPlex::MDP mdp, const std::string& file_path)
+		: mdp{ mdp }
+	{
+		if (!mdp)
+			throw DynaPlex::Error("StatePool: mdp should not be null");
+		if (!CanLoadStates(mdp))
+			throw DynaPlex::Error("StatePool: cannot load pool, since mdp " + mdp->TypeIdentifier() + " provides neither a binary codec for states nor GetState(const VarGroup&).");
+		std::ifstream file(file_path, std::ios::binary);
+		if (!file.is_open())
+			throw DynaPlex::Error("StatePool: cannot open " + file_path);
+		std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		DynaPlex::ByteSource source{ bytes };
+		if (source.Read<std::string>() != pool_magic || source.Read<uint64_t>() != pool_version)
+			throw DynaPlex::Error("StatePool: " + file_path + " is not a state pool, or was saved by an incompatible version.");
+		source.Read(mdp_identifier);
+		if (mdp_identifier != mdp->Identifier())
+			throw DynaPlex::Error("StatePool: pool in " + file_path + " was generated for mdp " + mdp_identifier + ", not for " + mdp->Identifier() + ".");
+		source.Read(policy_config, pool_seed, burn_in_periods, states_per_run, spacing_periods);
+		states = mdp->DeserializeStates(source.Read<std::vector<uint8_t>>());
+		if (states.empty())
+			throw DynaPlex::Error("StatePool: pool in " + file_path + " contains no states.");
+	}
+
+	void StatePool::SaveToFile(const std::string& file_path) const
+	{
+		if (!CanLoadStates(mdp))
+			throw DynaPlex::Error("StatePool: saved pool could not be loaded, since mdp " + mdp->TypeIdentifier() + " provides neither a binary codec for states nor GetState(const VarGroup&).");
+		std::vector<uint8_t> bytes;
+		DynaPlex::ByteSink sink{ bytes };
+		sink.Write(pool_magic, pool_version, mdp_identifier, policy_config, pool_seed, burn_in_periods, states_per_run, spacing_periods,
+			mdp->SerializeStates(states));
+		std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			throw DynaPlex::Error("StatePool: failed to open file for writing: " + file_path);
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		if (!file)
+			throw DynaPlex::Error("StatePool: failed to write " + file_path);
+	}
+
+	std::string StatePool::Key(const DynaPlex::MDP& mdp, const DynaPlex::VarGroup& policy_config)
+	{
+		return mdp->Identifier() + "_" + policy_config.UniqueIdentifier();
+	}
+
+	std::string StatePool::Key() const
+	{
+		return mdp_identifier + "_" + policy_config.UniqueIdentifier();
+	}
+
+	const std::string& StatePool::MDPIdentifier() const
+	{
+		return mdp_identifier;
+	}
+
+	const DynaPlex::VarGroup& StatePool::PolicyConfig() const
+	{
+		return policy_config;
+	}
+
+	int64_t StatePool::Seed() const
+	{
+		return pool_seed;
+	}
+
+	size_t StatePool::Size() const
+	{
+		return states.size();
+	}
+
+	const DynaPlex::dp_State& StatePool::Draw(DynaPlex::RNG& rng) const
+	{
+		size_t index = static_cast<size_t>(rng.genUniform() * states.size());
+		return states[std::min(index, states.size() - 1)];
+	}
+
+	const DynaPlex::dp_State& StatePool::Draw(int64_t key) const
+	{
+		DynaPlex::RNG rng(true, pool_seed, key);
+		return Draw(rng);
+	}
+
+	void StatePool::InitiateState(std::span<DynaPlex::Trajectory> trajectories) const
+	{
+		for (auto& traj : trajectories)
+			mdp->InitiateState({ &traj,1 }, Draw(traj.ExternalIndex));
+	}
+
+}//namespace DynaPlex::Utilities
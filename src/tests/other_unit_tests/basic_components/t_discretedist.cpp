@@ -2,12 +2,14 @@
 #include <deque>
 #include <gtest/gtest.h>
 #include <vector>
+#include <span>
 #include <iterator>
 #include "dynaplex/error.h"
 #include "dynaplex/modelling/discretedist.h"
 #include "dynaplex/rng.h"
 #include "dynaplex/policycomparison.h"
 #include <numeric>
+#include <cmath>
 #include <boost/math/distributions/binomial.hpp>
 #include <boost/math/distributions/negative_binomial.hpp>
 namespace DynaPlex::Tests {
@@ -250,6 +252,100 @@ namespace DynaPlex::Tests {
 
 
 
+	TEST(discretedist, AliasSampling) {
+		std::vector<double> probs = { 0.1, 0.2, 0.4, 0.1, 0.1, 0.0, 0.0, 0.0, 0.1 };
+		auto dist = DiscreteDist::GetCustomDist(probs, -3);
+		DynaPlex::RNG rng{ true, 12345 };
+		int64_t numSamples = 200000;
+		std::vector<int64_t> samples(numSamples);
+		dist.GetSamples(rng, samples);
+		std::vector<int64_t> counts(probs.size(), 0);
+		for (auto sample : samples)
+		{
+			ASSERT_GE(sample, dist.Min());
+			ASSERT_LE(sample, dist.Max());
+			counts[sample - dist.Min()]++;
+		}
+		for (size_t i = 0; i < probs.size(); i++)
+		{
+			double sd = std::sqrt(probs[i] * (1.0 - probs[i]) / numSamples);
+			EXPECT_NEAR(static_cast<double>(counts[i]) / numSamples, probs[i], 4.0 * sd + 1e-12);
+		}
+
+		//batched sampling is equivalent to repeated sampling:
+		DynaPlex::RNG rng1{ true, 777 }, rng2{ true, 777 };
+		std::vector<int64_t> batch(64);
+		dist.GetSamples(rng1, batch);
+		for (auto sample : batch)
+			EXPECT_EQ(sample, dist.GetSample(rng2));
+
+		//degenerate distributions:
+		auto constant = DiscreteDist::GetConstantDist(5);
+		for (int i = 0; i < 10; i++)
+			EXPECT_EQ(constant.GetSample(rng), 5);
+	}
+
+	TEST(discretedist, AntitheticSampling) {
+		//with monotone sampling, mirrored streams give strongly negatively correlated samples:
+		for (double mean : { 2.0, 10.0 })
+		{
+			auto dist = DiscreteDist::GetPoissonDist(mean);
+			DynaPlex::RNG rng{ true, 4321 }, mirrored{ true, 4321 };
+			rng.SetMonotone(true);
+			mirrored.SetMonotone(true);
+			mirrored.SetAntithetic(true);
+			int64_t numSamples = 100000;
+			std::vector<int64_t> samples(numSamples), mirrored_samples(numSamples);
+			dist.GetSamples(rng, std::span<int64_t>(samples).first(numSamples / 2));
+			for (int64_t i = 0; i < numSamples / 2; i++)
+				mirrored_samples[i] = dist.GetSample(mirrored);
+			std::vector<DynaPlex::RNG*> rngs(numSamples / 2, &rng), mirrored_rngs(numSamples / 2, &mirrored);
+			dist.GetSamples(rngs, std::span<int64_t>(samples).last(numSamples / 2));
+			dist.GetSamples(mirrored_rngs, std::span<int64_t>(mirrored_samples).last(numSamples / 2));
+
+			double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_yy = 0.0, sum_xy = 0.0;
+			for (int64_t i = 0; i < numSamples; i++)
+			{
+				double x = static_cast<double>(samples[i]), y = static_cast<double>(mirrored_samples[i]);
+				sum_x += x; sum_y += y; sum_xx += x * x; sum_yy += y * y; sum_xy += x * y;
+			}
+			double n = static_cast<double>(numSamples);
+			double cov = sum_xy / n - (sum_x / n) * (sum_y / n);
+			double correlation = cov / std::sqrt((sum_xx / n - (sum_x / n) * (sum_x / n)) * (sum_yy / n - (sum_y / n) * (sum_y / n)));
+			EXPECT_LT(correlation, -0.8) << "mean " << mean;
+			//monotone samples still follow the distribution:
+			EXPECT_NEAR(sum_x / n, mean, 0.05);
+			EXPECT_NEAR(sum_y / n, mean, 0.05);
+		}
+	}
+
+	TEST(discretedist, AddN) {
+		auto poisson = DiscreteDist::GetPoissonDist(4.0);
+		auto repeated = DiscreteDist::GetZeroDist();
+		for (int64_t k = 0; k <= 9; k++)
+		{
+			auto sum = poisson.AddN(k);
+			ASSERT_EQ(sum.Min(), repeated.Min());
+			ASSERT_EQ(sum.Max(), repeated.Max());
+			for (int64_t i = sum.Min(); i <= sum.Max(); i++)
+				EXPECT_NEAR(sum.ProbabilityAt(i), repeated.ProbabilityAt(i), 1e-12);
+			EXPECT_NEAR(sum.Expectation(), 4.0 * k, 1e-9);
+			//cached results are identical:
+			EXPECT_EQ(poisson.AddN(k), sum);
+			repeated = repeated.Add(poisson);
+		}
+		EXPECT_THROW(poisson.AddN(-1), DynaPlex::Error);
+
+		//large supports are convolved using FFT, with the same results up to rounding:
+		auto large = DiscreteDist::GetPoissonDist(200.0);
+		auto fft_sum = large.AddN(30);
+		EXPECT_NEAR(fft_sum.Expectation(), 6000.0, 1e-6);
+		EXPECT_NEAR(fft_sum.Variance(), 6000.0, 1e-4);
+		auto direct = DiscreteDist::GetPoissonDist(6000.0);
+		for (double alpha : {0.05, 0.5, 0.9, 0.99})
+			EXPECT_NEAR(fft_sum.Fractile(alpha), direct.Fractile(alpha), 1);
+	}
+
 	TEST(discretedist, fractile) {
 		// Let's consider a simple discrete distribution for the test
 		std::vector<double> probs = { 0.1, 0.2, 0.4, 0.2, 0.1 };  // A bell-shaped probability mass function
@@ -163,4 +163,54 @@ namespace DynaPlex::Tests {
 		EXPECT_THROW(jointDist.FindPositionInJointQtys({ 4, 1, 3 }), DynaPlex::Error);
 	}
 
+	TEST(jointdiscretedist, product_form) {
+		auto first = DiscreteDist::GetCustomDist({ 0.2, 0.0, 0.8 }, 1);	// 1, 2 (never), 3
+		auto second = DiscreteDist::GetPoissonDist(2.0);
+		auto third = DiscreteDist::GetCustomDist({ 0.5, 0.5 }, -1);
+		JointDiscreteDist jointDist({ first, second, third });
+		ASSERT_EQ(jointDist.NumComponents(), 3);
+
+		// product-form probabilities, also for quantities outside the support:
+		ASSERT_NEAR(jointDist.ProbabilityAtFromQtys({ 3, 2, 0 }), 0.8 * second.ProbabilityAt(2) * 0.5, 1e-12);
+		ASSERT_EQ(jointDist.ProbabilityAtFromQtys({ 2, 2, 0 }), 0.0);
+		EXPECT_THROW(jointDist.ProbabilityAtFromQtys({ 3, 2 }), DynaPlex::Error);
+
+		// sampling is component-wise, and matches the joint probabilities:
+		DynaPlex::RNG rng{ true, 11 };
+		int64_t samples = 200000, hits = 0;
+		for (int64_t i = 0; i < samples; i++)
+		{
+			auto qtys = jointDist.GetSampleTuple<3>(rng);
+			ASSERT_NE(qtys[0], 2);
+			if (qtys == std::array<int64_t, 3>{ 3, 2, 0 })
+				hits++;
+		}
+		ASSERT_NEAR(static_cast<double>(hits) / samples, jointDist.ProbabilityAtFromQtys({ 3, 2, 0 }), 0.005);
+		std::vector<int64_t> wrong_size(2);
+		EXPECT_THROW(jointDist.GetSampleQtys(rng, wrong_size), DynaPlex::Error);
+
+		// the enumerated support excludes combinations with zero probability, and agrees with the positions:
+		auto tuples = jointDist.TupleProbabilities<3>();
+		ASSERT_EQ(static_cast<int64_t>(tuples.size()), jointDist.DistinctValueCount());
+		double sum{ 0.0 };
+		for (size_t pos = 0; pos < tuples.size(); pos++)
+		{
+			const auto& [qtys, prob] = tuples[pos];
+			ASSERT_NE(qtys[0], 2);
+			std::vector<int64_t> vec(qtys.begin(), qtys.end());
+			ASSERT_EQ(jointDist.GetQtysForJointDist(pos), vec);
+			ASSERT_EQ(jointDist.FindPositionInJointQtys(vec), static_cast<int64_t>(pos));
+			ASSERT_NEAR(prob, jointDist.ProbabilityAtFromQtys(vec), 1e-12);
+			sum += prob;
+		}
+		ASSERT_NEAR(sum, 1.0, 1e-8);
+		EXPECT_THROW(jointDist.TupleProbabilities<2>(), DynaPlex::Error);
+
+		// copies share the enumerated support, and compare equal:
+		JointDiscreteDist copy = jointDist;
+		ASSERT_EQ(copy, jointDist);
+		ASSERT_EQ(copy.DistinctValueCount(), jointDist.DistinctValueCount());
+		ASSERT_FALSE(copy == JointDiscreteDist(first, second));
+	}
+
 } // namespace DynaPlex::Tests
@@ -228,4 +228,61 @@ namespace DynaPlex::Tests {
 
 
 
+	TEST(queue, InlineCapacity) {
+		Queue<int64_t, 4> queue{};
+		EXPECT_EQ(queue.Capacity(), 4);
+		// wrap around the inline ring buffer:
+		for (int64_t i = 0; i < 10; i++)
+		{
+			queue.push_back(i);
+			if (queue.at(0) < i - 2)
+				queue.pop_front();
+		}
+		EXPECT_EQ(queue.Capacity(), 4);
+		std::vector<int64_t> expected = { 7, 8, 9 };
+		EXPECT_TRUE(std::equal(queue.begin(), queue.end(), expected.begin()));
+		EXPECT_EQ(queue.sum(), 24);
+
+		// copies and moves of inline queues are independent:
+		auto copy = queue;
+		copy.front() = 0;
+		EXPECT_EQ(queue.front(), 7);
+		auto moved = std::move(copy);
+		EXPECT_EQ(moved.front(), 0);
+		EXPECT_TRUE(copy.IsEmpty());
+		copy.push_back(3);
+		EXPECT_EQ(copy.back(), 3);
+
+		// beyond the inline capacity, items move to the heap:
+		for (int64_t i = 10; i < 14; i++)
+			queue.push_back(i);
+		EXPECT_EQ(queue.Capacity(), 8);
+		std::vector<int64_t> expected2 = { 7, 8, 9, 10, 11, 12, 13 };
+		EXPECT_TRUE(std::equal(queue.begin(), queue.end(), expected2.begin()));
+		Queue<int64_t, 4> heap_moved = std::move(queue);
+		EXPECT_EQ(heap_moved.at(6), 13);
+		EXPECT_EQ(queue.Capacity(), 4);
+		queue = heap_moved;
+		EXPECT_EQ(queue, heap_moved);
+		queue.clear();
+		EXPECT_EQ(queue.Capacity(), 4);
+		EXPECT_TRUE(queue.IsEmpty());
+
+		Queue<std::string, 2> strings = { "a", "b" };
+		strings.push_back("c");
+		EXPECT_EQ(strings.pop_front(), "a");
+		EXPECT_EQ(strings.at(1), "c");
+
+		// VarGroup conversion is identical to that of heap-based queues:
+		Queue<int64_t> heap_queue = { 1, 2, 3 };
+		Queue<int64_t, 8> inline_queue = { 1, 2, 3 };
+		VarGroup heap_vars, inline_vars;
+		heap_vars.Add("queue", heap_queue);
+		inline_vars.Add("queue", inline_queue);
+		EXPECT_EQ(heap_vars, inline_vars);
+		Queue<int64_t, 8> loaded;
+		inline_vars.Get("queue", loaded);
+		EXPECT_EQ(loaded, inline_queue);
+	}
+
 } // namespace DynaPlex::Tests
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "dynaplex/returnstatistics.h"
+#include "dynaplex/policycomparison.h"
+#include "dynaplex/rng.h"
+#include "dynaplex/error.h"
+
+namespace DynaPlex::Tests {
+
+	TEST(ReturnStatistics, MatchesPolicyComparison)
+	{
+		DynaPlex::RNG rng(false, 26071983);
+		size_t num_alternatives = 5, num_observations = 1000;
+		std::vector<std::vector<double>> data(num_alternatives, std::vector<double>(num_observations));
+		ReturnStatistics statistics{ num_alternatives };
+		ReturnStatistics first{ num_alternatives }, second{ num_alternatives };
+		std::vector<double> observation(num_alternatives);
+		for (size_t k = 0; k < num_observations; ++k)
+		{
+			//correlated alternatives, with large common offset to test numerical stability:
+			double common = rng.genUniform();
+			for (size_t i = 0; i < num_alternatives; ++i)
+			{
+				observation[i] = 1e6 + common * (i + 1) + rng.genUniform();
+				data[i][k] = observation[i];
+			}
+			statistics.Add(observation);
+			(k < 300 ? first : second).Add(observation);
+		}
+		first.Merge(second);
+
+		PolicyComparison comparison{ data };
+		PolicyComparison streaming{ statistics };
+		EXPECT_EQ(statistics.Count(), num_observations);
+		EXPECT_EQ(first.Count(), num_observations);
+		for (size_t i = 0; i < num_alternatives; ++i)
+		{
+			EXPECT_NEAR(statistics.Mean(i), comparison.mean(i), 1e-7);
+			EXPECT_NEAR(first.Mean(i), comparison.mean(i), 1e-7);
+			EXPECT_NEAR(streaming.standardError(i), comparison.standardError(i), 1e-9);
+			for (size_t j = 0; j < num_alternatives; ++j)
+			{
+				EXPECT_NEAR(streaming.standardError(i, j), comparison.standardError(i, j), 1e-9);
+				EXPECT_DOUBLE_EQ(statistics.Covariance(i, j), statistics.Covariance(j, i));
+				EXPECT_NEAR(first.Covariance(i, j), statistics.Covariance(i, j), 1e-9);
+			}
+		}
+		streaming.ComputeZstatistics(0);
+		EXPECT_NO_THROW(streaming.ComputeProbabilities(true));
+		EXPECT_THROW(streaming.ComputeProbabilities(false), DynaPlex::Error);
+		EXPECT_THROW(statistics.Add(std::vector<double>(2)), DynaPlex::Error);
+	}
+
+	TEST(ReturnStatistics, Quantiles)
+	{
+		DynaPlex::RNG rng(false, 13021984);
+		std::vector<double> probabilities{ 0.1, 0.5, 0.9 };
+		ReturnStatistics statistics{ 1, probabilities };
+		ReturnStatistics first{ 1, probabilities }, second{ 1, probabilities };
+		for (size_t k = 0; k < 20000; ++k)
+		{
+			std::vector<double> observation{ rng.genUniform() };
+			statistics.Add(observation);
+			(k % 2 == 0 ? first : second).Add(observation);
+		}
+		first.Merge(second);
+		for (size_t q = 0; q < probabilities.size(); ++q)
+		{
+			EXPECT_NEAR(statistics.Quantile(0, q), probabilities[q], 0.02);
+			EXPECT_NEAR(first.Quantile(0, q), probabilities[q], 0.02);
+		}
+
+		//small samples are interpolated exactly:
+		ReturnStatistics small{ 1, { 0.5 } };
+		for (double x : { 3.0, 1.0, 2.0 })
+			small.Add(std::vector<double>{ x });
+		EXPECT_DOUBLE_EQ(small.Quantile(0, 0), 2.0);
+		EXPECT_THROW(ReturnStatistics(1, { 1.5 }), DynaPlex::Error);
+	}
+}
@@ -1,7 +1,9 @@
 ﻿#include <iostream>
 #include "dynaplex/vargroup.h"
 #include "dynaplex/error.h"
+#include "dynaplex/dynaplexprovider.h"
 #include <gtest/gtest.h>
+#include <limits>
 namespace DynaPlex::Tests {
 
 	TEST(VarGroup, AddTwice) {
@@ -181,4 +183,66 @@ namespace DynaPlex::Tests {
 		EXPECT_NE(vargroup2, list[1]);
 	}
 
-}
\ No newline at end of file
+
+	TEST(VarGroup, BinaryEncodings) {
+		DynaPlex::VarGroup nested({ {"id","nested"},{"weights", DynaPlex::VarGroup::DoubleVec{0.5,-1.25,3.0}} });
+		DynaPlex::VarGroup vars({ {"p",2},{"q",3.1},{"s","string"},{"flag",true},
+			{"levels", DynaPlex::VarGroup::Int64Vec{1,2,300000,-4}},
+			{"xlist", DynaPlex::VarGroup::DoubleVec{1.2,1.3}},
+			{"names", DynaPlex::VarGroup::StringVec{"a","b"}},
+			{"nested", nested},
+			{"list", DynaPlex::VarGroup::VarGroupVec{nested,nested}} });
+		using Encoding = DynaPlex::VarGroup::Encoding;
+
+		auto& system = DynaPlex::DynaPlexProvider::Get().System();
+		for (auto [encoding, extension] : std::vector<std::pair<Encoding, std::string>>{
+			{Encoding::CBOR,"cbor"},{Encoding::MessagePack,"msgpack"},{Encoding::UBJSON,"ubj"},{Encoding::BJData,"bjd"},{Encoding::JSON,"json"} })
+		{
+			auto path = system.filepath("tests", "vargroup", "encoded." + extension);
+			EXPECT_EQ(DynaPlex::VarGroup::EncodingFromPath(path), encoding);
+			vars.SaveToFile(path);
+			auto loaded = DynaPlex::VarGroup::LoadFromFile(path);
+			EXPECT_EQ(loaded, vars);
+			EXPECT_EQ(loaded.Hash(), vars.Hash());
+			DynaPlex::VarGroup::Int64Vec levels;
+			loaded.Get("levels", levels);
+			EXPECT_EQ(levels, (DynaPlex::VarGroup::Int64Vec{ 1,2,300000,-4 }));
+			if (encoding != Encoding::JSON)
+				EXPECT_EQ(DynaPlex::VarGroup::FromBytes(vars.ToBytes(encoding), encoding), vars);
+		}
+		//encoding may also be set explicitly:
+		auto path = system.filepath("tests", "vargroup", "explicit.dat");
+		vars.SaveToFile(path, Encoding::BJData);
+		EXPECT_EQ(DynaPlex::VarGroup::LoadFromFile(path, Encoding::BJData), vars);
+		EXPECT_THROW(DynaPlex::VarGroup::LoadFromFile(path), DynaPlex::Error);
+
+		//packed typed arrays make long numeric lists much smaller than JSON:
+		DynaPlex::VarGroup::DoubleVec values(1000);
+		for (size_t i = 0; i < values.size(); i++)
+			values[i] = 1.0 / (i + 3.0);
+		DynaPlex::VarGroup large({ {"values", values} });
+		auto packed = large.ToBytes(Encoding::UBJSON);
+		EXPECT_LT(packed.size(), 1000 * sizeof(double) + 64);
+		DynaPlex::VarGroup::DoubleVec loaded_values;
+		DynaPlex::VarGroup::FromBytes(packed, Encoding::UBJSON).Get("values", loaded_values);
+		EXPECT_EQ(loaded_values, values);
+
+		//integers of mixed magnitude are packed with a common element type, here int32:
+		DynaPlex::VarGroup::Int64Vec mixed(1000);
+		for (size_t i = 0; i < mixed.size(); i++)
+			mixed[i] = (i % 2 == 0) ? 5 : -100000;
+		DynaPlex::VarGroup mixed_vars({ {"mixed", mixed}, {"extremes", DynaPlex::VarGroup::Int64Vec{ std::numeric_limits<int64_t>::min(), 0, std::numeric_limits<int64_t>::max() }} });
+		for (auto encoding : { Encoding::UBJSON, Encoding::BJData })
+		{
+			auto mixed_packed = mixed_vars.ToBytes(encoding);
+			EXPECT_LT(mixed_packed.size(), 1000 * sizeof(int32_t) + 3 * sizeof(int64_t) + 64);
+			auto decoded = DynaPlex::VarGroup::FromBytes(mixed_packed, encoding);
+			EXPECT_EQ(decoded, mixed_vars);
+			DynaPlex::VarGroup::Int64Vec loaded_mixed;
+			decoded.Get("mixed", loaded_mixed);
+			EXPECT_EQ(loaded_mixed, mixed);
+		}
+
+		EXPECT_THROW(DynaPlex::VarGroup::FromBytes({ 0x01, 0x02 }, Encoding::CBOR), DynaPlex::Error);
+	}
+}
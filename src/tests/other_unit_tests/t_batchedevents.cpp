@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/modelling/discretedist.h"
+#include "dynaplex/trajectory.h"
+#include "dynaplex/error.h"
+#include <algorithm>
+
+namespace DynaPlex::Tests {
+
+	TEST(BatchedEvents, DiscreteDistSamples) {
+		auto dist = DiscreteDist::GetCustomDist({ 0.1, 0.2, 0.3, 0.4 }, -2);
+		std::vector<DynaPlex::RNG> batch_rngs, single_rngs;
+		for (int64_t i = 0; i < 16; i++)
+		{
+			batch_rngs.emplace_back(true, 123, i);
+			single_rngs.emplace_back(true, 123, i);
+			//the sampling method follows each rng:
+			batch_rngs.back().SetMonotone(i % 2 == 1);
+			single_rngs.back().SetMonotone(i % 2 == 1);
+		}
+		std::vector<DynaPlex::RNG*> rng_ptrs;
+		for (auto& rng : batch_rngs)
+			rng_ptrs.push_back(&rng);
+		std::vector<int64_t> samples(16);
+		for (int round = 0; round < 10; round++)
+		{
+			dist.GetSamples(rng_ptrs, samples);
+			for (size_t i = 0; i < samples.size(); i++)
+				ASSERT_EQ(samples[i], dist.GetSample(single_rngs[i]));
+		}
+		std::vector<int64_t> too_few(15);
+		EXPECT_THROW(dist.GetSamples(rng_ptrs, too_few), DynaPlex::Error);
+	}
+
+	TEST(BatchedEvents, LockstepMatchesSequential) {
+		auto& dp = DynaPlexProvider::Get();
+		auto mdp = dp.GetMDP(VarGroup::LoadFromFile(dp.System().filepath("mdp_config_examples", "lost_sales", "mdp_config_0.json")));
+		auto policy = mdp->GetPolicy("base_stock");
+		int64_t count = 8, periods = 50;
+
+		auto make_trajectories = [&]() {
+			std::vector<Trajectory> trajectories;
+			for (int64_t i = 0; i < count; i++)
+			{
+				trajectories.emplace_back(i);
+				trajectories.back().RNGProvider.SeedEventStreams(true, 4321, 0, i);
+			}
+			mdp->InitiateState(trajectories);
+			return trajectories;
+		};
+
+		//evolves trajectories in the span until max period count, as in PolicyComparer:
+		auto evolve = [&](std::span<Trajectory> span) {
+			while (true)
+			{
+				if (!mdp->IncorporateUntilNonTrivialAction(span, periods))
+					span = std::span<Trajectory>(span.begin(), std::partition(span.begin(), span.end(),
+						[](const Trajectory& traj) { return traj.Category.IsAwaitAction(); }));
+				if (span.size() == 0)
+					break;
+				mdp->IncorporateAction(span, policy);
+			}
+		};
+		auto by_index = [](std::vector<Trajectory>& trajectories) {
+			std::sort(trajectories.begin(), trajectories.end(), [](const Trajectory& a, const Trajectory& b) { return a.ExternalIndex < b.ExternalIndex; });
+		};
+
+		//all trajectories in one span, such that events are drawn with lost_sales::MDP::GetEvents:
+		auto together = make_trajectories();
+		evolve(together);
+		by_index(together);
+
+		//each trajectory on its own:
+		auto separate = make_trajectories();
+		for (auto& traj : separate)
+			evolve({ &traj, 1 });
+
+		for (int64_t i = 0; i < count; i++)
+		{
+			EXPECT_EQ(together[i].PeriodCount, periods);
+			EXPECT_EQ(separate[i].PeriodCount, periods);
+			EXPECT_DOUBLE_EQ(together[i].CumulativeReturn, separate[i].CumulativeReturn);
+		}
+		//different trajectories face different demands:
+		EXPECT_NE(together[0].CumulativeReturn, together[1].CumulativeReturn);
+
+		//IncorporateEvent also batches:
+		auto stepwise = make_trajectories();
+		for (int64_t period = 0; period < periods; period++)
+		{
+			mdp->IncorporateAction(stepwise, policy);
+			EXPECT_FALSE(mdp->IncorporateEvent(stepwise));
+		}
+		mdp->IncorporateAction(stepwise, policy);
+		for (int64_t i = 0; i < count; i++)
+			EXPECT_DOUBLE_EQ(stepwise[i].CumulativeReturn, separate[i].CumulativeReturn);
+	}
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/trajectory.h"
+#include "dynaplex/error.h"
+#include <algorithm>
+#include <limits>
+
+namespace DynaPlex::Tests {
+
+	constexpr int64_t unbounded = std::numeric_limits<int64_t>::max();
+
+	TEST(BatchMDP, MatchesSeparateEvolution) {
+		auto& dp = DynaPlexProvider::Get();
+		auto mdp = dp.GetMDP(VarGroup::LoadFromFile(dp.System().filepath("mdp_config_examples", "lost_sales", "mdp_config_0.json")));
+		auto policy = mdp->GetPolicy(VarGroup{ {"id", "base_stock"}, {"base_stock_level", 12} });
+		ASSERT_TRUE(mdp->ProvidesBatchEvolution(policy->GetConfig()));
+		EXPECT_FALSE(mdp->ProvidesBatchEvolution(mdp->GetPolicy("random")->GetConfig()));
+		//not a multiple of the number of lanes:
+		int64_t count = 37;
+
+		auto make_trajectories = [&]() {
+			std::vector<Trajectory> trajectories;
+			for (int64_t i = 0; i < count; i++)
+			{
+				trajectories.emplace_back(i);
+				trajectories.back().RNGProvider.SeedEventStreams(true, 2468, 0, i);
+			}
+			mdp->InitiateState(trajectories);
+			return trajectories;
+		};
+		auto evolve = [&](std::span<Trajectory> span, int64_t max_periods) {
+			while (true)
+			{
+				if (!mdp->IncorporateUntilNonTrivialAction(span, max_periods))
+					span = std::span<Trajectory>(span.begin(), std::partition(span.begin(), span.end(),
+						[](const Trajectory& traj) { return traj.Category.IsAwaitAction(); }));
+				if (span.size() == 0)
+					break;
+				mdp->IncorporateAction(span, policy);
+			}
+		};
+		auto by_index = [](std::vector<Trajectory>& trajectories) {
+			std::sort(trajectories.begin(), trajectories.end(), [](const Trajectory& a, const Trajectory& b) { return a.ExternalIndex < b.ExternalIndex; });
+		};
+		auto expect_equal = [&](std::vector<Trajectory>& batched, std::vector<Trajectory>& separate) {
+			by_index(batched);
+			by_index(separate);
+			for (int64_t i = 0; i < count; i++)
+			{
+				EXPECT_EQ(batched[i].PeriodCount, separate[i].PeriodCount);
+				EXPECT_EQ(batched[i].Category, separate[i].Category);
+				EXPECT_EQ(batched[i].NextAction, separate[i].NextAction);
+				EXPECT_EQ(batched[i].CumulativeReturn, separate[i].CumulativeReturn);
+				EXPECT_EQ(batched[i].CumulativeControlVariate, separate[i].CumulativeControlVariate);
+				EXPECT_TRUE(mdp->StatesAreEqual(batched[i].GetState(), separate[i].GetState()));
+			}
+		};
+
+		auto batched = make_trajectories();
+		auto separate = make_trajectories();
+		//continuing from states that await an event, as after a warm-up:
+		for (int64_t max_periods : { 20, 50 })
+		{
+			mdp->EvolveBatch(batched, policy->GetConfig(), max_periods, unbounded);
+			evolve(separate, max_periods);
+			expect_equal(batched, separate);
+			EXPECT_EQ(batched[0].PeriodCount, max_periods);
+		}
+		EXPECT_NE(batched[0].CumulativeReturn, batched[1].CumulativeReturn);
+
+		//trajectories that are not in lock-step are evolved separately:
+		auto mixed = make_trajectories();
+		auto mixed_separate = make_trajectories();
+		for (int64_t i = 0; i < count; i += 3)
+		{
+			evolve({ &mixed[i], 1 }, 1 + i % 4);
+			evolve({ &mixed_separate[i], 1 }, 1 + i % 4);
+		}
+		mdp->EvolveBatch(mixed, policy->GetConfig(), 30, unbounded);
+		evolve(mixed_separate, 30);
+		expect_equal(mixed, mixed_separate);
+
+		EXPECT_THROW(mdp->EvolveBatch(batched, mdp->GetPolicy("random")->GetConfig(), 60, unbounded), DynaPlex::Error);
+		//an action in the initial state and one per period; the bound on the number of rounds of actions applies both in lock-step and separately:
+		auto bounded = make_trajectories();
+		EXPECT_NO_THROW(mdp->EvolveBatch(bounded, policy->GetConfig(), 10, 11));
+		EXPECT_THROW(mdp->EvolveBatch(bounded, policy->GetConfig(), 30, 10), DynaPlex::Error);
+		EXPECT_THROW(mdp->EvolveBatch(mixed, policy->GetConfig(), 60, 10), DynaPlex::Error);
+		auto bin_packing = dp.GetMDP(VarGroup::LoadFromFile(dp.System().filepath("mdp_config_examples", "bin_packing", "mdp_config_0.json")));
+		EXPECT_FALSE(bin_packing->ProvidesBatchEvolution(VarGroup{ {"id", "base_stock"} }));
+	}
+}
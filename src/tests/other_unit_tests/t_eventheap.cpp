@@ -2,6 +2,9 @@
 #include "dynaplex/error.h"
 #include <gtest/gtest.h>
 #include "dynaplex/modelling/eventheap.h"
+#include "dynaplex/modelling/calendarqueue.h"
+#include "dynaplex/rng.h"
+#include <map>
 
 
 struct Event {
@@ -114,4 +117,180 @@ namespace DynaPlex::Tests {
         EXPECT_DOUBLE_EQ(total_time, 1.5 + 0.8 + 2.3);
     }
     
+
+    struct TimedEvent {
+        int64_t time;
+        int64_t id;
+
+        auto operator<=>(const TimedEvent& other) const = default;
+
+        TimedEvent(int64_t time, int64_t id) : time{ time }, id{ id } {}
+        explicit TimedEvent(const DynaPlex::VarGroup& vars) {
+            vars.Get("time", time);
+            vars.Get("id", id);
+        }
+        DynaPlex::VarGroup ToVarGroup() const {
+            return DynaPlex::VarGroup{ {"time", time}, {"id", id} };
+        }
+    };
+
+    TEST(EventHeapTest, TestHandles) {
+        DynaPlex::EventHeap<Event> heap{};
+        auto a = heap.push(Event(1.5, 42));
+        auto b = heap.push(Event(0.8, 33));
+        auto c = heap.push(Event(2.3, 55));
+        EXPECT_EQ(heap.first_handle(), b);
+
+        // reschedule: handles remain valid while elements move.
+        heap.update(b, Event(3.0, 33));
+        EXPECT_EQ(heap.first().payload, 42);
+        heap[c].time = 0.1;
+        heap.update(c);
+        EXPECT_EQ(heap.first().payload, 55);
+        EXPECT_EQ(heap[a].payload, 42);
+
+        // cancel:
+        heap.erase(c);
+        EXPECT_FALSE(heap.contains(c));
+        EXPECT_THROW(heap.erase(c), DynaPlex::Error);
+        EXPECT_EQ(heap.size(), 2);
+        EXPECT_EQ(heap.first().payload, 42);
+        heap.pop();
+        EXPECT_EQ(heap.first_handle(), b);
+        heap.pop();
+        EXPECT_TRUE(heap.empty());
+        EXPECT_THROW(heap.pop(), DynaPlex::Error);
+    }
+
+    TEST(EventHeapTest, TestRandomOperations) {
+        // compare against a std::multimap that stores the same events:
+        DynaPlex::EventHeap<TimedEvent> heap{};
+        std::map<int64_t, DynaPlex::EventHeap<TimedEvent>::Handle> handles;
+        std::multimap<int64_t, int64_t> reference;
+        DynaPlex::RNG rng{ true, 3 };
+        int64_t next_id = 0;
+        for (int i = 0; i < 5000; i++) {
+            double u = rng.genUniform();
+            if (u < 0.5 || handles.empty()) {
+                int64_t time = static_cast<int64_t>(rng.genUniform() * 1000);
+                handles[next_id] = heap.push(TimedEvent(time, next_id));
+                reference.emplace(time, next_id++);
+            }
+            else {
+                // pick a random pending event, and reschedule, cancel or pop:
+                auto it = std::next(reference.begin(), static_cast<int64_t>(rng.genUniform() * reference.size()));
+                auto [time, id] = *it;
+                reference.erase(it);
+                if (u < 0.75) {
+                    int64_t new_time = static_cast<int64_t>(rng.genUniform() * 1000);
+                    heap.update(handles[id], TimedEvent(new_time, id));
+                    reference.emplace(new_time, id);
+                }
+                else if (u < 0.9) {
+                    heap.erase(handles[id]);
+                    handles.erase(id);
+                }
+                else {
+                    reference.emplace(time, id);
+                    const auto& first = heap.first();
+                    ASSERT_EQ(first.time, reference.begin()->first);
+                    auto range = reference.equal_range(first.time);
+                    auto found = std::find_if(range.first, range.second, [&](const auto& kv) { return kv.second == first.id; });
+                    ASSERT_NE(found, range.second);
+                    reference.erase(found);
+                    handles.erase(first.id);
+                    heap.pop();
+                }
+            }
+            ASSERT_EQ(heap.size(), reference.size());
+        }
+        heap.resort();
+        int64_t previous = -1;
+        while (!heap.empty()) {
+            ASSERT_GE(heap.first().time, previous);
+            previous = heap.first().time;
+            heap.pop();
+        }
+    }
+
+    TEST(CalendarQueueTest, TestOrder) {
+        DynaPlex::CalendarQueue<TimedEvent> queue{};
+        DynaPlex::EventHeap<TimedEvent> heap{};
+        DynaPlex::RNG rng{ true, 5 };
+        // events are scheduled ahead of the current time, with some far in the future:
+        int64_t now = 0;
+        for (int64_t id = 0; id < 2000; id++) {
+            int64_t delay = rng.genUniform() < 0.05 ? 10000 : static_cast<int64_t>(rng.genUniform() * 20);
+            queue.push(TimedEvent(now + delay, id));
+            heap.push(TimedEvent(now + delay, id));
+            if (id % 3 == 0) {
+                ASSERT_EQ(queue.first(), heap.first());
+                now = queue.first().time;
+                queue.pop();
+                heap.pop();
+            }
+        }
+        EXPECT_EQ(queue.size(), heap.size());
+        size_t count = 0;
+        for (const auto& event : queue) {
+            ASSERT_GE(event.time, now);
+            count++;
+        }
+        EXPECT_EQ(count, heap.size());
+        while (!heap.empty()) {
+            ASSERT_EQ(queue.first(), heap.first());
+            queue.pop();
+            heap.pop();
+        }
+        EXPECT_TRUE(queue.empty());
+        EXPECT_THROW(queue.first(), DynaPlex::Error);
+    }
+
+    TEST(CalendarQueueTest, TestSparseEvents) {
+        DynaPlex::CalendarQueue<TimedEvent> queue{};
+        DynaPlex::EventHeap<TimedEvent> heap{};
+        DynaPlex::RNG rng{ true, 7 };
+        // events spaced far apart, and later densely, such that the bucket width must adapt both ways:
+        for (int64_t spacing : { 1000, 1 }) {
+            for (int64_t id = 0; id < 500; id++) {
+                int64_t time = (heap.empty() ? 0 : heap.first().time) + static_cast<int64_t>(rng.genUniform() * 100) * spacing;
+                queue.push(TimedEvent(time, id));
+                heap.push(TimedEvent(time, id));
+                if (id % 2 == 0) {
+                    ASSERT_EQ(queue.first(), heap.first());
+                    queue.pop();
+                    heap.pop();
+                }
+            }
+            while (!heap.empty()) {
+                ASSERT_EQ(queue.first(), heap.first());
+                queue.pop();
+                heap.pop();
+            }
+            EXPECT_TRUE(queue.empty());
+        }
+    }
+
+    TEST(CalendarQueueTest, TestVarGroup) {
+        DynaPlex::CalendarQueue<TimedEvent> queue{};
+        queue.push(TimedEvent(5, 1));
+        queue.push(TimedEvent(-3, 2));
+        queue.push(TimedEvent(100, 3));
+        DynaPlex::VarGroup vars;
+        vars.Add("queue", queue);
+        DynaPlex::CalendarQueue<TimedEvent> loaded{};
+        vars.Get("queue", loaded);
+        EXPECT_EQ(loaded, queue);
+        EXPECT_EQ(loaded.first(), TimedEvent(-3, 2));
+
+        DynaPlex::EventHeap<TimedEvent> heap{};
+        for (const auto& event : queue)
+            heap.push(event);
+        DynaPlex::VarGroup heap_vars;
+        heap_vars.Add("queue", heap);
+        DynaPlex::EventHeap<TimedEvent> loaded_heap{};
+        heap_vars.Get("queue", loaded_heap);
+        EXPECT_EQ(loaded_heap, heap);
+        EXPECT_EQ(loaded_heap.first(), TimedEvent(-3, 2));
+    }
 }
\ No newline at end of file
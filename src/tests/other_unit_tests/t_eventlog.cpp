@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/eventlog.h"
+#include "dynaplex/vargroup.h"
+#include "dynaplex/error.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace DynaPlex::Tests {
+
+	namespace {
+		DynaPlex::VarGroup LostSalesConfig() {
+			return DynaPlex::VarGroup{
+				{"id", "lost_sales"},
+				{"p", 9.0},
+				{"h", 1.0},
+				{"leadtime", 2},
+				{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+			};
+		}
+
+		std::vector<std::vector<int64_t>> PoissonDemands(int64_t num_streams, int64_t length, unsigned seed) {
+			std::mt19937_64 gen{ seed };
+			std::poisson_distribution<int64_t> dist{ 4.0 };
+			std::vector<std::vector<int64_t>> streams(num_streams);
+			for (auto& stream : streams)
+				for (int64_t i = 0; i < length; i++)
+					stream.push_back(dist(gen));
+			return streams;
+		}
+	}
+
+	TEST(EventLog, WriteAndMap) {
+		auto& dp = DynaPlexProvider::Get();
+		auto path = dp.System().filepath("tests", "eventlog", "roundtrip.bin");
+		std::vector<std::vector<int64_t>> streams{ {1,2,3}, {}, {4,5} };
+		EventLog::Write<int64_t>(path, streams);
+		EventLog log{ path };
+		ASSERT_EQ(log.NumStreams(), 3);
+		EXPECT_EQ(log.RecordSize(), sizeof(int64_t));
+		for (int64_t s = 0; s < 3; s++)
+		{
+			ASSERT_EQ(log.StreamLength(s), static_cast<int64_t>(streams[s].size()));
+			auto bytes = log.Stream(s);
+			for (size_t i = 0; i < streams[s].size(); i++)
+			{
+				int64_t value;
+				std::memcpy(&value, bytes.data() + i * sizeof(int64_t), sizeof(int64_t));
+				EXPECT_EQ(value, streams[s][i]);
+			}
+		}
+		EXPECT_THROW(log.Stream(3), DynaPlex::Error);
+
+		EventReplay replay{ log.Stream(2), log.RecordSize() };
+		EXPECT_TRUE(replay.IsActive());
+		replay.Next();
+		replay.Next();
+		EXPECT_THROW(replay.Next(), DynaPlex::Error);
+
+		auto bad_path = dp.System().filepath("tests", "eventlog", "not_a_log.bin");
+		DynaPlex::VarGroup{ {"a", 1} }.SaveToFile(bad_path);
+		EXPECT_THROW(EventLog{ bad_path }, DynaPlex::Error);
+	}
+
+	TEST(EventLog, TraceDrivenComparison) {
+		auto& dp = DynaPlexProvider::Get();
+		auto mdp = dp.GetMDP(LostSalesConfig());
+		ASSERT_EQ(mdp->EventRecordSize(), sizeof(int64_t));
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto random = mdp->GetPolicy("random");
+
+		int64_t warmup = 16, periods = 64, trajectories = 256;
+		auto path = dp.System().filepath("tests", "eventlog", "demands.bin");
+		EventLog::Write<int64_t>(path, PoissonDemands(trajectories, warmup + periods, 1234));
+
+		VarGroup comparer_vars{ {"number_of_trajectories", trajectories}, {"periods_per_trajectory", periods}, {"warmup_periods", warmup} };
+		auto trace_vars = comparer_vars;
+		trace_vars.Add("event_log", path);
+
+		double sampled_mean, sampled_error, replayed_mean, replayed_error;
+		auto sampled = dp.GetPolicyComparer(mdp, comparer_vars).Assess(base_stock);
+		sampled.Get("mean", sampled_mean);
+		sampled.Get("error", sampled_error);
+		auto replayed = dp.GetPolicyComparer(mdp, trace_vars).Assess(base_stock);
+		replayed.Get("mean", replayed_mean);
+		replayed.Get("error", replayed_error);
+		EXPECT_NE(replayed_mean, sampled_mean);
+		EXPECT_NEAR(replayed_mean, sampled_mean, 4.0 * std::sqrt(sampled_error * sampled_error + replayed_error * replayed_error));
+
+		//base-stock is deterministic, so with recorded events the rng_seed has no effect:
+		auto reseeded_vars = trace_vars;
+		reseeded_vars.Set("rng_seed", 42);
+		double reseeded_mean;
+		dp.GetPolicyComparer(mdp, reseeded_vars).Assess(base_stock).Get("mean", reseeded_mean);
+		EXPECT_DOUBLE_EQ(reseeded_mean, replayed_mean);
+
+		//all policies face the same events, also when compared together:
+		auto comparison = dp.GetPolicyComparer(mdp, trace_vars).Compare(random, base_stock);
+		double compared_mean;
+		comparison[1].Get("mean", compared_mean);
+		EXPECT_DOUBLE_EQ(compared_mean, replayed_mean);
+
+		//fewer, longer streams may be cut into windows:
+		std::vector<std::vector<int64_t>> long_streams(16);
+		auto streams = PoissonDemands(trajectories, warmup + periods, 1234);
+		for (int64_t e = 0; e < trajectories; e++)
+			long_streams[e % 16].insert(long_streams[e % 16].end(), streams[e].begin(), streams[e].end());
+		auto long_path = dp.System().filepath("tests", "eventlog", "long_demands.bin");
+		EventLog::Write<int64_t>(long_path, long_streams);
+		auto strided_vars = comparer_vars;
+		strided_vars.Add("event_log", long_path);
+		strided_vars.Add("event_log_stride", warmup + periods);
+		double strided_mean;
+		dp.GetPolicyComparer(mdp, strided_vars).Assess(base_stock).Get("mean", strided_mean);
+		EXPECT_DOUBLE_EQ(strided_mean, replayed_mean);
+
+		//without stride, there are not enough streams:
+		strided_vars.Set("event_log_stride", 0);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, strided_vars).Assess(base_stock), DynaPlex::Error);
+		//streams that are too short:
+		auto short_vars = trace_vars;
+		short_vars.Set("periods_per_trajectory", warmup + periods);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, short_vars).Assess(base_stock), DynaPlex::Error);
+		auto antithetic_vars = trace_vars;
+		antithetic_vars.Add("antithetic", true);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, antithetic_vars), DynaPlex::Error);
+		//records should match the size of events:
+		auto narrow_path = dp.System().filepath("tests", "eventlog", "narrow_demands.bin");
+		EventLog::Write<int32_t>(narrow_path, { {1,2,3} });
+		auto narrow_vars = comparer_vars;
+		narrow_vars.Add("event_log", narrow_path);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, narrow_vars), DynaPlex::Error);
+	}
+
+	TEST(EventLog, TraceDrivenDemonstration) {
+		auto& dp = DynaPlexProvider::Get();
+		auto mdp = dp.GetMDP(LostSalesConfig());
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto path = dp.System().filepath("tests", "eventlog", "demonstrator_demands.bin");
+		EventLog::Write<int64_t>(path, { {0,0,0,0,0}, {9,9,9,9,9} });
+
+		auto sampled = dp.GetDemonstrator(VarGroup{ {"max_period_count", 5} }).GetTrace(mdp, base_stock);
+		auto replayed = dp.GetDemonstrator(VarGroup{ {"max_period_count", 5}, {"event_log", path}, {"event_log_stream", 1} }).GetTrace(mdp, base_stock);
+		auto reseeded = dp.GetDemonstrator(VarGroup{ {"max_period_count", 5}, {"event_log", path}, {"event_log_stream", 1}, {"rng_seed", 7} }).GetTrace(mdp, base_stock);
+		auto no_demand = dp.GetDemonstrator(VarGroup{ {"max_period_count", 5}, {"event_log", path} }).GetTrace(mdp, base_stock);
+		ASSERT_EQ(replayed.size(), sampled.size());
+		EXPECT_EQ(replayed, reseeded);
+		EXPECT_NE(replayed, no_demand);
+
+		//without demand, there are no lost sales, so costs are at most holding costs of the maximal system inventory:
+		for (auto& elem : no_demand)
+		{
+			double incr_return;
+			elem.Get("incr_return", incr_return);
+			EXPECT_LE(incr_return, 17.0);
+		}
+		EXPECT_THROW(dp.GetDemonstrator(VarGroup{ {"event_log", path}, {"event_log_stream", 2} }), DynaPlex::Error);
+	}
+}
@@ -68,4 +68,90 @@ namespace DynaPlex::Tests {
         }
     }
 
+    TEST(IdContainerTest, SlotReuse) {
+        DynaPlex::IdContainer<SmallClass> container;
+        std::vector<int64_t> ids;
+        for (double size : {1.0, 2.0, 3.0, 4.0})
+        {
+            auto& [id, item] = container.AddNew();
+            item.Size = size;
+            ids.push_back(id);
+        }
+        EXPECT_EQ(ids, (std::vector<int64_t>{ 1, 2, 3, 4 }));
+
+        container.Delete(2);
+        EXPECT_FALSE(container.HasId(2));
+        EXPECT_THROW(container.Delete(2), DynaPlex::Error);
+        // iteration visits only the remaining items:
+        double total = 0.0;
+        for (auto& [id, item] : container)
+        {
+            EXPECT_EQ(container[id].Size, item.Size);
+            total += item.Size;
+        }
+        EXPECT_EQ(total, 8.0);
+
+        // the slot is reused, but the id of the deleted item remains invalid:
+        auto& [new_id, new_item] = container.AddNew();
+        new_item.Size = 5.0;
+        EXPECT_NE(new_id, 2);
+        EXPECT_FALSE(container.HasId(2));
+        EXPECT_TRUE(container.HasId(new_id));
+        EXPECT_EQ(container[new_id].Size, 5.0);
+        EXPECT_EQ(container.size(), 4);
+
+        // round trip through VarGroup and bytes preserves ids:
+        auto vars = container.ToVarGroup();
+        DynaPlex::IdContainer<SmallClass> loaded(vars);
+        EXPECT_EQ(loaded.ToVarGroup(), vars);
+        EXPECT_EQ(loaded[new_id].Size, 5.0);
+        EXPECT_FALSE(loaded.HasId(2));
+
+        // many additions and deletions:
+        for (int round = 0; round < 1000; round++)
+        {
+            auto& [id, item] = container.AddNew();
+            item.Size = round;
+            if (round % 2 == 0)
+                container.Delete(id);
+        }
+        EXPECT_EQ(container.size(), 504);
+    }
+
+    TEST(IdContainerTest, GenerationWraps) {
+        // an id whose slot has reached the largest generation:
+        int64_t id = (((int64_t{ 1 } << 31) - 1) << 32) | 1;
+        DynaPlex::VarGroup vg;
+        SmallClass obj;
+        vg.Add(std::to_string(id), obj.ToVarGroup());
+        DynaPlex::IdContainer<SmallClass> container(vg);
+        EXPECT_TRUE(container.HasId(id));
+        container.Delete(id);
+        // the generation wraps around, such that the new id remains positive:
+        int64_t new_id = container.AddNew().first;
+        EXPECT_EQ(new_id, 1);
+        EXPECT_FALSE(container.HasId(id));
+        EXPECT_TRUE(container.HasId(new_id));
+    }
+
+    TEST(IdContainerTest, VarGroupFormat) {
+        // ids need not be contiguous; free slots below the largest id are reused first:
+        DynaPlex::VarGroup vg;
+        SmallClass obj;
+        obj.name = "five";
+        vg.Add("5", obj.ToVarGroup());
+        obj.name = "two";
+        vg.Add("2", obj.ToVarGroup());
+        DynaPlex::IdContainer<SmallClass> container(vg);
+        EXPECT_EQ(container.size(), 2);
+        EXPECT_EQ(container[5].name, "five");
+        EXPECT_EQ(container[2].name, "two");
+        EXPECT_EQ(container.AddNew().first, 1);
+        EXPECT_EQ(container.AddNew().first, 3);
+
+        DynaPlex::VarGroup invalid;
+        invalid.Add("0", obj.ToVarGroup());
+        EXPECT_THROW(DynaPlex::IdContainer<SmallClass>{ invalid }, DynaPlex::Error);
+    }
+
 }
\ No newline at end of file
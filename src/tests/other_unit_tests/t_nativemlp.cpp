@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include "dynaplex/nativemlp.h"
+#include "dynaplex/trainedpolicyprovider.h"
+#include "dynaplex/sampledata.h"
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/vargroup.h"
+#include "dynaplex/error.h"
+#include "dynaplex/rng.h"
+#include <chrono>
+#include <filesystem>
+
+namespace DynaPlex::Tests {
+
+	namespace {
+		//naive reference implementation, with weights in torch layout:
+		std::vector<float> ReferenceForward(const std::vector<std::vector<float>>& weights, const std::vector<std::vector<float>>& biases,
+			const std::vector<int64_t>& dims, const std::vector<float>& inputs, int64_t batch_size)
+		{
+			std::vector<float> current = inputs;
+			for (size_t l = 0; l < weights.size(); l++)
+			{
+				int64_t in = dims[l], out = dims[l + 1];
+				std::vector<float> next(batch_size * out);
+				for (int64_t b = 0; b < batch_size; b++)
+					for (int64_t o = 0; o < out; o++)
+					{
+						float sum = biases[l][o];
+						for (int64_t i = 0; i < in; i++)
+							sum += weights[l][o * in + i] * current[b * in + i];
+						next[b * out + o] = (l + 1 < weights.size()) ? std::max(sum, 0.0f) : sum;
+					}
+				current = std::move(next);
+			}
+			return current;
+		}
+
+		NN::NativeMLP RandomNetwork(const std::vector<int64_t>& dims, std::vector<std::vector<float>>& weights, std::vector<std::vector<float>>& biases)
+		{
+			DynaPlex::RNG rng{ false, 1234 };
+			NN::NativeMLP network;
+			for (size_t l = 0; l + 1 < dims.size(); l++)
+			{
+				std::vector<float> weight(dims[l] * dims[l + 1]), bias(dims[l + 1]);
+				for (auto& w : weight)
+					w = static_cast<float>(rng.genUniform() - 0.5);
+				for (auto& b : bias)
+					b = static_cast<float>(rng.genUniform() - 0.5);
+				network.AddLayer(dims[l], dims[l + 1], weight, bias);
+				weights.push_back(weight);
+				biases.push_back(bias);
+			}
+			return network;
+		}
+	}
+
+	TEST(NativeMLP, ForwardMatchesReference) {
+		//dimensions exceed block sizes, to cover partial blocks:
+		std::vector<int64_t> dims{ 7, 300, 129, 5 };
+		std::vector<std::vector<float>> weights, biases;
+		auto network = RandomNetwork(dims, weights, biases);
+		EXPECT_EQ(network.NumInputs(), 7);
+		EXPECT_EQ(network.NumOutputs(), 5);
+
+		DynaPlex::RNG rng{ false, 4321 };
+		for (int64_t batch_size : {1, 3, 17})
+		{
+			std::vector<float> inputs(batch_size * dims.front());
+			for (auto& x : inputs)
+				x = static_cast<float>(rng.genUniform() * 4.0);
+			std::vector<float> outputs(batch_size * dims.back());
+			network.Forward(inputs, batch_size, outputs);
+			auto expected = ReferenceForward(weights, biases, dims, inputs, batch_size);
+			for (size_t i = 0; i < outputs.size(); i++)
+				EXPECT_NEAR(outputs[i], expected[i], 1e-3);
+		}
+
+		std::vector<float> wrong_size(4);
+		std::vector<float> outputs(5);
+		EXPECT_THROW(network.Forward(wrong_size, 1, outputs), DynaPlex::Error);
+		std::vector<float> weight(6), bias(2);
+		EXPECT_THROW(network.AddLayer(3, 2, weight, bias), DynaPlex::Error);
+	}
+
+	TEST(NativeMLP, Quantized) {
+		std::vector<int64_t> dims{ 12, 256, 128, 6 };
+		std::vector<std::vector<float>> weights, biases;
+		auto network = RandomNetwork(dims, weights, biases);
+		EXPECT_EQ(NN::NativeMLP::PrecisionFromString("int8"), NN::NativeMLP::Precision::Int8);
+		EXPECT_EQ(NN::NativeMLP::ToString(NN::NativeMLP::Precision::BFloat16), "bf16");
+		EXPECT_THROW(NN::NativeMLP::PrecisionFromString("int4"), DynaPlex::Error);
+
+		int64_t batch_size = 32;
+		DynaPlex::RNG rng{ false, 4321 };
+		std::vector<float> inputs(batch_size * dims.front());
+		for (auto& x : inputs)
+			x = static_cast<float>(rng.genUniform());
+		std::vector<float> expected(batch_size * dims.back());
+		network.Forward(inputs, batch_size, expected);
+
+		for (auto precision : { NN::NativeMLP::Precision::BFloat16, NN::NativeMLP::Precision::Int8 })
+		{
+			auto quantized = network.Quantized(precision);
+			EXPECT_EQ(quantized.GetPrecision(), precision);
+			std::vector<float> outputs(batch_size * dims.back());
+			quantized.Forward(inputs, batch_size, outputs);
+			double max_abs = 0.0, max_error = 0.0;
+			for (size_t i = 0; i < outputs.size(); i++)
+			{
+				max_abs = std::max(max_abs, static_cast<double>(std::abs(expected[i])));
+				max_error = std::max(max_error, static_cast<double>(std::abs(outputs[i] - expected[i])));
+			}
+			EXPECT_LT(max_error, 0.05 * max_abs) << NN::NativeMLP::ToString(precision);
+		}
+	}
+
+	TEST(NativeMLP, QuantizedPartialBlocks) {
+		//dimensions that are not multiples of the register widths, and inputs of both signs:
+		std::vector<int64_t> dims{ 13, 130, 7 };
+		std::vector<std::vector<float>> weights, biases;
+		auto network = RandomNetwork(dims, weights, biases);
+		DynaPlex::RNG rng{ false, 2468 };
+		for (auto precision : { NN::NativeMLP::Precision::BFloat16, NN::NativeMLP::Precision::Int8 })
+		{
+			auto quantized = network.Quantized(precision);
+			for (int64_t batch_size : {1, 13})
+			{
+				std::vector<float> inputs(batch_size * dims.front());
+				for (auto& x : inputs)
+					x = static_cast<float>(rng.genUniform() * 4.0 - 2.0);
+				auto expected = ReferenceForward(weights, biases, dims, inputs, batch_size);
+				std::vector<float> outputs(batch_size * dims.back());
+				quantized.Forward(inputs, batch_size, outputs);
+				double max_abs = 0.0, max_error = 0.0;
+				for (size_t i = 0; i < outputs.size(); i++)
+				{
+					max_abs = std::max(max_abs, static_cast<double>(std::abs(expected[i])));
+					max_error = std::max(max_error, static_cast<double>(std::abs(outputs[i] - expected[i])));
+				}
+				EXPECT_LT(max_error, 0.05 * max_abs) << NN::NativeMLP::ToString(precision);
+
+				//saving writes the dequantized weights, which quantize to the same network:
+				auto path = (std::filesystem::temp_directory_path() / "t_nativemlp_quantized.mlp").string();
+				quantized.SaveToFile(path);
+				auto requantized = NN::NativeMLP::LoadFromFile(path).Quantized(precision);
+				std::filesystem::remove(path);
+				std::vector<float> reloaded_outputs(outputs.size());
+				requantized.Forward(inputs, batch_size, reloaded_outputs);
+				for (size_t i = 0; i < outputs.size(); i++)
+					EXPECT_NEAR(reloaded_outputs[i], outputs[i], 1e-5 * max_abs);
+			}
+		}
+	}
+
+	TEST(NativeMLP, QuantizedSpeedup) {
+		std::vector<int64_t> dims{ 256, 128, 128, 128 };
+		std::vector<std::vector<float>> weights, biases;
+		auto network = RandomNetwork(dims, weights, biases);
+		int64_t batch_size = 64;
+		DynaPlex::RNG rng{ false, 1357 };
+		std::vector<float> inputs(batch_size * dims.front()), outputs(batch_size * dims.back());
+		for (auto& x : inputs)
+			x = static_cast<float>(rng.genUniform());
+		//fastest of several repetitions, to be robust against interference:
+		auto time_forward = [&](const NN::NativeMLP& mlp) {
+			double fastest = std::numeric_limits<double>::infinity();
+			for (int repetition = 0; repetition < 20; repetition++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				mlp.Forward(inputs, batch_size, outputs);
+				fastest = std::min(fastest, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+			return fastest;
+		};
+		double float32 = time_forward(network);
+		for (auto precision : { NN::NativeMLP::Precision::BFloat16, NN::NativeMLP::Precision::Int8 })
+		{
+			if (!NN::NativeMLP::HasQuantizedKernels(precision))
+				continue;
+			double quantized = time_forward(network.Quantized(precision));
+			EXPECT_LT(quantized, float32) << NN::NativeMLP::ToString(precision);
+			std::cout << "NativeMLP forward " << NN::NativeMLP::ToString(precision) << ": " << quantized * 1e3 << " ms, float32: " << float32 * 1e3 << " ms" << std::endl;
+		}
+	}
+
+	TEST(NativeMLP, LoadPolicyWithoutTorch) {
+		auto& dp = DynaPlexProvider::Get();
+		auto& system = dp.System();
+
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		DynaPlex::MDP mdp = dp.GetMDP(config);
+
+		std::vector<int64_t> dims{ mdp->NumFlatFeatures(), 16, mdp->NumValidActions() };
+		std::vector<std::vector<float>> weights, biases;
+		auto network = RandomNetwork(dims, weights, biases);
+
+		auto path = system.filepath("test", "t_nativemlp", "policy");
+		network.SaveToFile(DynaPlex::System::SetFileExtension(path, "mlp"));
+		auto loaded = NN::NativeMLP::LoadFromFile(DynaPlex::System::SetFileExtension(path, "mlp"));
+		ASSERT_EQ(loaded.Layers().size(), network.Layers().size());
+		for (size_t l = 0; l < loaded.Layers().size(); l++)
+		{
+			EXPECT_EQ(loaded.Layers()[l].weights, network.Layers()[l].weights);
+			EXPECT_EQ(loaded.Layers()[l].bias, network.Layers()[l].bias);
+		}
+
+		DynaPlex::VarGroup policy_config{
+			{"id", "NN_Policy"},
+			{"gen", 1},
+			{"nn_architecture", DynaPlex::VarGroup{ {"type", "mlp"}, {"hidden_layers", std::vector<int64_t>{16}} }},
+			{"num_inputs", mdp->NumFlatFeatures()},
+			{"num_outputs", mdp->NumValidActions()}
+		};
+		policy_config.SaveToFile(DynaPlex::System::SetFileExtension(path, "json"), 1);
+
+		DynaPlex::Policy policy;
+		ASSERT_NO_THROW(policy = dp.LoadPolicy(mdp, path));
+		EXPECT_EQ(policy->TypeIdentifier(), "NN_Policy");
+
+		auto comparer = dp.GetPolicyComparer(mdp, DynaPlex::VarGroup{ {"number_of_trajectories", 16}, {"periods_per_trajectory", 16} });
+		EXPECT_NO_THROW(comparer.Assess(policy));
+
+		//quantization, with validation on a grid of states:
+		NN::SampleData validation_data{ mdp };
+		auto state_vars = mdp->GetInitialState()->ToVarGroup();
+		for (int64_t on_hand = 0; on_hand < 10; on_hand++)
+			for (int64_t pipeline = 0; pipeline < 5; pipeline++)
+			{
+				state_vars.Set("state_vector", std::vector<int64_t>{ on_hand, pipeline });
+				state_vars.Set("total_inv", on_hand + pipeline);
+				validation_data.Samples.emplace_back(0, mdp->GetState(state_vars));
+			}
+		DynaPlex::Policy quantized;
+		ASSERT_NO_THROW(quantized = DynaPlex::TrainedPolicyProvider::QuantizePolicy(policy, "int8", validation_data));
+		double agreement;
+		quantized->GetConfig().Get("quantization_agreement", agreement);
+		EXPECT_GE(agreement, 0.8);
+		EXPECT_LE(agreement, 1.0);
+		EXPECT_THROW(DynaPlex::TrainedPolicyProvider::QuantizePolicy(policy, "int4", validation_data), DynaPlex::Error);
+
+		auto quantized_path = system.filepath("test", "t_nativemlp", "policy_int8");
+		ASSERT_NO_THROW(dp.SavePolicy(quantized, quantized_path));
+		DynaPlex::Policy reloaded;
+		ASSERT_NO_THROW(reloaded = dp.LoadPolicy(mdp, quantized_path));
+		std::string quantization;
+		reloaded->GetConfig().Get("quantization", quantization);
+		EXPECT_EQ(quantization, "int8");
+		EXPECT_NO_THROW(comparer.Assess(reloaded));
+	}
+}
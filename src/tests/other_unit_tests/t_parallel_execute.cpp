@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "dynaplex/parallel_execute.h"
+#include "dynaplex/system.h"
+#include "dynaplex/error.h"
+#include <algorithm>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace DynaPlex::Tests {
+
+	TEST(ParallelExecute, ThreadingPolicy) {
+		DynaPlex::System system(false, 0, 1, nullptr);
+		EXPECT_EQ(system.WorkerThreads(), system.HardwareThreads());
+		EXPECT_EQ(system.ThreadsPerWorker(), 1);
+		EXPECT_THROW(system.SetThreading(0, 1), DynaPlex::Error);
+
+		system.SetThreading(3, 2, true);
+		EXPECT_EQ(system.WorkerThreads(), 3);
+		EXPECT_EQ(system.ThreadsPerWorker(), 2);
+		EXPECT_TRUE(system.PinWorkers());
+
+		std::vector<int64_t> threads_per_worker(10, -1);
+		DynaPlex::Parallel::parallel_compute<int64_t>(threads_per_worker, [](std::span<int64_t> span, int64_t) {
+			for (auto& value : span)
+				value = DynaPlex::Parallel::worker_threads_per_worker();
+			}, system);
+		for (auto value : threads_per_worker)
+			EXPECT_EQ(value, 2);
+		//setting is local to worker threads:
+		EXPECT_EQ(DynaPlex::Parallel::worker_threads_per_worker(), 0);
+	}
+
+#if defined(__linux__)
+	TEST(ParallelExecute, PinToCpuRange) {
+		//in a separate thread, such that the affinity of the test thread is unaffected:
+		std::jthread([]() {
+			//the process may be restricted to a subset of the cpus, e.g. by taskset or a container:
+			auto allowed = DynaPlex::Parallel::allowed_cpus();
+			ASSERT_FALSE(allowed.empty());
+			cpu_set_t own;
+			CPU_ZERO(&own);
+			ASSERT_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &own), 0);
+			EXPECT_EQ(CPU_COUNT(&own), static_cast<int>(allowed.size()));
+			for (int64_t cpu : allowed)
+				EXPECT_TRUE(CPU_ISSET(static_cast<int>(cpu), &own));
+
+			std::vector<int64_t> cpus(allowed.begin(), allowed.begin() + std::min<size_t>(2, allowed.size()));
+			ASSERT_TRUE(DynaPlex::Parallel::pin_current_thread(cpus));
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset), 0);
+			EXPECT_EQ(CPU_COUNT(&cpuset), static_cast<int>(cpus.size()));
+			EXPECT_FALSE(DynaPlex::Parallel::pin_current_thread(std::vector<int64_t>{}));
+			});
+	}
+
+	TEST(ParallelExecute, PinnedWorkersUseAllowedCpus) {
+		auto allowed = DynaPlex::Parallel::allowed_cpus();
+		DynaPlex::System system(false, 0, 1, nullptr);
+		system.SetThreading(2, 2, true);
+		//for each worker, whether its affinity is within the allowed cpus, and the number of cpus it may use:
+		std::vector<int64_t> within_allowed(4, -1), cpu_counts(4, -1);
+		DynaPlex::Parallel::parallel_compute<int64_t>(within_allowed, [&](std::span<int64_t> span, int64_t start) {
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+			bool within = true;
+			for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+				if (CPU_ISSET(cpu, &cpuset) && std::find(allowed.begin(), allowed.end(), cpu) == allowed.end())
+					within = false;
+			for (size_t i = 0; i < span.size(); i++)
+			{
+				span[i] = within ? 1 : 0;
+				cpu_counts[start + i] = CPU_COUNT(&cpuset);
+			}
+			}, system);
+		for (size_t i = 0; i < within_allowed.size(); i++)
+		{
+			EXPECT_EQ(within_allowed[i], 1);
+			EXPECT_EQ(cpu_counts[i], static_cast<int64_t>(std::min<size_t>(2, allowed.size())));
+		}
+	}
+#endif
+}
@@ -8,6 +8,10 @@
 #include "dynaplex/dynaplex_model_includes.h"
 
 #include "dynaplex/erasure/makegeneric.h"
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace DynaPlex::Tests {
 	namespace AddOn::ProblemWithNonStandardDurations {
@@ -216,4 +220,301 @@ namespace DynaPlex::Tests {
 		auto assessment = evaluator.Assess(policy);
 		//std::cout << assessment.Dump() << std::endl;
 	}
+	TEST(PolicyComparer, SequentialStopping) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto random = mdp->GetPolicy("random");
+
+		VarGroup vars{ {"number_of_trajectories", 8192}, {"periods_per_trajectory", 64}, {"warmup_periods", 16},
+			{"trajectories_per_round", 64}, {"target_relative_error", 0.02} };
+		auto comparer = dp.GetPolicyComparer(mdp, vars);
+		auto assessment = comparer.Assess(base_stock);
+		double mean, error;
+		int64_t used;
+		assessment.Get("mean", mean);
+		assessment.Get("error", error);
+		assessment.Get("number_of_trajectories", used);
+		EXPECT_LT(used, 8192);
+		EXPECT_EQ(used % 64, 0);
+		EXPECT_LE(1.96 * error, 0.02 * std::abs(mean));
+
+		//difference with benchmark:
+		VarGroup vars_abs{ {"number_of_trajectories", 256}, {"periods_per_trajectory", 64}, {"warmup_periods", 16},
+			{"trajectories_per_round", 64}, {"target_half_width", 1e6} };
+		auto results = dp.GetPolicyComparer(mdp, vars_abs).Compare(base_stock, random, 0);
+		for (auto& result : results)
+		{
+			result.Get("number_of_trajectories", used);
+			EXPECT_EQ(used, 64);
+		}
+
+		//without targets, the full budget is used:
+		VarGroup vars_fixed{ {"number_of_trajectories", 100}, {"periods_per_trajectory", 16} };
+		dp.GetPolicyComparer(mdp, vars_fixed).Assess(base_stock).Get("number_of_trajectories", used);
+		EXPECT_EQ(used, 100);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, VarGroup{ {"target_half_width", -1.0} }), DynaPlex::Error);
+	}
+	TEST(PolicyComparer, SharedTrajectories) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto random = mdp->GetPolicy("random");
+
+		VarGroup vars{ {"number_of_trajectories", 200}, {"periods_per_trajectory", 32}, {"warmup_periods", 8} };
+		auto comparer = dp.GetPolicyComparer(mdp, vars);
+
+		//evaluating policies jointly gives the same results as evaluating them one by one:
+		auto joint = comparer.Compare(std::vector<DynaPlex::Policy>{ base_stock, random });
+		ASSERT_EQ(joint.size(), 2);
+		double joint_mean, single_mean, joint_error, single_error;
+		joint[0].Get("mean", joint_mean);
+		comparer.Assess(base_stock).Get("mean", single_mean);
+		EXPECT_DOUBLE_EQ(joint_mean, single_mean);
+		joint[1].Get("mean", joint_mean);
+		joint[1].Get("error", joint_error);
+		auto single = comparer.Assess(random);
+		single.Get("mean", single_mean);
+		single.Get("error", single_error);
+		EXPECT_DOUBLE_EQ(joint_mean, single_mean);
+		EXPECT_DOUBLE_EQ(joint_error, single_error);
+
+		//each experiment is paired over policies, so identical policies have identical returns:
+		auto paired = comparer.Compare(base_stock, mdp->GetPolicy("base_stock"), 0);
+		double mean, error;
+		paired[1].Get("mean", mean);
+		paired[1].Get("error", error);
+		EXPECT_EQ(mean, 0.0);
+		EXPECT_EQ(error, 0.0);
+
+		VarGroup vars_quantiles{ {"number_of_trajectories", 200}, {"periods_per_trajectory", 32}, {"quantiles", std::vector<double>{ 0.1, 0.9 }} };
+		auto assessment = dp.GetPolicyComparer(mdp, vars_quantiles).Assess(base_stock);
+		std::vector<double> quantiles;
+		assessment.Get("quantiles", quantiles);
+		ASSERT_EQ(quantiles.size(), 2);
+		assessment.Get("mean", mean);
+		EXPECT_LT(quantiles[0], mean);
+		EXPECT_GT(quantiles[1], mean);
+	}
+	TEST(PolicyComparer, VarianceReduction) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		ASSERT_TRUE(mdp->ProvidesControlVariate());
+		auto base_stock = mdp->GetPolicy("base_stock");
+
+		VarGroup crude_vars{ {"number_of_trajectories", 1000}, {"periods_per_trajectory", 32}, {"warmup_periods", 8} };
+		double crude_mean, crude_error;
+		auto crude = dp.GetPolicyComparer(mdp, crude_vars).Assess(base_stock);
+		crude.Get("mean", crude_mean);
+		crude.Get("error", crude_error);
+		EXPECT_FALSE(crude.HasKey("variance_reduction"));
+
+		for (auto [antithetic, control_variate] : { std::pair{ true, false }, std::pair{ false, true }, std::pair{ true, true } })
+		{
+			VarGroup vars{ {"number_of_trajectories", 1000}, {"periods_per_trajectory", 32}, {"warmup_periods", 8},
+				{"antithetic", antithetic}, {"control_variate", control_variate} };
+			auto assessment = dp.GetPolicyComparer(mdp, vars).Assess(base_stock);
+			double mean, error, reduction;
+			assessment.Get("mean", mean);
+			assessment.Get("error", error);
+			assessment.Get("variance_reduction", reduction);
+			EXPECT_NEAR(mean, crude_mean, 4.0 * crude_error) << antithetic << control_variate;
+			//costs are V-shaped in demand, so antithetic sampling alone is not expected to help here, and control variates help moderately:
+			if (control_variate)
+			{
+				EXPECT_GT(reduction, 0.0) << antithetic << control_variate;
+				EXPECT_LT(error, crude_error) << antithetic << control_variate;
+			}
+		}
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 101}, {"antithetic", true} }), DynaPlex::Error);
+	}
+	TEST(PolicyComparer, PolicyFamily) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 3},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		std::vector<double> levels{ 0.0, 6.0, 12.0, 16.0, 18.0 };
+		for (double discount_factor : { 1.0, 0.95 })
+		{
+			config.Set("discount_factor", discount_factor);
+			auto mdp = dp.GetMDP(config);
+			auto base_stock = mdp->GetPolicy("base_stock");
+			ASSERT_TRUE(mdp->ProvidesPolicyFamily(base_stock->GetConfig(), "base_stock_level"));
+			EXPECT_FALSE(mdp->ProvidesPolicyFamily(base_stock->GetConfig(), "other"));
+			EXPECT_FALSE(mdp->ProvidesPolicyFamily(mdp->GetPolicy("random")->GetConfig(), "base_stock_level"));
+
+			VarGroup vars{ {"number_of_trajectories", 200}, {"periods_per_trajectory", 32}, {"warmup_periods", 8}, {"antithetic", true} };
+			auto comparer = dp.GetPolicyComparer(mdp, vars);
+			std::vector<DynaPlex::Policy> policies;
+			for (double level : levels)
+				policies.push_back(mdp->GetPolicy(VarGroup{ {"id", "base_stock"}, {"base_stock_level", static_cast<int64_t>(level)} }));
+
+			//lock-step simulation gives exactly the results of simulating the policies separately:
+			auto separate = comparer.Compare(policies, 2);
+			auto family = comparer.CompareFamily(base_stock, "base_stock_level", levels, 2);
+			ASSERT_EQ(family.size(), levels.size());
+			for (size_t i = 0; i < levels.size(); i++)
+			{
+				double family_mean, separate_mean, family_error, separate_error;
+				family[i].Get("mean", family_mean);
+				family[i].Get("error", family_error);
+				separate[i].Get("mean", separate_mean);
+				separate[i].Get("error", separate_error);
+				EXPECT_DOUBLE_EQ(family_mean, separate_mean);
+				EXPECT_DOUBLE_EQ(family_error, separate_error);
+				VarGroup policy_config;
+				family[i].Get("policy", policy_config);
+				int64_t level;
+				policy_config.Get("base_stock_level", level);
+				EXPECT_EQ(level, static_cast<int64_t>(levels[i]));
+			}
+			auto returns = comparer.GetFamilyReturns(base_stock, "base_stock_level", levels, 10, 5);
+			auto separate_returns = comparer.GetReturns(policies, 10, 5);
+			EXPECT_EQ(returns, separate_returns);
+		}
+		auto mdp = dp.GetMDP(config);
+		auto comparer = dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 20}, {"periods_per_trajectory", 16} });
+		EXPECT_THROW(comparer.CompareFamily(mdp->GetPolicy("base_stock"), "base_stock_level", { 4.5 }), DynaPlex::Error);
+		EXPECT_THROW(comparer.CompareFamily(mdp->GetPolicy("base_stock"), "base_stock_level", {}), DynaPlex::Error);
+	}
+	TEST(PolicyComparer, BatchMeans) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto lower = mdp->GetPolicy(VarGroup{ {"id", "base_stock"}, {"base_stock_level", 14} });
+
+		VarGroup independent_vars{ {"number_of_trajectories", 512}, {"periods_per_trajectory", 64}, {"warmup_periods", 32} };
+		VarGroup batch_vars{ {"number_of_trajectories", 512}, {"periods_per_trajectory", 64}, {"warmup_periods", 32},
+			{"batch_means", true}, {"batches_per_run", 32} };
+		auto independent = dp.GetPolicyComparer(mdp, independent_vars).Compare(base_stock, lower);
+		auto batches = dp.GetPolicyComparer(mdp, batch_vars).Compare(base_stock, lower);
+		for (size_t i = 0; i < 2; i++)
+		{
+			double independent_mean, independent_error, batch_mean, batch_error;
+			independent[i].Get("mean", independent_mean);
+			independent[i].Get("error", independent_error);
+			batches[i].Get("mean", batch_mean);
+			batches[i].Get("error", batch_error);
+			EXPECT_NEAR(batch_mean, independent_mean, 4.0 * std::sqrt(independent_error * independent_error + batch_error * batch_error));
+			EXPECT_GT(batch_error, 0.0);
+			int64_t used, runs;
+			batches[i].Get("number_of_trajectories", used);
+			batches[i].Get("number_of_runs", runs);
+			EXPECT_EQ(used, 512);
+			EXPECT_EQ(runs, 16);
+		}
+
+		//runs are reproducible, independent of how experiments are grouped in calls:
+		auto comparer = dp.GetPolicyComparer(mdp, batch_vars);
+		std::vector<DynaPlex::Policy> policies{ base_stock, lower };
+		auto all = comparer.GetReturns(policies, 0, 64);
+		auto second_run = comparer.GetReturns(policies, 32, 32);
+		for (size_t batch = 0; batch < 32; batch++)
+			EXPECT_EQ(all[32 + batch], second_run[batch]);
+		EXPECT_THROW(comparer.GetReturns(policies, 16, 32), DynaPlex::Error);
+
+		auto with_control = dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 256}, {"periods_per_trajectory", 64},
+			{"batch_means", true}, {"batches_per_run", 32}, {"control_variate", true} }).Assess(base_stock);
+		double reduction;
+		with_control.Get("variance_reduction", reduction);
+		EXPECT_GT(reduction, 0.0);
+
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 100}, {"batch_means", true}, {"batches_per_run", 32} }), DynaPlex::Error);
+		EXPECT_THROW(dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 128}, {"batch_means", true}, {"antithetic", true} }), DynaPlex::Error);
+		config.Set("discount_factor", 0.9);
+		EXPECT_THROW(dp.GetPolicyComparer(dp.GetMDP(config), VarGroup{ {"batch_means", true} }), DynaPlex::Error);
+	}
+	TEST(PolicyComparer, DistributedOverRanks) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		std::vector<DynaPlex::Policy> policies{ mdp->GetPolicy("base_stock"), mdp->GetPolicy("random") };
+
+		//ranks are emulated by threads, which exchange returns through a shared allgather:
+		const std::uint32_t world_size = 3;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::vector<std::vector<double>> contributions(world_size);
+		std::vector<double> gathered;
+		std::uint32_t arrived = 0;
+		int64_t generation = 0;
+		auto allgather = [&](std::uint32_t rank, const std::vector<double>& values) {
+			std::unique_lock lock{ mutex };
+			contributions[rank] = values;
+			int64_t my_generation = generation;
+			if (++arrived == world_size)
+			{
+				gathered.clear();
+				for (auto& contribution : contributions)
+					gathered.insert(gathered.end(), contribution.begin(), contribution.end());
+				arrived = 0;
+				generation++;
+				cv.notify_all();
+			}
+			else
+				cv.wait(lock, [&] { return generation != my_generation; });
+			return gathered;
+		};
+
+		for (auto vars : { VarGroup{ {"number_of_trajectories", 200}, {"periods_per_trajectory", 32}, {"warmup_periods", 8}, {"quantiles", std::vector<double>{ 0.5 }} },
+			VarGroup{ {"number_of_trajectories", 256}, {"periods_per_trajectory", 16}, {"batch_means", true}, {"batches_per_run", 16}, {"control_variate", true} },
+			VarGroup{ {"number_of_trajectories", 1000}, {"periods_per_trajectory", 16}, {"target_relative_error", 0.02}, {"trajectories_per_round", 100}, {"antithetic", true} } })
+		{
+			auto single = dp.GetPolicyComparer(mdp, vars).Compare(policies, 0);
+			std::vector<std::vector<VarGroup>> per_rank(world_size);
+			std::vector<std::thread> ranks;
+			for (std::uint32_t rank = 0; rank < world_size; rank++)
+			{
+				ranks.emplace_back([&, rank]() {
+					DynaPlex::System system{ false, rank, world_size, nullptr, [&, rank](const std::vector<double>& values) { return allgather(rank, values); } };
+					system.SetThreading(2, 1);
+					Utilities::PolicyComparer comparer{ system, mdp, vars };
+					per_rank[rank] = comparer.Compare(policies, 0);
+					});
+			}
+			for (auto& rank : ranks)
+				rank.join();
+			//bitwise identical to the single-rank results, on all ranks:
+			for (std::uint32_t rank = 0; rank < world_size; rank++)
+				EXPECT_EQ(per_rank[rank], single);
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/vargroup.h"
+#include "dynaplex/error.h"
+
+namespace DynaPlex::Tests {
+
+	TEST(PolicyOptimizer, BaseStockLevel) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+
+		//base-stock levels above MaxSystemInv are not allowed:
+		VarGroup diagnostics;
+		mdp->GetStaticInfo().Get("diagnostics", diagnostics);
+		int64_t max_level;
+		diagnostics.Get("MaxSystemInv", max_level);
+		VarGroup optimizer_config{
+			{"parameters", VarGroup::VarGroupVec{ VarGroup{ {"name", "base_stock_level"}, {"min", 0}, {"max", max_level} } }},
+			{"number_of_trajectories", 1024}, {"trajectories_per_round", 64}, {"periods_per_trajectory", 64}, {"warmup_periods", 16}
+		};
+		auto result = dp.GetPolicyOptimizer(mdp, optimizer_config).Optimize(base_stock);
+
+		int64_t num_candidates, total_trajectories, best_level;
+		result.Get("number_of_candidates", num_candidates);
+		result.Get("total_trajectories", total_trajectories);
+		VarGroup parameters;
+		result.Get("parameters", parameters);
+		parameters.Get("base_stock_level", best_level);
+		EXPECT_EQ(num_candidates, max_level + 1);
+		//racing spends far less than evaluating all candidates with the full budget:
+		EXPECT_LT(total_trajectories, num_candidates * 1024 / 2);
+
+		//exhaustive comparison with the same simulation settings:
+		std::vector<DynaPlex::Policy> policies;
+		for (int64_t level = 0; level <= max_level; level++)
+			policies.push_back(mdp->GetPolicy(VarGroup{ {"id", "base_stock"}, {"base_stock_level", level} }));
+		auto comparison = dp.GetPolicyComparer(mdp, optimizer_config).Compare(policies);
+		int64_t exhaustive_best = 0;
+		double best_cost = std::numeric_limits<double>::infinity();
+		for (int64_t level = 0; level <= max_level; level++)
+		{
+			double cost;
+			comparison[level].Get("mean", cost);
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				exhaustive_best = level;
+			}
+		}
+		EXPECT_NEAR(best_level, exhaustive_best, 1);
+
+		VarGroup policy_config;
+		result.Get("policy", policy_config);
+		int64_t level_in_config;
+		policy_config.Get("base_stock_level", level_in_config);
+		EXPECT_EQ(level_in_config, best_level);
+	}
+
+	TEST(PolicyOptimizer, MultipleParameters) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+
+		//the second parameter does not affect the policy, so candidates that differ only in that parameter can never be eliminated:
+		VarGroup optimizer_config{
+			{"parameters", VarGroup::VarGroupVec{
+				VarGroup{ {"name", "base_stock_level"}, {"min", 8}, {"max", 16}, {"step", 4} },
+				VarGroup{ {"name", "unused"}, {"min", 0.0}, {"max", 1.0}, {"step", 0.5}, {"integer", false} } }},
+			{"number_of_trajectories", 256}, {"trajectories_per_round", 64}, {"periods_per_trajectory", 32}, {"warmup_periods", 8}
+		};
+		auto result = dp.GetPolicyOptimizer(mdp, optimizer_config).Optimize(mdp->GetPolicy("base_stock"));
+		int64_t num_candidates, survivors;
+		result.Get("number_of_candidates", num_candidates);
+		result.Get("survivors", survivors);
+		EXPECT_EQ(num_candidates, 3 * 3);
+		EXPECT_GE(survivors, 3);
+
+		EXPECT_THROW(dp.GetPolicyOptimizer(mdp, VarGroup{ {"number_of_trajectories", 64} }), DynaPlex::Error);
+		VarGroup too_large{
+			{"parameters", VarGroup::VarGroupVec{ VarGroup{ {"name", "base_stock_level"}, {"min", 0}, {"max", 100000} } }}
+		};
+		EXPECT_THROW(dp.GetPolicyOptimizer(mdp, too_large).Optimize(mdp->GetPolicy("base_stock")), DynaPlex::Error);
+		//racing uses raw returns, so variance reduction is rejected:
+		for (auto key : { "antithetic", "control_variate" })
+		{
+			auto reduced_config = optimizer_config;
+			reduced_config.Set(key, true);
+			EXPECT_THROW(dp.GetPolicyOptimizer(mdp, reduced_config), DynaPlex::Error);
+		}
+	}
+}
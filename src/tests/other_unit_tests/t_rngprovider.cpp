@@ -210,4 +210,34 @@ namespace DynaPlex::Tests {
 	}
 
 
+	TEST(RNGProvider, AntitheticEventStreams) {
+		DynaPlex::RNGProvider provider, mirrored;
+		provider.SeedEventStreams(true, 1234, 5);
+		mirrored.SeedEventStreams(true, 1234, 5);
+		mirrored.SetAntitheticEventStreams(true);
+		for (int64_t stream : {0, 1, 4})
+		{
+			for (int i = 0; i < 100; ++i)
+			{
+				double u = provider.GetEventRNG(stream).genUniform();
+				double v = mirrored.GetEventRNG(stream).genUniform();
+				EXPECT_GE(v, 0.0);
+				EXPECT_LT(v, 1.0);
+				EXPECT_NEAR(u + v, 1.0, 1e-15);
+			}
+		}
+		//policy and initiation streams are not mirrored:
+		EXPECT_EQ(provider.GetInitiationRNG().genUniform(), mirrored.GetInitiationRNG().genUniform());
+		EXPECT_EQ(provider.GetPolicyRNG().genUniform(), mirrored.GetPolicyRNG().genUniform());
+		//monotone sampling is requested for existing and new event streams:
+		mirrored.SetMonotoneEventStreams(true);
+		EXPECT_TRUE(mirrored.GetEventRNG(0).IsMonotone());
+		EXPECT_TRUE(mirrored.GetEventRNG(7).IsMonotone());
+		EXPECT_FALSE(mirrored.GetPolicyRNG().IsMonotone());
+		//re-seeding resets the flags:
+		mirrored.SeedEventStreams(true, 1234, 5);
+		EXPECT_FALSE(mirrored.GetEventRNG(0).IsAntithetic());
+		EXPECT_FALSE(mirrored.GetEventRNG(0).IsMonotone());
+	}
+
 }
\ No newline at end of file
@@ -42,6 +42,9 @@ namespace DynaPlex::Tests {
 		}
 		std::string path = system.filepath("tests", "sampledata_basics", "data.json");
 		data.SaveToFile(mdp, path);
+		//lost_sales provides a binary codec, so states are stored separately:
+		ASSERT_TRUE(mdp->ProvidesStateSerialization());
+		ASSERT_TRUE(system.file_exists("tests", "sampledata_basics", "data.json.states"));
 
 		auto data_from_json = DynaPlex::NN::SampleData::CreateNewFromFile(mdp, path);
 
@@ -68,6 +71,10 @@ namespace DynaPlex::Tests {
 
 		}
 
+		DynaPlex::NN::SampleData::RemoveFiles(path);
+		EXPECT_FALSE(system.file_exists("tests", "sampledata_basics", "data.json"));
+		EXPECT_FALSE(system.file_exists("tests", "sampledata_basics", "data.json.states"));
+
 		//lost_sales starts with action, and alternates between actions and events, never final. Hence, there will be 2*maxevents elements in trace. 
 		ASSERT_EQ(trace.size(), max_periods *2);
 	}
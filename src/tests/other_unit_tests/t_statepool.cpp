@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/statepool.h"
+#include "dynaplex/vargroup.h"
+#include "dynaplex/error.h"
+#include <cmath>
+
+namespace DynaPlex::Tests {
+
+	TEST(StatePool, GenerateSaveLoad) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+		VarGroup pool_config{ {"number_of_states", 100}, {"states_per_run", 8}, {"burn_in_periods", 64}, {"pool_seed", 1234} };
+		Utilities::StatePool pool{ dp.System(), mdp, base_stock, pool_config };
+		Utilities::StatePool same{ dp.System(), mdp, base_stock, pool_config };
+		ASSERT_EQ(pool.Size(), 100);
+		EXPECT_EQ(pool.Key(), Utilities::StatePool::Key(mdp, base_stock->GetConfig()));
+		for (int64_t key = 0; key < 10; key++)
+		{
+			EXPECT_EQ(pool.Draw(key)->ToVarGroup(), same.Draw(key)->ToVarGroup());
+			EXPECT_TRUE(mdp->GetStateCategory(pool.Draw(key)).IsAwaitAction());
+		}
+
+		auto path = dp.System().filepath("tests", "statepool", "state_pool.bin");
+		pool.SaveToFile(path);
+		Utilities::StatePool loaded{ mdp, path };
+		EXPECT_EQ(loaded.Size(), pool.Size());
+		EXPECT_EQ(loaded.Key(), pool.Key());
+		EXPECT_EQ(loaded.Seed(), 1234);
+		for (int64_t key = 0; key < 10; key++)
+			EXPECT_EQ(loaded.Draw(key)->ToVarGroup(), pool.Draw(key)->ToVarGroup());
+
+		config.Set("leadtime", 3);
+		EXPECT_THROW(Utilities::StatePool(dp.GetMDP(config), path), DynaPlex::Error);
+		auto not_a_pool = dp.System().filepath("tests", "statepool", "not_a_pool.json");
+		VarGroup{ {"states", VarGroup::VarGroupVec{}} }.SaveToFile(not_a_pool);
+		EXPECT_THROW(Utilities::StatePool(mdp, not_a_pool), DynaPlex::Error);
+		EXPECT_THROW(Utilities::StatePool(dp.System(), mdp, base_stock, VarGroup{ {"number_of_states", 0} }), DynaPlex::Error);
+	}
+
+	TEST(StatePool, WarmStartedComparison) {
+		auto& dp = DynaPlexProvider::Get();
+		DynaPlex::VarGroup config{
+			{"id", "lost_sales"},
+			{"p", 9.0},
+			{"h", 1.0},
+			{"leadtime", 2},
+			{"demand_dist", DynaPlex::VarGroup({ {"type", "poisson"}, {"mean", 4.0} })}
+		};
+		auto mdp = dp.GetMDP(config);
+		auto base_stock = mdp->GetPolicy("base_stock");
+		auto path = dp.GetStatePoolPath(mdp, base_stock, VarGroup{ {"number_of_states", 256} });
+		auto pool = dp.GetStatePool(mdp, base_stock, VarGroup{ {"number_of_states", 256} });
+		EXPECT_EQ(pool->Size(), 256);
+
+		VarGroup cold_vars{ {"number_of_trajectories", 512}, {"periods_per_trajectory", 32}, {"warmup_periods", 128} };
+		VarGroup warm_vars{ {"number_of_trajectories", 512}, {"periods_per_trajectory", 32}, {"initial_state_pool", path} };
+		double cold_mean, cold_error, warm_mean, warm_error;
+		auto cold = dp.GetPolicyComparer(mdp, cold_vars).Assess(base_stock);
+		cold.Get("mean", cold_mean);
+		cold.Get("error", cold_error);
+		auto warm = dp.GetPolicyComparer(mdp, warm_vars).Assess(base_stock);
+		warm.Get("mean", warm_mean);
+		warm.Get("error", warm_error);
+		EXPECT_NEAR(warm_mean, cold_mean, 4.0 * std::sqrt(cold_error * cold_error + warm_error * warm_error));
+
+		//the pool may also be set directly, with the same results:
+		auto comparer = dp.GetPolicyComparer(mdp, VarGroup{ {"number_of_trajectories", 512}, {"periods_per_trajectory", 32}, {"warmup_periods", 0} });
+		comparer.SetInitialStatePool(pool);
+		double direct_mean;
+		comparer.Assess(base_stock).Get("mean", direct_mean);
+		EXPECT_DOUBLE_EQ(direct_mean, warm_mean);
+	}
+}
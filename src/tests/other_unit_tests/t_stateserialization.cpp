@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "include/smallclass.h"
+#include "dynaplex/dynaplexprovider.h"
+#include "dynaplex/bytestream.h"
+#include "dynaplex/modelling/queue.h"
+#include "dynaplex/modelling/idcontainer.h"
+#include "dynaplex/error.h"
+
+namespace DynaPlex::Tests {
+
+	TEST(ByteStream, RoundTrip) {
+		DynaPlex::Queue<int64_t> queue{};
+		for (int64_t i = 0; i < 6; i++)
+			queue.push_back(i * i);
+		queue.pop_front();
+		DynaPlex::IdContainer<SmallClass> container;
+		for (double size : {1.5, 2.5, 3.5})
+		{
+			auto& [id, item] = container.AddNew();
+			item.name = "item";
+			item.Size = size;
+		}
+		container.Delete(2);
+		std::vector<std::string> names{ "a", "", "bcd" };
+		DynaPlex::VarGroup vars{ {"p", 2}, {"list", DynaPlex::VarGroup::DoubleVec{1.0, 2.0}} };
+
+		std::vector<uint8_t> bytes;
+		DynaPlex::ByteSink sink{ bytes };
+		sink.Write(int64_t{ -7 }, 0.25, true, std::string{ "text" }, std::vector<int64_t>{ 3, 4, 5 }, names,
+			StateCategory::AwaitEvent(3), queue, container, vars);
+
+		DynaPlex::ByteSource source{ bytes };
+		EXPECT_EQ(source.Read<int64_t>(), -7);
+		EXPECT_EQ(source.Read<double>(), 0.25);
+		EXPECT_TRUE(source.Read<bool>());
+		EXPECT_EQ(source.Read<std::string>(), "text");
+		EXPECT_EQ(source.Read<std::vector<int64_t>>(), (std::vector<int64_t>{ 3, 4, 5 }));
+		EXPECT_EQ(source.Read<std::vector<std::string>>(), names);
+		EXPECT_EQ(source.Read<StateCategory>(), StateCategory::AwaitEvent(3));
+		EXPECT_EQ(source.Read<DynaPlex::Queue<int64_t>>(), queue);
+		auto loaded = source.Read<DynaPlex::IdContainer<SmallClass>>();
+		EXPECT_EQ(loaded.size(), 2);
+		EXPECT_FALSE(loaded.HasId(2));
+		EXPECT_EQ(loaded[3].Size, 3.5);
+		EXPECT_EQ(loaded[1].name, "item");
+		EXPECT_EQ(source.Read<DynaPlex::VarGroup>(), vars);
+		EXPECT_TRUE(source.AtEnd());
+
+		//truncated data is detected:
+		bytes.resize(bytes.size() - 1);
+		DynaPlex::ByteSource truncated{ bytes };
+		truncated.Read<int64_t>();
+		EXPECT_THROW(
+			for (int i = 0; i < 9; i++)
+				truncated.Read<DynaPlex::VarGroup>();
+			, DynaPlex::Error);
+	}
+
+	TEST(StateSerialization, LostSales) {
+		auto& dp = DynaPlexProvider::Get();
+		auto& system = dp.System();
+		auto mdp = dp.GetMDP(VarGroup::LoadFromFile(system.filepath("mdp_config_examples", "lost_sales", "mdp_config_0.json")));
+		ASSERT_TRUE(mdp->ProvidesStateSerialization());
+
+		auto trace = dp.GetDemonstrator(VarGroup{ {"max_period_count", 20} }).GetObjectTrace(mdp, mdp->GetPolicy("base_stock"));
+		std::vector<DynaPlex::dp_State> states;
+		for (auto& elem : trace)
+			states.push_back(elem.state->Clone());
+
+		auto bytes = mdp->SerializeStates(states);
+		auto loaded = mdp->DeserializeStates(bytes);
+		ASSERT_EQ(loaded.size(), states.size());
+		size_t json_size = 0;
+		for (size_t i = 0; i < states.size(); i++)
+		{
+			EXPECT_TRUE(mdp->StatesAreEqual(states[i], loaded[i]));
+			EXPECT_EQ(mdp->GetStateCategory(loaded[i]), mdp->GetStateCategory(states[i]));
+			json_size += states[i]->ToVarGroup().Dump().size();
+		}
+		EXPECT_LT(bytes.size(), json_size);
+
+		//states of other mdps, and data written by another codec, are rejected:
+		auto bin_packing = dp.GetMDP(VarGroup::LoadFromFile(system.filepath("mdp_config_examples", "bin_packing", "mdp_config_0.json")));
+		EXPECT_THROW(bin_packing->SerializeStates(states), DynaPlex::Error);
+		EXPECT_THROW(bin_packing->DeserializeStates(bytes), DynaPlex::Error);
+		bytes.pop_back();
+		EXPECT_THROW(mdp->DeserializeStates(bytes), DynaPlex::Error);
+	}
+
+	TEST(StateSerialization, VarGroupFallback) {
+		auto& dp = DynaPlexProvider::Get();
+		auto& system = dp.System();
+		auto mdp = dp.GetMDP(VarGroup::LoadFromFile(system.filepath("mdp_config_examples", "bin_packing", "mdp_config_0.json")));
+		ASSERT_FALSE(mdp->ProvidesStateSerialization());
+		ASSERT_TRUE(mdp->SupportsGetStateFromVarGroup());
+
+		auto trace = dp.GetDemonstrator(VarGroup{ {"max_period_count", 10} }).GetObjectTrace(mdp);
+		std::vector<DynaPlex::dp_State> states;
+		for (auto& elem : trace)
+			states.push_back(elem.state->Clone());
+		auto loaded = mdp->DeserializeStates(mdp->SerializeStates(states));
+		ASSERT_EQ(loaded.size(), states.size());
+		for (size_t i = 0; i < states.size(); i++)
+			EXPECT_EQ(loaded[i]->ToVarGroup(), states[i]->ToVarGroup());
+	}
+}